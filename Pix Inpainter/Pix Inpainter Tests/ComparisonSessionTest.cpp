@@ -0,0 +1,124 @@
+#include "ComparisonSessionTest.h"
+#include "ComparisonSession.h"
+
+#include <QTest>
+
+namespace paint
+{
+    namespace
+    {
+        QByteArray resultFrame(const QString& modelKey, int postprocessValue, const QByteArray& payload)
+        {
+            return FrameParser::encode({ { "model_id", modelKey }, { "postprocess_value", postprocessValue }, { "ok", true } }, payload);
+        }
+    }
+
+    void ComparisonSessionTest::buildsBatchQuery()
+    {
+        ComparisonSession session;
+        session.restart();
+        session.add("unet", 2, "digest");
+        session.add("gan", -1, "digest");
+
+        QCOMPARE(session.outstandingCount(), 2);
+        QCOMPARE(session.modelKeys(), QStringList({ "unet", "gan" }));
+        QCOMPARE(session.query().allQueryItemValues("model"), QStringList({ "unet:2", "gan:0" }));
+    }
+
+    void ComparisonSessionTest::matchesFramesInAnyOrder()
+    {
+        ComparisonSession session;
+        session.restart();
+        session.add("unet", 2, "first");
+        session.add("gan", -1, "second");
+
+        const QByteArray stream = resultFrame("gan", 0, "gan pixels") + resultFrame("unet", 2, "unet pixels");
+        session.append(stream.left(5));
+
+        ComparisonSession::Frame frame;
+        QVERIFY(!session.next(frame));
+
+        session.append(stream.mid(5));
+        QVERIFY(session.next(frame));
+        QVERIFY(frame.ok);
+        QCOMPARE(frame.request.modelKey, QString("gan"));
+        QCOMPARE(frame.request.postprocessValue, -1);
+        QCOMPARE(frame.request.imageDigest, QByteArray("second"));
+        QCOMPARE(frame.payload, QByteArray("gan pixels"));
+
+        QVERIFY(session.next(frame));
+        QCOMPARE(frame.request.modelKey, QString("unet"));
+        QCOMPARE(frame.payload, QByteArray("unet pixels"));
+
+        QVERIFY(!session.next(frame));
+        QVERIFY(!session.hasOutstanding());
+    }
+
+    void ComparisonSessionTest::skipsFramesForOtherRequests()
+    {
+        ComparisonSession session;
+        session.restart();
+        session.add("unet", 2, "digest");
+
+        session.append(resultFrame("gan", 2, "other model") + resultFrame("unet", 3, "other iteration"));
+
+        ComparisonSession::Frame frame;
+        QVERIFY(!session.next(frame));
+        QCOMPARE(session.outstandingCount(), 1);
+    }
+
+    void ComparisonSessionTest::reportsServerErrors()
+    {
+        ComparisonSession session;
+        session.restart();
+        session.add("unet", 0, "digest");
+
+        session.append(FrameParser::encode({ { "model_id", "unet" }, { "postprocess_value", 0 }, { "ok", false }, { "error", "out of memory" } }));
+
+        ComparisonSession::Frame frame;
+        QVERIFY(session.next(frame));
+        QVERIFY(!frame.ok);
+        QCOMPARE(frame.error, QString("out of memory"));
+        QVERIFY(frame.payload.isEmpty());
+    }
+
+    void ComparisonSessionTest::takeOutstandingEndsTheStream()
+    {
+        ComparisonSession session;
+        session.restart();
+        session.add("unet", 1, "digest");
+        session.add("gan", 1, "digest");
+
+        const QByteArray frame = resultFrame("unet", 1, "pixels");
+        session.append(frame.left(frame.size() - 1));
+
+        const QList<ComparisonSession::Request> outstanding = session.takeOutstanding();
+        QCOMPARE(outstanding.size(), qsizetype(2));
+        QVERIFY(!session.hasOutstanding());
+
+        session.append(frame.right(1));
+        ComparisonSession::Frame parsed;
+        QVERIFY(!session.next(parsed));
+    }
+
+    void ComparisonSessionTest::restartStartsANewGeneration()
+    {
+        ComparisonSession session;
+        const quint64 first = session.restart();
+        session.add("unet", 1, "digest");
+        session.beginDecode();
+        session.append(resultFrame("unet", 1, "stale").left(6));
+
+        const quint64 second = session.restart();
+        QVERIFY(second != first);
+        QCOMPARE(session.generation(), second);
+        QCOMPARE(session.pendingDecodes(), 0);
+        QVERIFY(!session.hasOutstanding());
+
+        session.add("unet", 1, "digest");
+        session.append(resultFrame("unet", 1, "fresh"));
+        ComparisonSession::Frame frame;
+        QVERIFY(session.next(frame));
+        QCOMPARE(frame.payload, QByteArray("fresh"));
+    }
+}
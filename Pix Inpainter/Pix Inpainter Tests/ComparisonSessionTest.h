@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QObject>
+
+namespace paint
+{
+    class ComparisonSessionTest : public QObject
+    {
+        Q_OBJECT
+
+    private slots:
+        void buildsBatchQuery();
+        void matchesFramesInAnyOrder();
+        void skipsFramesForOtherRequests();
+        void reportsServerErrors();
+        void takeOutstandingEndsTheStream();
+        void restartStartsANewGeneration();
+    };
+}
@@ -0,0 +1,133 @@
+#include "ContentHashTest.h"
+#include "ContentHash.h"
+#include "CanvasModel.h"
+#include "CanvasImage.h"
+#include "CanvasPoint.h"
+#include "TiledCanvasImage.h"
+#include "TestImages.h"
+
+#include <QTest>
+
+#include <memory>
+#include <vector>
+
+namespace paint
+{
+    namespace
+    {
+        constexpr int CANVAS_SIZE = 3 * TiledCanvasImage::TILE_SIZE - 20;
+
+        void paste(CanvasModel& model, const QImage& image, const QPoint& topLeft)
+        {
+            model.drawImage(CanvasImage::create(image), CanvasPoint::create(topLeft));
+        }
+
+        std::shared_ptr<const TiledCanvasImage> tiles(const CanvasModel& model)
+        {
+            return std::dynamic_pointer_cast<const TiledCanvasImage>(model.image());
+        }
+    }
+
+    void ContentHashTest::hashesRowsByContent()
+    {
+        std::vector<QRgb> row(13);
+        for (size_t i = 0; i < row.size(); ++i)
+            row[i] = qRgb(static_cast<int>(i) * 7, 40, 200);
+        const std::vector<QRgb> copy = row;
+
+        const quint64 hash = ContentHash::hashRow(row.data(), static_cast<int>(row.size()));
+        QCOMPARE(ContentHash::hashRow(copy.data(), static_cast<int>(copy.size())), hash);
+        QVERIFY(ContentHash::hashRow(row.data(), static_cast<int>(row.size()) - 1) != hash);
+
+        // Cover the striped body, the trailing word and the odd last pixel.
+        for (size_t index : { size_t(0), size_t(7), size_t(9), size_t(12) })
+        {
+            std::vector<QRgb> changed = row;
+            changed[index] ^= 1;
+            QVERIFY(ContentHash::hashRow(changed.data(), static_cast<int>(changed.size())) != hash);
+        }
+    }
+
+    void ContentHashTest::combinesInOrder()
+    {
+        const quint64 forward = ContentHash::combine(ContentHash::combine(ContentHash::SEED, 1), 2);
+        const quint64 backward = ContentHash::combine(ContentHash::combine(ContentHash::SEED, 2), 1);
+
+        QCOMPARE(ContentHash::combine(ContentHash::combine(ContentHash::SEED, 1), 2), forward);
+        QVERIFY(forward != backward);
+    }
+
+    void ContentHashTest::leavesUntouchedTilesAlone()
+    {
+        CanvasModel model(CANVAS_SIZE, CANVAS_SIZE);
+        const std::shared_ptr<const TiledCanvasImage> image = tiles(model);
+        QVERIFY(image);
+        QCOMPARE(image->columns(), 3);
+        QCOMPARE(image->rows(), 3);
+
+        std::vector<quint64> versions;
+        std::vector<quint64> hashes;
+        for (int row = 0; row < image->rows(); ++row)
+        {
+            for (int column = 0; column < image->columns(); ++column)
+            {
+                versions.push_back(image->tileVersion(column, row));
+                hashes.push_back(model.tileHash(column, row));
+            }
+        }
+
+        paste(model, TestImages::pattern(QSize(10, 10)), QPoint(TiledCanvasImage::TILE_SIZE + 5, 5));
+
+        for (int row = 0; row < image->rows(); ++row)
+        {
+            for (int column = 0; column < image->columns(); ++column)
+            {
+                const size_t index = static_cast<size_t>(row) * image->columns() + column;
+                if (column == 1 && row == 0)
+                {
+                    QVERIFY(image->tileVersion(column, row) != versions[index]);
+                    QVERIFY(model.tileHash(column, row) != hashes[index]);
+                    continue;
+                }
+                QCOMPARE(image->tileVersion(column, row), versions[index]);
+                QCOMPARE(model.tileHash(column, row), hashes[index]);
+            }
+        }
+    }
+
+    void ContentHashTest::keepsHashWhenContentIsUnchanged()
+    {
+        CanvasModel model(CANVAS_SIZE, CANVAS_SIZE);
+        const quint64 blank = model.contentHash();
+        QCOMPARE(model.contentHash(), blank);
+        QCOMPARE(CanvasModel(CANVAS_SIZE, CANVAS_SIZE).contentHash(), blank);
+
+        const quint64 version = tiles(model)->tileVersion(0, 0);
+        paste(model, TestImages::filled(QSize(16, 16), Qt::white), QPoint(4, 4));
+        QVERIFY(tiles(model)->tileVersion(0, 0) != version);
+        QCOMPARE(model.contentHash(), blank);
+
+        paste(model, TestImages::pattern(QSize(16, 16)), QPoint(4, 4));
+        QVERIFY(model.contentHash() != blank);
+        paste(model, TestImages::filled(QSize(16, 16), Qt::white), QPoint(4, 4));
+        QCOMPARE(model.contentHash(), blank);
+    }
+
+    void ContentHashTest::tracksContentChanges()
+    {
+        CanvasModel model(CANVAS_SIZE, CANVAS_SIZE);
+        const quint64 blank = model.contentHash();
+        QVERIFY(CanvasModel(CANVAS_SIZE, CANVAS_SIZE - 1).contentHash() != blank);
+
+        model.saveState();
+        paste(model, TestImages::filled(QSize(1, 1), Qt::black), QPoint(CANVAS_SIZE - 1, CANVAS_SIZE - 1));
+        const quint64 edited = model.contentHash();
+        QVERIFY(edited != blank);
+        QCOMPARE(model.contentHash(), edited);
+
+        model.undo();
+        QCOMPARE(model.contentHash(), blank);
+        model.redo();
+        QCOMPARE(model.contentHash(), edited);
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <QObject>
+
+namespace paint
+{
+    class ContentHashTest : public QObject
+    {
+        Q_OBJECT
+
+    private slots:
+        void hashesRowsByContent();
+        void combinesInOrder();
+        void leavesUntouchedTilesAlone();
+        void keepsHashWhenContentIsUnchanged();
+        void tracksContentChanges();
+    };
+}
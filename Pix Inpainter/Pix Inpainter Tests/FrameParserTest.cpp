@@ -0,0 +1,116 @@
+#include "FrameParserTest.h"
+#include "FrameParser.h"
+
+#include <QJsonDocument>
+#include <QTest>
+#include <QtEndian>
+
+namespace paint
+{
+    namespace
+    {
+        // Mirrors comparison_frame() in ServerPy/run.py.
+        QByteArray serverFrame(const QByteArray& headerJson, const QByteArray& payload)
+        {
+            char length[sizeof(quint32)];
+            QByteArray frame;
+            qToBigEndian<quint32>(static_cast<quint32>(headerJson.size()), length);
+            frame.append(length, sizeof(length));
+            frame.append(headerJson);
+            qToBigEndian<quint32>(static_cast<quint32>(payload.size()), length);
+            frame.append(length, sizeof(length));
+            frame.append(payload);
+            return frame;
+        }
+    }
+
+    void FrameParserTest::readsServerFrameLayout()
+    {
+        FrameParser parser;
+        parser.append(serverFrame(R"({"model_id": "unet", "postprocess_value": 2, "ok": true})", "pixels"));
+
+        QJsonObject header;
+        QByteArray payload;
+        QVERIFY(parser.next(header, payload));
+        QCOMPARE(header.value("model_id").toString(), QString("unet"));
+        QCOMPARE(header.value("postprocess_value").toInt(), 2);
+        QVERIFY(header.value("ok").toBool());
+        QCOMPARE(payload, QByteArray("pixels"));
+        QCOMPARE(parser.bufferedSize(), qsizetype(0));
+        QVERIFY(!parser.next(header, payload));
+    }
+
+    void FrameParserTest::waitsForCompleteFrames()
+    {
+        const QByteArray frame = FrameParser::encode({ { "model_id", "unet" } }, QByteArray(64, 'x'));
+
+        FrameParser parser;
+        QJsonObject header;
+        QByteArray payload;
+
+        parser.append(frame.left(2));
+        QVERIFY(!parser.next(header, payload));
+        parser.append(frame.mid(2, frame.size() - 3));
+        QVERIFY(!parser.next(header, payload));
+        QCOMPARE(parser.bufferedSize(), frame.size() - 1);
+
+        parser.append(frame.right(1));
+        QVERIFY(parser.next(header, payload));
+        QCOMPARE(payload, QByteArray(64, 'x'));
+    }
+
+    void FrameParserTest::readsFramesSplitAcrossChunks()
+    {
+        const QByteArray stream = FrameParser::encode({ { "postprocess_value", 1 } }, "first")
+            + FrameParser::encode({ { "postprocess_value", 2 } }, "second")
+            + FrameParser::encode({ { "postprocess_value", 3 } }, "third");
+
+        FrameParser parser;
+        QList<int> iterations;
+        QList<QByteArray> payloads;
+        for (qsizetype offset = 0; offset < stream.size(); offset += 3)
+        {
+            parser.append(stream.mid(offset, 3));
+
+            QJsonObject header;
+            QByteArray payload;
+            while (parser.next(header, payload))
+            {
+                iterations.append(header.value("postprocess_value").toInt());
+                payloads.append(payload);
+            }
+        }
+
+        QCOMPARE(iterations, QList<int>({ 1, 2, 3 }));
+        QCOMPARE(payloads, QList<QByteArray>({ "first", "second", "third" }));
+        QCOMPARE(parser.bufferedSize(), qsizetype(0));
+    }
+
+    void FrameParserTest::readsEmptyPayloads()
+    {
+        FrameParser parser;
+        parser.append(FrameParser::encode({ { "ok", false }, { "error", "missing model" } }));
+
+        QJsonObject header;
+        QByteArray payload("stale");
+        QVERIFY(parser.next(header, payload));
+        QVERIFY(!header.value("ok").toBool());
+        QCOMPARE(header.value("error").toString(), QString("missing model"));
+        QVERIFY(payload.isEmpty());
+    }
+
+    void FrameParserTest::clearDropsPartialFrames()
+    {
+        const QByteArray frame = FrameParser::encode({ { "model_id", "unet" } }, "payload");
+
+        FrameParser parser;
+        parser.append(frame.left(frame.size() / 2));
+        parser.clear();
+        parser.append(frame);
+
+        QJsonObject header;
+        QByteArray payload;
+        QVERIFY(parser.next(header, payload));
+        QCOMPARE(payload, QByteArray("payload"));
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <QObject>
+
+namespace paint
+{
+    class FrameParserTest : public QObject
+    {
+        Q_OBJECT
+
+    private slots:
+        void readsServerFrameLayout();
+        void waitsForCompleteFrames();
+        void readsFramesSplitAcrossChunks();
+        void readsEmptyPayloads();
+        void clearDropsPartialFrames();
+    };
+}
@@ -0,0 +1,82 @@
+#include "GrayPayloadTest.h"
+#include "GrayPayload.h"
+
+#include <QTest>
+#include <QtEndian>
+
+#include <cstring>
+
+namespace paint
+{
+    namespace
+    {
+        QImage gradient(int width, int height)
+        {
+            QImage image(width, height, QImage::Format_Grayscale8);
+            for (int y = 0; y < height; ++y)
+            {
+                uchar* line = image.scanLine(y);
+                for (int x = 0; x < width; ++x)
+                    line[x] = static_cast<uchar>((x * 7 + y * 13) % 256);
+            }
+            return image;
+        }
+    }
+
+    void GrayPayloadTest::writesHeader()
+    {
+        const QByteArray data = GrayPayload::encode(gradient(5, 3), QSize(5, 3));
+
+        QCOMPARE(data.size(), qsizetype(GrayPayload::HEADER_SIZE + 5 * 3));
+        QCOMPARE(data.left(GrayPayload::MAGIC_SIZE), QByteArray(GrayPayload::MAGIC));
+        QCOMPARE(qFromBigEndian<quint16>(data.constData() + GrayPayload::MAGIC_SIZE), quint16(5));
+        QCOMPARE(qFromBigEndian<quint16>(data.constData() + GrayPayload::MAGIC_SIZE + sizeof(quint16)), quint16(3));
+        QVERIFY(GrayPayload::isPayload(data));
+        QCOMPARE(GrayPayload::size(data), QSize(5, 3));
+    }
+
+    void GrayPayloadTest::roundTripsGrayLevels()
+    {
+        const QImage source = gradient(37, 19);
+        const QImage decoded = GrayPayload::decode(GrayPayload::encode(source, source.size()));
+
+        QCOMPARE(decoded.size(), source.size());
+        QCOMPARE(decoded.format(), QImage::Format_Grayscale8);
+        for (int y = 0; y < source.height(); ++y)
+            QVERIFY(std::memcmp(decoded.constScanLine(y), source.constScanLine(y), source.width()) == 0);
+    }
+
+    void GrayPayloadTest::scalesToRequestedSize()
+    {
+        QImage color(64, 48, QImage::Format_ARGB32_Premultiplied);
+        color.fill(QColor(200, 200, 200));
+
+        const QByteArray data = GrayPayload::encode(color, QSize(16, 12));
+        QCOMPARE(GrayPayload::size(data), QSize(16, 12));
+
+        const QImage decoded = GrayPayload::decode(data);
+        QCOMPARE(decoded.size(), QSize(16, 12));
+        QCOMPARE(qGray(decoded.pixel(8, 6)), 200);
+    }
+
+    void GrayPayloadTest::rejectsInvalidInput()
+    {
+        QVERIFY(GrayPayload::encode(QImage(), QSize(4, 4)).isEmpty());
+        QVERIFY(GrayPayload::encode(gradient(4, 4), QSize()).isEmpty());
+        QVERIFY(GrayPayload::encode(gradient(4, 4), QSize(0x10000, 4)).isEmpty());
+
+        const QByteArray png("\x89PNG\r\n\x1a\n\0\0\0\rIHDR", 16);
+        QVERIFY(!GrayPayload::isPayload(png));
+        QVERIFY(GrayPayload::decode(png).isNull());
+        QVERIFY(!GrayPayload::size(png).isValid());
+    }
+
+    void GrayPayloadTest::rejectsTruncatedPayloads()
+    {
+        const QByteArray data = GrayPayload::encode(gradient(8, 8), QSize(8, 8));
+
+        QVERIFY(GrayPayload::decode(data.left(data.size() - 1)).isNull());
+        QVERIFY(!GrayPayload::isPayload(data.left(GrayPayload::HEADER_SIZE - 1)));
+        QVERIFY(GrayPayload::decode(data.left(GrayPayload::HEADER_SIZE)).isNull());
+    }
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <QObject>
+
+namespace paint
+{
+    class GrayPayloadTest : public QObject
+    {
+        Q_OBJECT
+
+    private slots:
+        void writesHeader();
+        void roundTripsGrayLevels();
+        void scalesToRequestedSize();
+        void rejectsInvalidInput();
+        void rejectsTruncatedPayloads();
+    };
+}
@@ -0,0 +1,161 @@
+#include "InferenceCacheTest.h"
+#include "InferenceCache.h"
+#include "TestImages.h"
+
+#include <QTemporaryDir>
+#include <QTest>
+#include <QThread>
+
+#include <optional>
+
+namespace paint
+{
+    void InferenceCacheTest::findsInsertedResult()
+    {
+        InferenceCache cache;
+        const QByteArray digest = QByteArrayLiteral("image");
+
+        QVERIFY(!cache.find(digest, "model", 1));
+        QCOMPARE(cache.misses(), 1);
+
+        const QPixmap pixmap = TestImages::solidPixmap(Qt::red);
+        cache.insert(digest, "model", 1, pixmap, QByteArrayLiteral("bytes"));
+
+        const std::optional<InferenceCache::Result> found = cache.find(digest, "model", 1);
+        QVERIFY(found);
+        QCOMPARE(found->pixmap.cacheKey(), pixmap.cacheKey());
+        QCOMPARE(found->encodedData, QByteArrayLiteral("bytes"));
+        QCOMPARE(cache.hits(), 1);
+    }
+
+    void InferenceCacheTest::separatesModelsAndPostprocessValues()
+    {
+        InferenceCache cache;
+        const QByteArray digest = QByteArrayLiteral("image");
+        cache.insert(digest, "model", 1, TestImages::solidPixmap(Qt::red), QByteArray());
+        cache.insert(digest, "other", -3, TestImages::solidPixmap(Qt::blue), QByteArray());
+
+        QVERIFY(!cache.find(digest, "model", 2));
+        QVERIFY(!cache.find(digest, "other", 1));
+        QVERIFY(!cache.find(QByteArrayLiteral("changed"), "model", 1));
+        QVERIFY(cache.find(digest, "other", 0));
+    }
+
+    void InferenceCacheTest::evictsLeastRecentlyUsed()
+    {
+        const QPixmap first = TestImages::solidPixmap(Qt::red);
+        const qint64 cost = static_cast<qint64>(first.width()) * first.height() * std::max(first.depth(), 8) / 8;
+        InferenceCache cache(2 * cost);
+
+        cache.insert("first", "model", 0, first, QByteArray());
+        cache.insert("second", "model", 0, TestImages::solidPixmap(Qt::green), QByteArray());
+        QVERIFY(cache.find("first", "model", 0));
+
+        cache.insert("third", "model", 0, TestImages::solidPixmap(Qt::blue), QByteArray());
+        QCOMPARE(cache.memoryUsage(), 2 * cost);
+        QVERIFY(cache.find("first", "model", 0));
+        QVERIFY(cache.find("third", "model", 0));
+        QVERIFY(!cache.find("second", "model", 0));
+    }
+
+    void InferenceCacheTest::reloadsResultsFromDisk()
+    {
+        QTemporaryDir directory;
+        QVERIFY(directory.isValid());
+
+        const QPixmap pixmap = TestImages::solidPixmap(Qt::red);
+        const QByteArray data = TestImages::png(pixmap.toImage());
+        {
+            InferenceCache cache(InferenceCache::DEFAULT_MEMORY_BUDGET, directory.path());
+            cache.insert("image", "model", 2, pixmap, data);
+        }
+
+        QObject context;
+        InferenceCache reopened(InferenceCache::DEFAULT_MEMORY_BUDGET, directory.path());
+        std::optional<InferenceCache::Result> found;
+        reopened.lookup("image", "model", 2, &context, nullptr, [&found](const std::optional<InferenceCache::Result>& result) { found = result; });
+        QVERIFY(found);
+        QCOMPARE(found->encodedData, data);
+        QCOMPARE(found->pixmap.size(), pixmap.size());
+        QCOMPARE(found->pixmap.toImage().pixelColor(0, 0), QColor(Qt::red));
+        QCOMPARE(reopened.hits(), 1);
+        QVERIFY(reopened.find("image", "model", 2));
+
+        reopened.clear();
+        bool missed = false;
+        reopened.lookup("image", "model", 2, &context, nullptr, [&missed](const std::optional<InferenceCache::Result>& result) { missed = !result; });
+        QVERIFY(missed);
+        QCOMPARE(reopened.misses(), 1);
+    }
+
+    void InferenceCacheTest::findSkipsTheDiskTier()
+    {
+        QTemporaryDir directory;
+        QVERIFY(directory.isValid());
+
+        const QPixmap pixmap = TestImages::solidPixmap(Qt::red);
+        {
+            InferenceCache cache(InferenceCache::DEFAULT_MEMORY_BUDGET, directory.path());
+            cache.insert("image", "model", 0, pixmap, TestImages::png(pixmap.toImage()));
+        }
+
+        InferenceCache reopened(InferenceCache::DEFAULT_MEMORY_BUDGET, directory.path());
+        QVERIFY(!reopened.find("image", "model", 0));
+        QCOMPARE(reopened.misses(), 1);
+    }
+
+    void InferenceCacheTest::decodesDiskHitsOnThePool()
+    {
+        QTemporaryDir directory;
+        QVERIFY(directory.isValid());
+
+        const QPixmap pixmap = TestImages::solidPixmap(Qt::blue);
+        {
+            InferenceCache cache(InferenceCache::DEFAULT_MEMORY_BUDGET, directory.path());
+            cache.insert("image", "model", 1, pixmap, TestImages::png(pixmap.toImage()));
+        }
+
+        QObject context;
+        InferenceCache reopened(InferenceCache::DEFAULT_MEMORY_BUDGET, directory.path(), WorkStealingPool::create(1));
+        const Qt::HANDLE guiThread = QThread::currentThreadId();
+        Qt::HANDLE decodeThread = nullptr;
+        auto decode = [&decodeThread](const QByteArray& data) {
+            decodeThread = QThread::currentThreadId();
+            return QImage::fromData(data, "PNG");
+        };
+
+        std::optional<InferenceCache::Result> found;
+        Qt::HANDLE doneThread = nullptr;
+        bool finished = false;
+        reopened.lookup("image", "model", 1, &context, decode, [&](const std::optional<InferenceCache::Result>& result) {
+            doneThread = QThread::currentThreadId();
+            found = result;
+            finished = true;
+        });
+
+        QVERIFY(!finished);
+        QTRY_VERIFY(finished);
+        QVERIFY(found);
+        QVERIFY(decodeThread != guiThread);
+        QCOMPARE(doneThread, guiThread);
+        QCOMPARE(found->pixmap.toImage().pixelColor(0, 0), QColor(Qt::blue));
+
+        bool memoryHit = false;
+        reopened.lookup("image", "model", 1, &context, decode, [&memoryHit](const std::optional<InferenceCache::Result>& result) { memoryHit = result.has_value(); });
+        QVERIFY(memoryHit);
+        QCOMPARE(reopened.hits(), 2);
+    }
+
+    void InferenceCacheTest::digestFollowsPixelContent()
+    {
+        QImage image(16, 8, QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::white);
+
+        const QByteArray digest = InferenceCache::digest(image);
+        QCOMPARE(InferenceCache::digest(image.convertToFormat(QImage::Format_RGB32)), digest);
+
+        image.setPixelColor(3, 4, Qt::black);
+        QVERIFY(InferenceCache::digest(image) != digest);
+        QVERIFY(InferenceCache::digest(QImage()).isEmpty());
+    }
+}
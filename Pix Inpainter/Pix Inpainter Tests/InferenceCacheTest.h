@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QObject>
+
+namespace paint
+{
+    class InferenceCacheTest : public QObject
+    {
+        Q_OBJECT
+
+    private slots:
+        void findsInsertedResult();
+        void separatesModelsAndPostprocessValues();
+        void evictsLeastRecentlyUsed();
+        void reloadsResultsFromDisk();
+        void findSkipsTheDiskTier();
+        void decodesDiskHitsOnThePool();
+        void digestFollowsPixelContent();
+    };
+}
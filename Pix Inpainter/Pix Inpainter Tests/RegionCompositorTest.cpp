@@ -0,0 +1,133 @@
+#include "RegionCompositorTest.h"
+#include "RegionCompositor.h"
+#include "TestImages.h"
+
+#include <QRegion>
+#include <QTest>
+
+namespace paint
+{
+    void RegionCompositorTest::clampsContextToBounds()
+    {
+        const QRect bounds(0, 0, 100, 100);
+
+        QCOMPARE(RegionCompositor::contextRect(QRect(40, 40, 20, 20), bounds, 8), QRect(32, 32, 36, 36));
+        QCOMPARE(RegionCompositor::contextRect(QRect(10, 10, 20, 20), bounds, 32), QRect(0, 0, 62, 62));
+        QCOMPARE(RegionCompositor::contextRect(QRect(90, 90, 10, 10), bounds, 32), QRect(58, 58, 42, 42));
+        QVERIFY(RegionCompositor::contextRect(QRect(), bounds).isNull());
+
+        QCOMPARE(RegionCompositor::blendRect(QRect(40, 40, 20, 20), bounds, -4), QRect(40, 40, 20, 20));
+        QCOMPARE(RegionCompositor::blendRect(QRect(0, 0, 20, 20), bounds, 8), QRect(0, 0, 28, 28));
+    }
+
+    void RegionCompositorTest::coversBoundsWithOverlappingTiles()
+    {
+        const QRect bounds(16, 8, 300, 200);
+        const QSize tileSize(128, 128);
+        const int overlap = 32;
+        const QList<QRect> tiles = RegionCompositor::tileRects(bounds, tileSize, overlap);
+
+        QCOMPARE(tiles.size(), qsizetype(6));
+        QRegion covered;
+        for (const QRect& tile : tiles)
+        {
+            QCOMPARE(tile.size(), tileSize);
+            QVERIFY(bounds.contains(tile));
+            covered += tile;
+        }
+        QCOMPARE(covered, QRegion(bounds));
+
+        for (qsizetype i = 1; i < tiles.size(); ++i)
+        {
+            if (tiles[i].top() != tiles[i - 1].top())
+                continue;
+            QVERIFY(tiles[i - 1].right() - tiles[i].left() + 1 >= overlap);
+        }
+    }
+
+    void RegionCompositorTest::shrinksSingleTileToBounds()
+    {
+        const QList<QRect> tiles = RegionCompositor::tileRects(QRect(4, 4, 60, 40), QSize(128, 128));
+
+        QCOMPARE(tiles.size(), qsizetype(1));
+        QCOMPARE(tiles.first(), QRect(4, 4, 60, 40));
+        QVERIFY(RegionCompositor::tileRects(QRect(), QSize(128, 128)).isEmpty());
+        QVERIFY(RegionCompositor::tileRects(QRect(0, 0, 10, 10), QSize()).isEmpty());
+    }
+
+    void RegionCompositorTest::mergesIdenticalTilesLosslessly()
+    {
+        const QRect bounds(16, 8, 300, 200);
+        const QImage source = TestImages::pattern(bounds.size());
+        const QList<QRect> tiles = RegionCompositor::tileRects(bounds, QSize(128, 128));
+
+        std::vector<QImage> images;
+        for (const QRect& tile : tiles)
+            images.push_back(source.copy(tile.translated(-bounds.topLeft())));
+
+        const QImage merged = RegionCompositor::mergeTiles(bounds, tiles, images);
+        QCOMPARE(merged.size(), bounds.size());
+        QCOMPARE(merged, source);
+    }
+
+    void RegionCompositorTest::rejectsMismatchedTiles()
+    {
+        const QRect bounds(0, 0, 64, 64);
+        const QList<QRect> tiles = RegionCompositor::tileRects(bounds, QSize(32, 32), 8);
+
+        QVERIFY(RegionCompositor::mergeTiles(bounds, tiles, {}).isNull());
+
+        std::vector<QImage> images(tiles.size(), TestImages::filled(QSize(32, 32), Qt::red));
+        images.back() = QImage();
+        QVERIFY(RegionCompositor::mergeTiles(bounds, tiles, images).isNull());
+    }
+
+    void RegionCompositorTest::stitchesPatchInsideBlendRect()
+    {
+        const QImage source = TestImages::filled(QSize(100, 100), Qt::red);
+        const QRect patchRect(20, 20, 60, 60);
+        const QRect region(40, 40, 20, 20);
+        const int feather = 8;
+        const QImage result = RegionCompositor::stitch(source, TestImages::filled(patchRect.size(), Qt::blue), patchRect, region, feather);
+
+        const QRect blend = RegionCompositor::blendRect(region, source.rect(), feather);
+        QCOMPARE(result.size(), source.size());
+        for (int y = 0; y < result.height(); ++y)
+        {
+            for (int x = 0; x < result.width(); ++x)
+            {
+                if (!blend.contains(x, y))
+                    QCOMPARE(result.pixel(x, y), qRgb(255, 0, 0));
+                else if (region.contains(x, y))
+                    QCOMPARE(result.pixel(x, y), qRgb(0, 0, 255));
+            }
+        }
+
+        const QRgb feathered = result.pixel(region.left() - feather / 2, region.top() + 5);
+        QVERIFY(qRed(feathered) > 0 && qRed(feathered) < 255);
+        QVERIFY(qBlue(feathered) > 0 && qBlue(feathered) < 255);
+    }
+
+    void RegionCompositorTest::scalesPatchToItsRect()
+    {
+        const QImage source = TestImages::filled(QSize(64, 64), Qt::red);
+        const QRect region(16, 16, 32, 32);
+        const QImage result = RegionCompositor::stitch(source, TestImages::filled(QSize(8, 8), Qt::green), region, region, 0);
+
+        QCOMPARE(result.pixel(16, 16), qRgb(0, 255, 0));
+        QCOMPARE(result.pixel(47, 47), qRgb(0, 255, 0));
+        QCOMPARE(result.pixel(15, 16), qRgb(255, 0, 0));
+        QCOMPARE(result.pixel(48, 47), qRgb(255, 0, 0));
+
+        QCOMPARE(RegionCompositor::stitch(source, QImage(), region, region), source);
+    }
+
+    void RegionCompositorTest::mixesEndpointsExactly()
+    {
+        const QRgb from = qRgba(10, 20, 30, 255);
+        const QRgb to = qRgba(200, 150, 100, 255);
+
+        QCOMPARE(RegionCompositor::mix(from, to, 0), from);
+        QCOMPARE(RegionCompositor::mix(from, to, 256), to);
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <QObject>
+
+namespace paint
+{
+    class RegionCompositorTest : public QObject
+    {
+        Q_OBJECT
+
+    private slots:
+        void clampsContextToBounds();
+        void coversBoundsWithOverlappingTiles();
+        void shrinksSingleTileToBounds();
+        void mergesIdenticalTilesLosslessly();
+        void rejectsMismatchedTiles();
+        void stitchesPatchInsideBlendRect();
+        void scalesPatchToItsRect();
+        void mixesEndpointsExactly();
+    };
+}
@@ -0,0 +1,224 @@
+#include "RequestSchedulerTest.h"
+#include "RequestScheduler.h"
+
+#include <QTest>
+
+namespace paint
+{
+    namespace
+    {
+        class FakeReply : public QNetworkReply
+        {
+        public:
+            explicit FakeReply(QObject* parent)
+                : QNetworkReply(parent)
+            {
+                open(QIODevice::ReadOnly);
+            }
+
+            void abort() override
+            {
+            }
+
+            void finish()
+            {
+                setFinished(true);
+                emit finished();
+            }
+
+        protected:
+            qint64 readData(char*, qint64) override
+            {
+                return -1;
+            }
+        };
+
+        class Recorder
+        {
+        public:
+            RequestScheduler::Starter starter(const QString& name)
+            {
+                return [this, name]() -> QNetworkReply* {
+                    started << name;
+                    replies << new FakeReply(&m_owner);
+                    return replies.last();
+                };
+            }
+
+            RequestScheduler::Canceller canceller(const QString& name)
+            {
+                return [this, name]() { cancelled << name; };
+            }
+
+            QStringList started;
+            QStringList cancelled;
+            QList<FakeReply*> replies;
+
+        private:
+            QObject m_owner;
+        };
+    }
+
+    void RequestSchedulerTest::limitsRequestsInFlight()
+    {
+        Recorder recorder;
+        RequestScheduler scheduler(nullptr, 2);
+        for (const QString name : { "a", "b", "c", "d" })
+            scheduler.enqueue(RequestPriority::Interactive, QString(), recorder.starter(name), recorder.canceller(name));
+
+        QCOMPARE(recorder.started, QStringList({ "a", "b" }));
+        QCOMPARE(scheduler.inFlightCount(), 2);
+        QCOMPARE(scheduler.queuedCount(), 2);
+
+        recorder.replies[0]->finish();
+        QCOMPARE(recorder.started, QStringList({ "a", "b", "c" }));
+        QCOMPARE(scheduler.inFlightCount(), 2);
+        QCOMPARE(scheduler.queuedCount(), 1);
+
+        recorder.replies[1]->finish();
+        recorder.replies[2]->finish();
+        QCOMPARE(recorder.started, QStringList({ "a", "b", "c", "d" }));
+        QCOMPARE(scheduler.inFlightCount(), 1);
+        QCOMPARE(scheduler.queuedCount(), 0);
+        QVERIFY(recorder.cancelled.isEmpty());
+    }
+
+    void RequestSchedulerTest::raisingTheLimitDispatchesQueuedRequests()
+    {
+        Recorder recorder;
+        RequestScheduler scheduler(nullptr, 1);
+        for (const QString name : { "a", "b", "c" })
+            scheduler.enqueue(RequestPriority::Interactive, QString(), recorder.starter(name));
+
+        QCOMPARE(recorder.started.size(), qsizetype(1));
+        scheduler.setMaxInFlight(3);
+        QCOMPARE(recorder.started, QStringList({ "a", "b", "c" }));
+
+        scheduler.setMaxInFlight(0);
+        QCOMPARE(scheduler.maxInFlight(), 1);
+    }
+
+    void RequestSchedulerTest::dispatchesByPriority()
+    {
+        Recorder recorder;
+        RequestScheduler scheduler(nullptr, 1);
+        scheduler.enqueue(RequestPriority::Interactive, QString(), recorder.starter("blocker"));
+        scheduler.enqueue(RequestPriority::Speculative, QString(), recorder.starter("speculative"));
+        scheduler.enqueue(RequestPriority::Comparison, QString(), recorder.starter("comparison"));
+        scheduler.enqueue(RequestPriority::Interactive, QString(), recorder.starter("interactive"));
+
+        for (int i = 0; i < 3; ++i)
+            recorder.replies.last()->finish();
+
+        QCOMPARE(recorder.started, QStringList({ "blocker", "interactive", "comparison", "speculative" }));
+    }
+
+    void RequestSchedulerTest::supersedesQueuedRequestsWithTheSameKey()
+    {
+        Recorder recorder;
+        RequestScheduler scheduler(nullptr, 1);
+        scheduler.enqueue(RequestPriority::Interactive, "process:unet", recorder.starter("running"), recorder.canceller("running"));
+        scheduler.enqueue(RequestPriority::Interactive, "process:unet", recorder.starter("stale"), recorder.canceller("stale"));
+        scheduler.enqueue(RequestPriority::Speculative, "process:unet", recorder.starter("latest"), recorder.canceller("latest"));
+
+        QCOMPARE(recorder.cancelled, QStringList({ "stale" }));
+        QCOMPARE(scheduler.queuedCount(), 1);
+
+        recorder.replies[0]->finish();
+        QCOMPARE(recorder.started, QStringList({ "running", "latest" }));
+    }
+
+    void RequestSchedulerTest::keepsRequestsWithoutAKey()
+    {
+        Recorder recorder;
+        RequestScheduler scheduler(nullptr, 1);
+        scheduler.enqueue(RequestPriority::Interactive, QString(), recorder.starter("tile 1"), recorder.canceller("tile 1"));
+        scheduler.enqueue(RequestPriority::Interactive, QString(), recorder.starter("tile 2"), recorder.canceller("tile 2"));
+        scheduler.enqueue(RequestPriority::Interactive, QString(), recorder.starter("tile 3"), recorder.canceller("tile 3"));
+        scheduler.enqueue(RequestPriority::Interactive, "compare", recorder.starter("compare"), recorder.canceller("compare"));
+
+        QVERIFY(recorder.cancelled.isEmpty());
+        QCOMPARE(scheduler.queuedCount(), 3);
+    }
+
+    void RequestSchedulerTest::supersedesOnlyWithinTheSameOwner()
+    {
+        Recorder recorder;
+        QObject window;
+        QObject live;
+        RequestScheduler scheduler(nullptr, 1);
+        scheduler.enqueue(RequestPriority::Interactive, QString(), recorder.starter("blocker"));
+        scheduler.enqueue(RequestPriority::Interactive, "process:unet", recorder.starter("window"), recorder.canceller("window"), &window);
+        scheduler.enqueue(RequestPriority::Speculative, "process:unet", recorder.starter("live"), recorder.canceller("live"), &live);
+
+        QVERIFY(recorder.cancelled.isEmpty());
+        QCOMPARE(scheduler.queuedCount(), 2);
+
+        scheduler.enqueue(RequestPriority::Speculative, "process:unet", recorder.starter("live 2"), recorder.canceller("live 2"), &live);
+        QCOMPARE(recorder.cancelled, QStringList({ "live" }));
+
+        recorder.replies[0]->finish();
+        recorder.replies[1]->finish();
+        QCOMPARE(recorder.started, QStringList({ "blocker", "window", "live 2" }));
+    }
+
+    void RequestSchedulerTest::clearsOnlyTheOwnersRequests()
+    {
+        Recorder recorder;
+        QObject window;
+        QObject live;
+        RequestScheduler scheduler(nullptr, 1);
+        scheduler.enqueue(RequestPriority::Interactive, QString(), recorder.starter("blocker"));
+        scheduler.enqueue(RequestPriority::Interactive, QString(), recorder.starter("window"), recorder.canceller("window"), &window);
+        scheduler.enqueue(RequestPriority::Speculative, QString(), recorder.starter("live"), recorder.canceller("live"), &live);
+
+        scheduler.clear(&window);
+        QCOMPARE(scheduler.queuedCount(), 1);
+        QVERIFY(recorder.cancelled.isEmpty());
+
+        recorder.replies[0]->finish();
+        QCOMPARE(recorder.started, QStringList({ "blocker", "live" }));
+    }
+
+    void RequestSchedulerTest::skipsRequestsWhoseStarterDeclines()
+    {
+        Recorder recorder;
+        RequestScheduler scheduler(nullptr, 1);
+        scheduler.enqueue(RequestPriority::Interactive, QString(), recorder.starter("blocker"));
+        scheduler.enqueue(RequestPriority::Interactive, QString(), []() -> QNetworkReply* { return nullptr; }, recorder.canceller("declined"));
+        scheduler.enqueue(RequestPriority::Interactive, QString(), recorder.starter("next"));
+
+        recorder.replies[0]->finish();
+        QCOMPARE(recorder.cancelled, QStringList({ "declined" }));
+        QCOMPARE(recorder.started, QStringList({ "blocker", "next" }));
+        QCOMPARE(scheduler.inFlightCount(), 1);
+    }
+
+    void RequestSchedulerTest::destroyedRepliesFreeTheirSlot()
+    {
+        Recorder recorder;
+        RequestScheduler scheduler(nullptr, 1);
+        scheduler.enqueue(RequestPriority::Interactive, QString(), recorder.starter("aborted"));
+        scheduler.enqueue(RequestPriority::Interactive, QString(), recorder.starter("next"));
+
+        delete recorder.replies.takeFirst();
+        QCOMPARE(recorder.started, QStringList({ "aborted", "next" }));
+        QCOMPARE(scheduler.inFlightCount(), 1);
+    }
+
+    void RequestSchedulerTest::cancelsByTicket()
+    {
+        Recorder recorder;
+        RequestScheduler scheduler(nullptr, 1);
+        scheduler.enqueue(RequestPriority::Interactive, QString(), recorder.starter("running"));
+        const quint64 ticket = scheduler.enqueue(RequestPriority::Interactive, QString(), recorder.starter("queued"), recorder.canceller("queued"));
+
+        QVERIFY(scheduler.cancel(ticket));
+        QVERIFY(!scheduler.cancel(ticket));
+        QCOMPARE(recorder.cancelled, QStringList({ "queued" }));
+
+        recorder.replies[0]->finish();
+        QCOMPARE(recorder.started, QStringList({ "running" }));
+        QCOMPARE(scheduler.inFlightCount(), 0);
+    }
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <QObject>
+
+namespace paint
+{
+    class RequestSchedulerTest : public QObject
+    {
+        Q_OBJECT
+
+    private slots:
+        void limitsRequestsInFlight();
+        void raisingTheLimitDispatchesQueuedRequests();
+        void dispatchesByPriority();
+        void supersedesQueuedRequestsWithTheSameKey();
+        void keepsRequestsWithoutAKey();
+        void supersedesOnlyWithinTheSameOwner();
+        void clearsOnlyTheOwnersRequests();
+        void skipsRequestsWhoseStarterDeclines();
+        void destroyedRepliesFreeTheirSlot();
+        void cancelsByTicket();
+    };
+}
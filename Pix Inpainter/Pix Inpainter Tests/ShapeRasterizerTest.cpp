@@ -0,0 +1,120 @@
+#include "ShapeRasterizerTest.h"
+#include "ShapeRasterizer.h"
+
+#include <QList>
+#include <QRect>
+#include <QTest>
+
+#include <algorithm>
+
+namespace paint
+{
+    namespace
+    {
+        const QRect CLIP(0, 0, 100, 100);
+
+        QList<QRect> toRects(const std::vector<Span>& spans)
+        {
+            QList<QRect> rects;
+            for (const Span& span : spans)
+                rects.append(QRect(QPoint(span.left, span.y), QPoint(span.right, span.y)));
+            return rects;
+        }
+
+        QRect row(int y, int left, int right)
+        {
+            return QRect(QPoint(left, y), QPoint(right, y));
+        }
+
+        QList<QRect> fill(const std::vector<QPoint>& vertices, FillRule rule, const QRect& clip = CLIP)
+        {
+            return toRects(ShapeRasterizer::fillPolygon(vertices, rule, clip));
+        }
+    }
+
+    void ShapeRasterizerTest::fillsRectangleWithoutHorizontalEdges()
+    {
+        const std::vector<QPoint> square = { { 0, 0 }, { 10, 0 }, { 10, 10 }, { 0, 10 } };
+
+        QList<QRect> expected;
+        for (int y = 0; y < 10; ++y)
+            expected.append(row(y, 0, 9));
+
+        QCOMPARE(fill(square, FillRule::EvenOdd), expected);
+        QCOMPARE(fill(square, FillRule::NonZero), expected);
+    }
+
+    void ShapeRasterizerTest::stepsAcrossInnerHorizontalEdges()
+    {
+        const std::vector<QPoint> steps = { { 0, 0 }, { 4, 0 }, { 4, 2 }, { 8, 2 }, { 8, 4 }, { 0, 4 } };
+        const QList<QRect> expected = { row(0, 0, 3), row(1, 0, 3), row(2, 0, 7), row(3, 0, 7) };
+
+        QCOMPARE(fill(steps, FillRule::EvenOdd), expected);
+        QCOMPARE(fill(steps, FillRule::NonZero), expected);
+    }
+
+    void ShapeRasterizerTest::fillsOverlappingLoopsPerFillRule()
+    {
+        // An outer and an inner square traced in the same direction: the inner one winds twice.
+        const std::vector<QPoint> loops = {
+            { 0, 0 }, { 10, 0 }, { 10, 10 }, { 0, 10 }, { 0, 0 },
+            { 2, 2 }, { 8, 2 }, { 8, 8 }, { 2, 8 }, { 2, 2 } };
+
+        QList<QRect> nonZero;
+        QList<QRect> evenOdd;
+        for (int y = 0; y < 10; ++y)
+        {
+            nonZero.append(row(y, 0, 9));
+            if (y >= 2 && y < 8)
+            {
+                evenOdd.append(row(y, 0, 1));
+                evenOdd.append(row(y, 8, 9));
+            }
+            else
+            {
+                evenOdd.append(row(y, 0, 9));
+            }
+        }
+
+        QCOMPARE(fill(loops, FillRule::NonZero), nonZero);
+        QCOMPARE(fill(loops, FillRule::EvenOdd), evenOdd);
+    }
+
+    void ShapeRasterizerTest::resortsEdgesWhereTheyCross()
+    {
+        // A bow tie: the diagonals swap places at y = 5 and the two lobes wind in opposite directions.
+        const std::vector<QPoint> bowTie = { { 0, 0 }, { 10, 10 }, { 10, 0 }, { 0, 10 } };
+
+        QList<QRect> expected;
+        for (int y = 1; y < 10; ++y)
+        {
+            if (y == 5)
+            {
+                expected.append(row(y, 0, 9));
+                continue;
+            }
+            const int inner = std::min(y, 10 - y);
+            expected.append(row(y, 0, inner - 1));
+            expected.append(row(y, 10 - inner, 9));
+        }
+
+        QCOMPARE(fill(bowTie, FillRule::EvenOdd), expected);
+        QCOMPARE(fill(bowTie, FillRule::NonZero), expected);
+    }
+
+    void ShapeRasterizerTest::clipsSpansToTheClipRect()
+    {
+        const std::vector<QPoint> square = { { 0, 0 }, { 10, 0 }, { 10, 10 }, { 0, 10 } };
+        const QList<QRect> expected = { row(3, 2, 5), row(4, 2, 5), row(5, 2, 5), row(6, 2, 5) };
+
+        QCOMPARE(fill(square, FillRule::NonZero, QRect(2, 3, 4, 4)), expected);
+        QVERIFY(fill(square, FillRule::NonZero, QRect(20, 20, 4, 4)).isEmpty());
+    }
+
+    void ShapeRasterizerTest::skipsDegeneratePolygons()
+    {
+        QVERIFY(fill({}, FillRule::NonZero).isEmpty());
+        QVERIFY(fill({ { 0, 4 }, { 10, 4 } }, FillRule::NonZero).isEmpty());
+        QVERIFY(fill({ { 0, 4 }, { 5, 4 }, { 10, 4 } }, FillRule::EvenOdd).isEmpty());
+    }
+}
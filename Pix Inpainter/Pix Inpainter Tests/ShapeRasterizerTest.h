@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QObject>
+
+namespace paint
+{
+    class ShapeRasterizerTest : public QObject
+    {
+        Q_OBJECT
+
+    private slots:
+        void fillsRectangleWithoutHorizontalEdges();
+        void stepsAcrossInnerHorizontalEdges();
+        void fillsOverlappingLoopsPerFillRule();
+        void resortsEdgesWhereTheyCross();
+        void clipsSpansToTheClipRect();
+        void skipsDegeneratePolygons();
+    };
+}
@@ -0,0 +1,102 @@
+#include "SweepSessionTest.h"
+#include "SweepSession.h"
+#include "TestImages.h"
+
+#include <QTest>
+
+namespace paint
+{
+    namespace
+    {
+        QByteArray iterationFrame(int iteration, const QByteArray& payload)
+        {
+            return FrameParser::encode({ { "model_id", "unet" }, { "postprocess_value", iteration }, { "ok", true } }, payload);
+        }
+    }
+
+    void SweepSessionTest::restartResetsState()
+    {
+        SweepSession session;
+        const quint64 first = session.restart("unet", "digest", 3);
+        session.setResult(1, TestImages::solidPixmap(Qt::gray, 4));
+        session.beginDecode();
+        session.append(iterationFrame(2, "partial").left(7));
+
+        const quint64 second = session.restart("gan", "other", 0);
+        QVERIFY(second != first);
+        QCOMPARE(session.generation(), second);
+        QCOMPARE(session.modelKey(), QString("gan"));
+        QCOMPARE(session.imageDigest(), QByteArray("other"));
+        QCOMPARE(session.iterations(), 1);
+        QCOMPARE(session.pendingDecodes(), 0);
+        QVERIFY(session.result(1).isNull());
+
+        SweepSession::Frame frame;
+        QVERIFY(!session.next(frame));
+    }
+
+    void SweepSessionTest::returnsRequestedIterations()
+    {
+        SweepSession session;
+        session.restart("unet", "digest", 2);
+        session.append(iterationFrame(0, "zero") + iterationFrame(1, "one") + iterationFrame(3, "three") + iterationFrame(2, "two"));
+
+        SweepSession::Frame frame;
+        QVERIFY(session.next(frame));
+        QVERIFY(frame.ok);
+        QCOMPARE(frame.iteration, 1);
+        QCOMPARE(frame.payload, QByteArray("one"));
+
+        QVERIFY(session.next(frame));
+        QCOMPARE(frame.iteration, 2);
+        QCOMPARE(frame.payload, QByteArray("two"));
+
+        QVERIFY(!session.next(frame));
+    }
+
+    void SweepSessionTest::returnsErrorFrames()
+    {
+        SweepSession session;
+        session.restart("unet", "digest", 2);
+        session.append(FrameParser::encode({ { "model_id", "unet" }, { "postprocess_value", 0 }, { "ok", false }, { "error", "CUDA error" } }));
+
+        SweepSession::Frame frame;
+        QVERIFY(session.next(frame));
+        QVERIFY(!frame.ok);
+        QCOMPARE(frame.error, QString("CUDA error"));
+    }
+
+    void SweepSessionTest::completesWhenEveryIterationArrives()
+    {
+        SweepSession session;
+        session.restart("unet", "digest", 2);
+        QVERIFY(!session.isComplete());
+
+        session.setResult(2, TestImages::solidPixmap(Qt::gray, 4));
+        QVERIFY(!session.isComplete());
+        session.setResult(1, TestImages::solidPixmap(Qt::gray, 4));
+        QVERIFY(session.isComplete());
+
+        session.fail();
+        QVERIFY(!session.isComplete());
+    }
+
+    void SweepSessionTest::endStreamRecordsFailure()
+    {
+        SweepSession session;
+        session.restart("unet", "digest", 1);
+        session.setResult(1, TestImages::solidPixmap(Qt::gray, 4));
+
+        const QByteArray frame = iterationFrame(1, "late");
+        session.append(frame.left(frame.size() - 2));
+        session.endStream(true);
+        QVERIFY(!session.isComplete());
+
+        session.append(frame.right(2));
+        SweepSession::Frame parsed;
+        QVERIFY(!session.next(parsed));
+
+        session.endStream(false);
+        QVERIFY(session.isComplete());
+    }
+}
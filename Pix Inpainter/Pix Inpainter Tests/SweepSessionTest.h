@@ -0,0 +1,18 @@
+#pragma once
+
+#include <QObject>
+
+namespace paint
+{
+    class SweepSessionTest : public QObject
+    {
+        Q_OBJECT
+
+    private slots:
+        void restartResetsState();
+        void returnsRequestedIterations();
+        void returnsErrorFrames();
+        void completesWhenEveryIterationArrives();
+        void endStreamRecordsFailure();
+    };
+}
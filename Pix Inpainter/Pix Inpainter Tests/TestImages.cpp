@@ -0,0 +1,39 @@
+#include "TestImages.h"
+
+#include <QBuffer>
+
+namespace paint
+{
+    QImage TestImages::pattern(const QSize& size)
+    {
+        QImage image(size, QImage::Format_ARGB32_Premultiplied);
+        for (int y = 0; y < size.height(); ++y)
+        {
+            QRgb* line = reinterpret_cast<QRgb*>(image.scanLine(y));
+            for (int x = 0; x < size.width(); ++x)
+                line[x] = qRgb((x * 5) % 256, (y * 3) % 256, (x + y) % 256);
+        }
+        return image;
+    }
+
+    QImage TestImages::filled(const QSize& size, const QColor& color)
+    {
+        QImage image(size, QImage::Format_ARGB32_Premultiplied);
+        image.fill(color);
+        return image;
+    }
+
+    QPixmap TestImages::solidPixmap(const QColor& color, int size)
+    {
+        return QPixmap::fromImage(filled(QSize(size, size), color));
+    }
+
+    QByteArray TestImages::png(const QImage& image)
+    {
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "PNG");
+        return data;
+    }
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <QByteArray>
+#include <QColor>
+#include <QImage>
+#include <QPixmap>
+#include <QSize>
+
+namespace paint
+{
+    class TestImages
+    {
+    public:
+        TestImages() = delete;
+
+        static QImage pattern(const QSize& size);
+        static QImage filled(const QSize& size, const QColor& color);
+        static QPixmap solidPixmap(const QColor& color, int size = 10);
+        static QByteArray png(const QImage& image);
+    };
+}
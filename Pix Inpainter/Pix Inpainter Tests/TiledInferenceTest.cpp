@@ -0,0 +1,126 @@
+#include "TiledInferenceTest.h"
+#include "TiledInference.h"
+#include "GrayPayload.h"
+#include "RegionCompositor.h"
+#include "TestImages.h"
+
+#include <QRegion>
+#include <QTest>
+
+namespace paint
+{
+    void TiledInferenceTest::splitsWholeImageIntoTiles()
+    {
+        const QImage source = TestImages::pattern(QSize(600, 400));
+        const TiledInference inference(source, QRect(), QSize(256, 256));
+
+        QCOMPARE(inference.tileCount(), 6);
+        QCOMPARE(inference.completedCount(), 0);
+        QVERIFY(inference.resultRegion().isEmpty());
+
+        QRegion covered;
+        for (int i = 0; i < inference.tileCount(); ++i)
+        {
+            const QRect& tile = inference.tiles()[i];
+            QCOMPARE(inference.tileImage(i), source.copy(tile));
+            covered += tile;
+        }
+        QCOMPARE(covered, QRegion(source.rect()));
+    }
+
+    void TiledInferenceTest::cropsRegionToContextRect()
+    {
+        const QImage source = TestImages::pattern(QSize(400, 400));
+        const QRect region(150, 150, 40, 40);
+        const QRect context = RegionCompositor::contextRect(region, source.rect());
+        const TiledInference inference(source, region, QSize(64, 64));
+
+        QRegion covered;
+        for (int i = 0; i < inference.tileCount(); ++i)
+        {
+            const QRect& tile = inference.tiles()[i];
+            QCOMPARE(inference.tileImage(i), source.copy(tile.translated(context.topLeft())));
+            covered += tile;
+        }
+        QCOMPARE(covered, QRegion(QRect(QPoint(0, 0), context.size())));
+    }
+
+    void TiledInferenceTest::countsFinishedTiles()
+    {
+        TiledInference inference(TestImages::pattern(QSize(100, 100)), QRect(), QSize(64, 64));
+        const int total = inference.tileCount();
+        QCOMPARE(total, 9);
+
+        for (int i = 1; i < total; ++i)
+        {
+            QVERIFY(!inference.finishTile());
+            QCOMPARE(inference.completedCount(), i);
+        }
+        QVERIFY(inference.finishTile());
+        QCOMPARE(inference.completedCount(), total);
+        QVERIFY(!inference.finishTile());
+    }
+
+    void TiledInferenceTest::mergesEchoedTilesBackToSource()
+    {
+        const QImage source = TestImages::pattern(QSize(300, 200));
+        TiledInference inference(source, QRect(), QSize(128, 128));
+
+        for (int i = 0; i < inference.tileCount(); ++i)
+            QVERIFY(inference.decodeTile(i, TestImages::png(inference.tileImage(i))));
+        QVERIFY(inference.merge());
+
+        QCOMPARE(inference.merged(), source);
+        QCOMPARE(QImage::fromData(inference.encodedData(), "PNG").convertToFormat(QImage::Format_ARGB32_Premultiplied), source);
+    }
+
+    void TiledInferenceTest::stitchesRegionIntoSource()
+    {
+        const QImage source = TestImages::filled(QSize(200, 200), Qt::red);
+        const QRect region(80, 80, 20, 20);
+        const QRect context = RegionCompositor::contextRect(region, source.rect());
+        TiledInference inference(source, region, QSize(32, 32));
+
+        for (int i = 0; i < inference.tileCount(); ++i)
+            QVERIFY(inference.decodeTile(i, TestImages::png(TestImages::filled(inference.tiles()[i].size(), Qt::blue))));
+        QVERIFY(inference.merge());
+
+        QCOMPARE(QImage::fromData(inference.encodedData(), "PNG").size(), context.size());
+
+        const QImage& merged = inference.merged();
+        const QRect blend = inference.resultRegion();
+        QCOMPARE(blend, RegionCompositor::blendRect(region, source.rect()));
+        QCOMPARE(merged.size(), source.size());
+        for (int y = 0; y < merged.height(); ++y)
+        {
+            for (int x = 0; x < merged.width(); ++x)
+            {
+                if (!blend.contains(x, y))
+                    QCOMPARE(merged.pixel(x, y), qRgb(255, 0, 0));
+                else if (region.contains(x, y))
+                    QCOMPARE(merged.pixel(x, y), qRgb(0, 0, 255));
+            }
+        }
+    }
+
+    void TiledInferenceTest::decodesGrayPayloadTiles()
+    {
+        const QByteArray payload = GrayPayload::encode(TestImages::filled(QSize(32, 32), QColor(90, 90, 90)), QSize(8, 8));
+        const QImage tile = TiledInference::decodeTileImage(payload, QSize(32, 32));
+
+        QCOMPARE(tile.size(), QSize(32, 32));
+        QCOMPARE(qGray(tile.pixel(16, 16)), 90);
+    }
+
+    void TiledInferenceTest::rejectsUndecodableTiles()
+    {
+        TiledInference inference(TestImages::pattern(QSize(100, 100)), QRect(), QSize(64, 64));
+
+        QVERIFY(!inference.decodeTile(0, QByteArray("not an image")));
+        for (int i = 1; i < inference.tileCount(); ++i)
+            QVERIFY(inference.decodeTile(i, TestImages::png(inference.tileImage(i))));
+        QVERIFY(!inference.merge());
+        QVERIFY(inference.merged().isNull());
+        QVERIFY(TiledInference::decodeTileImage(QByteArray(), QSize(8, 8)).isNull());
+    }
+}
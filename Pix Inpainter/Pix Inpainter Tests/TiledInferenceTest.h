@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QObject>
+
+namespace paint
+{
+    class TiledInferenceTest : public QObject
+    {
+        Q_OBJECT
+
+    private slots:
+        void splitsWholeImageIntoTiles();
+        void cropsRegionToContextRect();
+        void countsFinishedTiles();
+        void mergesEchoedTilesBackToSource();
+        void stitchesRegionIntoSource();
+        void decodesGrayPayloadTiles();
+        void rejectsUndecodableTiles();
+    };
+}
@@ -0,0 +1,38 @@
+#include "InferenceCacheTest.h"
+#include "FrameParserTest.h"
+#include "ComparisonSessionTest.h"
+#include "SweepSessionTest.h"
+#include "GrayPayloadTest.h"
+#include "RequestSchedulerTest.h"
+#include "RegionCompositorTest.h"
+#include "TiledInferenceTest.h"
+#include "ShapeRasterizerTest.h"
+#include "ContentHashTest.h"
+
+#include <QGuiApplication>
+#include <QTest>
+
+#include <initializer_list>
+
+int main(int argc, char* argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QGuiApplication app(argc, argv);
+
+    paint::InferenceCacheTest inferenceCache;
+    paint::FrameParserTest frameParser;
+    paint::ComparisonSessionTest comparisonSession;
+    paint::SweepSessionTest sweepSession;
+    paint::GrayPayloadTest grayPayload;
+    paint::RequestSchedulerTest requestScheduler;
+    paint::RegionCompositorTest regionCompositor;
+    paint::TiledInferenceTest tiledInference;
+    paint::ShapeRasterizerTest shapeRasterizer;
+    paint::ContentHashTest contentHash;
+
+    int status = 0;
+    for (QObject* test : std::initializer_list<QObject*>{ &inferenceCache, &frameParser, &comparisonSession, &sweepSession, &grayPayload, &requestScheduler, &regionCompositor, &tiledInference, &shapeRasterizer, &contentHash })
+        status |= QTest::qExec(test, argc, argv);
+    return status;
+}
@@ -31,6 +31,10 @@ namespace paint
             disconnect(m_model, &AICompletionModel::comparisonFinished, this, &AICompletionController::onComparisonFinished);
             disconnect(m_model, &AICompletionModel::allComparisonsFinished, this, &AICompletionController::onAllComparisonsFinished);
             disconnect(m_model, &AICompletionModel::statusChanged, this, &AICompletionController::onStatusChanged);
+            disconnect(m_model, &AICompletionModel::cacheStatsChanged, this, &AICompletionController::onCacheStatsChanged);
+            disconnect(m_model, &AICompletionModel::sweepStarted, this, &AICompletionController::onSweepStarted);
+            disconnect(m_model, &AICompletionModel::sweepIterationReady, this, &AICompletionController::onSweepIterationReady);
+            disconnect(m_model, &AICompletionModel::sweepFinished, this, &AICompletionController::onSweepFinished);
         }
 
         m_model = model;
@@ -44,6 +48,10 @@ namespace paint
             connect(m_model, &AICompletionModel::comparisonFinished, this, &AICompletionController::onComparisonFinished);
             connect(m_model, &AICompletionModel::allComparisonsFinished, this, &AICompletionController::onAllComparisonsFinished);
             connect(m_model, &AICompletionModel::statusChanged, this, &AICompletionController::onStatusChanged);
+            connect(m_model, &AICompletionModel::cacheStatsChanged, this, &AICompletionController::onCacheStatsChanged);
+            connect(m_model, &AICompletionModel::sweepStarted, this, &AICompletionController::onSweepStarted);
+            connect(m_model, &AICompletionModel::sweepIterationReady, this, &AICompletionController::onSweepIterationReady);
+            connect(m_model, &AICompletionModel::sweepFinished, this, &AICompletionController::onSweepFinished);
 
             if (m_view && m_model)
             {
@@ -73,6 +81,10 @@ namespace paint
             {
                 m_view->displayResultImage(m_model->resultPixmap());
             }
+            m_view->setCacheStats(m_model->cacheHits(), m_model->cacheMisses());
+            m_model->setRegionOfInterest(m_view->getRegionOfInterest());
+            m_model->setMaxConcurrentRequests(m_view->getMaxConcurrentRequests());
+            m_model->setTiledInference(m_view->isTiledInferenceEnabled());
         }
     }
 
@@ -84,6 +96,22 @@ namespace paint
         }
     }
 
+    void AICompletionController::setImage(const QImage& image)
+    {
+        if (m_model)
+        {
+            m_model->setImage(image);
+        }
+    }
+
+    void AICompletionController::setImageSource(AICompletionModel::ImageSource source)
+    {
+        if (m_model)
+        {
+            m_model->setImageSource(std::move(source));
+        }
+    }
+
     AICompletionWidget* AICompletionController::view() const
     {
         return m_view;
@@ -95,8 +123,13 @@ namespace paint
         {
             connect(m_view, &AICompletionWidget::processImageRequested, this, &AICompletionController::onProcessImageRequested);
             connect(m_view, &AICompletionWidget::compareModelsRequested, this, &AICompletionController::onCompareModelsRequested);
+            connect(m_view, &AICompletionWidget::sweepRequested, this, &AICompletionController::onSweepRequested);
+            connect(m_view, &AICompletionWidget::sweepIterationSelected, this, &AICompletionController::onSweepIterationSelected);
             connect(m_view, &AICompletionWidget::modelSelectionChanged, this, &AICompletionController::onModelSelectionChanged);
             connect(m_view, &AICompletionWidget::previewImageChanged, this, &AICompletionController::onPreviewImageUpdated);
+            connect(m_view, &AICompletionWidget::regionOfInterestChanged, this, &AICompletionController::onRegionOfInterestChanged);
+            connect(m_view, &AICompletionWidget::maxConcurrentRequestsChanged, this, &AICompletionController::onMaxConcurrentRequestsChanged);
+            connect(m_view, &AICompletionWidget::tiledInferenceToggled, this, &AICompletionController::onTiledInferenceToggled);
         }
         
         if (m_model)
@@ -111,8 +144,13 @@ namespace paint
         {
             disconnect(m_view, &AICompletionWidget::processImageRequested, this, &AICompletionController::onProcessImageRequested);
             disconnect(m_view, &AICompletionWidget::compareModelsRequested, this, &AICompletionController::onCompareModelsRequested);
+            disconnect(m_view, &AICompletionWidget::sweepRequested, this, &AICompletionController::onSweepRequested);
+            disconnect(m_view, &AICompletionWidget::sweepIterationSelected, this, &AICompletionController::onSweepIterationSelected);
             disconnect(m_view, &AICompletionWidget::modelSelectionChanged, this, &AICompletionController::onModelSelectionChanged);
             disconnect(m_view, &AICompletionWidget::previewImageChanged, this, &AICompletionController::onPreviewImageUpdated);
+            disconnect(m_view, &AICompletionWidget::regionOfInterestChanged, this, &AICompletionController::onRegionOfInterestChanged);
+            disconnect(m_view, &AICompletionWidget::maxConcurrentRequestsChanged, this, &AICompletionController::onMaxConcurrentRequestsChanged);
+            disconnect(m_view, &AICompletionWidget::tiledInferenceToggled, this, &AICompletionController::onTiledInferenceToggled);
         }
     }
 
@@ -150,6 +188,34 @@ namespace paint
         }
     }
 
+    void AICompletionController::onSweepRequested()
+    {
+        if (m_model && m_view)
+        {
+            QString modelKey = m_view->getSelectedModelKey();
+            if (!modelKey.isEmpty())
+            {
+                m_model->processSweep(modelKey, m_view->getSweepIterations());
+            }
+            else
+            {
+                m_view->setStatusText("No model selected for the sweep.");
+            }
+        }
+    }
+
+    void AICompletionController::onSweepIterationSelected(int iteration)
+    {
+        if (m_model && m_view)
+        {
+            const QPixmap pixmap = m_model->sweepPixmap(iteration);
+            if (!pixmap.isNull())
+            {
+                m_view->displayResultImage(pixmap);
+            }
+        }
+    }
+
     void AICompletionController::onModelSelectionChanged()
     {
     }
@@ -192,6 +258,37 @@ namespace paint
         }
     }
 
+    void AICompletionController::onSweepStarted(int iterations)
+    {
+        if (m_view)
+        {
+            m_view->setSweepRange(iterations);
+            m_view->setProcessButtonEnabled(false);
+            m_view->setCompareButtonEnabled(false);
+        }
+    }
+
+    void AICompletionController::onSweepIterationReady(int iteration, const QPixmap& resultPixmap)
+    {
+        if (m_view)
+        {
+            m_view->setSweepIterationAvailable(iteration);
+        }
+    }
+
+    void AICompletionController::onSweepFinished(bool success)
+    {
+        if (m_view)
+        {
+            if (!success)
+            {
+                m_view->setStatusText("Postprocess sweep failed.");
+            }
+            m_view->setProcessButtonEnabled(true);
+            m_view->setCompareButtonEnabled(true);
+        }
+    }
+
     void AICompletionController::onComparisonStarted(const QStringList& modelKeys)
     {
         if (m_view)
@@ -244,17 +341,43 @@ namespace paint
         }
     }
 
+    void AICompletionController::onCacheStatsChanged(int hits, int misses)
+    {
+        if (m_view)
+        {
+            m_view->setCacheStats(hits, misses);
+        }
+    }
+
     void AICompletionController::onPreviewImageUpdated(const QPixmap& newPreviewImage)
     {
         if (m_model && !newPreviewImage.isNull())
         {
-            QByteArray byteArray;
-            QBuffer buffer(&byteArray);
-            buffer.open(QIODevice::WriteOnly);
-            newPreviewImage.save(&buffer, "PNG");
-            buffer.close();
+            m_model->promoteResult(newPreviewImage);
+        }
+    }
+
+    void AICompletionController::onRegionOfInterestChanged(const QRect& region)
+    {
+        if (m_model)
+        {
+            m_model->setRegionOfInterest(region);
+        }
+    }
+
+    void AICompletionController::onMaxConcurrentRequestsChanged(int maxInFlight)
+    {
+        if (m_model)
+        {
+            m_model->setMaxConcurrentRequests(maxInFlight);
+        }
+    }
 
-            m_model->setImageData(byteArray);
+    void AICompletionController::onTiledInferenceToggled(bool enabled)
+    {
+        if (m_model)
+        {
+            m_model->setTiledInference(enabled);
         }
     }
 
@@ -6,6 +6,7 @@
 #include <QByteArray>
 #include <QObject>
 #include <QPixmap>
+#include <QImage>
 
 namespace paint
 {
@@ -26,11 +27,15 @@ namespace paint
         void setModel(AICompletionModel* model);
         void setView(AICompletionWidget* view);
         void setImageData(const QByteArray& pngData);
+        void setImage(const QImage& image);
+        void setImageSource(AICompletionModel::ImageSource source);
         AICompletionWidget* view() const;
 
     private slots:
         void onProcessImageRequested();
         void onCompareModelsRequested();
+        void onSweepRequested();
+        void onSweepIterationSelected(int iteration);
         void onModelSelectionChanged();
 
         void onImageDataChanged(const QPixmap& pixmap);
@@ -39,8 +44,15 @@ namespace paint
         void onComparisonStarted(const QStringList& modelKeys);
         void onComparisonFinished(const QString& modelKey, bool success, const QPixmap& resultPixmap);
         void onAllComparisonsFinished();
+        void onSweepStarted(int iterations);
+        void onSweepIterationReady(int iteration, const QPixmap& resultPixmap);
+        void onSweepFinished(bool success);
         void onStatusChanged(const QString& message);
+        void onCacheStatsChanged(int hits, int misses);
         void onPreviewImageUpdated(const QPixmap& newPreviewImage);
+        void onRegionOfInterestChanged(const QRect& region);
+        void onMaxConcurrentRequestsChanged(int maxInFlight);
+        void onTiledInferenceToggled(bool enabled);
         void onModelsInitialized(const QStringList& modelNames, const QStringList& modelKeys);
 
     private:
@@ -1,39 +1,80 @@
 #include "AICompletionModel.h"
+#include "GrayPayload.h"
+#include "RegionCompositor.h"
 #include <QNetworkRequest>
 #include <QUrlQuery>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QBuffer>
+#include <QCoreApplication>
+#include <QPointer>
+#include <QElapsedTimer>
+#include <QStandardPaths>
+#include <QtEndian>
+
+#include <algorithm>
 
 const QString SERVER_BASE_URL = "http://localhost:5000/";
 
 namespace paint
 {
-    AICompletionModel::AICompletionModel(QObject* parent)
+    namespace
+    {
+        struct PreparedImage
+        {
+            QImage image;
+            QByteArray digest;
+            QByteArray encodedData;
+            qint64 elapsedMs = 0;
+        };
+
+        struct DecodedImage
+        {
+            QImage image;
+            qint64 elapsedMs = 0;
+        };
+    }
+
+    AICompletionModel::AICompletionModel(QObject* parent, WorkStealingPoolPtr taskPool, RequestScheduler* scheduler)
         : QObject(parent)
         , m_networkManager(new QNetworkAccessManager(this))
-        , m_currentReply(nullptr)
-        , m_currentProcessingModelKey("")
-        , m_currentPostprocessValue(0)
-        , m_totalComparisonRequests(0)
+        , m_taskPool(std::move(taskPool))
+        , m_imageGeneration(0)
+        , m_resultCache(InferenceCache::DEFAULT_MEMORY_BUDGET,
+            QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/inference", m_taskPool)
+        , m_scheduler(scheduler ? scheduler : new RequestScheduler(this))
+        , m_processSequence(0)
+        , m_cancelledProcessSequence(0)
+        , m_tiledInference(false)
+        , m_comparisonReply(nullptr)
+        , m_rawUploadSupported(false)
+        , m_sweepReply(nullptr)
     {
         initializeModels();
     }
 
     AICompletionModel::~AICompletionModel()
     {
-        if (m_currentReply)
+        if (m_scheduler)
+            m_scheduler->clear(this);
+        for (QNetworkReply* reply : std::as_const(m_processReplies))
         {
-            m_currentReply->abort();
-            m_currentReply->deleteLater();
+            reply->disconnect(this);
+            reply->abort();
+            reply->deleteLater();
         }
-        for (const auto& req : std::as_const(m_activeComparisonRequests))
+        if (m_comparisonReply)
         {
-            if (req.reply) {
-                req.reply->abort();
-                req.reply->deleteLater();
-            }
+            m_comparisonReply->disconnect(this);
+            m_comparisonReply->abort();
+            m_comparisonReply->deleteLater();
+        }
+        if (m_sweepReply)
+        {
+            m_sweepReply->disconnect(this);
+            m_sweepReply->abort();
+            m_sweepReply->deleteLater();
         }
     }
 
@@ -69,6 +110,14 @@ namespace paint
                 m_modelNames.append(key);
             }
 
+            m_modelInputSizes.clear();
+            const QJsonObject geometry = obj.value("models").toObject();
+            for (auto it = geometry.begin(); it != geometry.end(); ++it) {
+                const QJsonObject model = it.value().toObject();
+                m_modelInputSizes.insert(it.key(), QSize(model.value("input_width").toInt(), model.value("input_height").toInt()));
+            }
+            m_rawUploadSupported = obj.value("formats").toArray().contains(QJsonValue(QString(GrayPayload::CONTENT_TYPE)));
+
             emit statusChanged("Models initialized.");
             reply->deleteLater();
 
@@ -79,34 +128,233 @@ namespace paint
     void AICompletionModel::reinitializeModels()
     {
         m_comparisonPixmaps.clear();
-        
+
         initializeModels();
     }
 
+    void AICompletionModel::setMaxConcurrentRequests(int maxInFlight)
+    {
+        m_scheduler->setMaxInFlight(maxInFlight);
+    }
+
+    int AICompletionModel::maxConcurrentRequests() const
+    {
+        return m_scheduler->maxInFlight();
+    }
+
+    void AICompletionModel::setTiledInference(bool enabled)
+    {
+        m_tiledInference = enabled;
+    }
+
+    bool AICompletionModel::tiledInference() const
+    {
+        return m_tiledInference;
+    }
+
+    void AICompletionModel::setImage(const QImage& image)
+    {
+        setImageSource([image]() { return image; });
+    }
+
+    void AICompletionModel::setImageSource(ImageSource source)
+    {
+        if (!source)
+            return;
+
+        prepareImage(std::move(source), QByteArray());
+    }
+
     void AICompletionModel::setImageData(const QByteArray& pngData)
     {
-        m_imageData = pngData;
+        prepareImage([pngData]() { return QImage::fromData(pngData, "PNG"); }, pngData);
+    }
+
+    void AICompletionModel::promoteResult(const QPixmap& pixmap)
+    {
+        if (pixmap.isNull())
+            return;
+
+        const QByteArray encodedData = m_resultOrigins.value(pixmap.cacheKey()).encodedData;
+        if (encodedData.isEmpty())
+        {
+            setImage(pixmap.toImage());
+            return;
+        }
+
+        prepareImage([image = pixmap.toImage()]() { return image; }, encodedData, pixmap);
+    }
+
+    void AICompletionModel::prepareImage(ImageSource source, const QByteArray& encodedData, const QPixmap& preview)
+    {
+        const quint64 generation = ++m_imageGeneration;
+        const bool encodePng = encodedData.isEmpty() && !m_rawUploadSupported && m_region.isEmpty();
+
+        auto prepare = [source, encodedData, encodePng]() {
+            QElapsedTimer timer;
+            timer.start();
+
+            PreparedImage prepared;
+            prepared.image = source();
+            prepared.digest = InferenceCache::digest(prepared.image);
+            prepared.encodedData = encodedData;
+            if (encodePng && !prepared.image.isNull())
+            {
+                QBuffer buffer(&prepared.encodedData);
+                buffer.open(QIODevice::WriteOnly);
+                prepared.image.save(&buffer, "PNG");
+            }
+            prepared.elapsedMs = timer.elapsed();
+            return prepared;
+        };
+
+        auto apply = [this, preview](const PreparedImage& prepared) {
+            setSourceImage(prepared.image, prepared.digest, prepared.encodedData, preview);
+            emit statusChanged(QString("Ready to process (image prepared in %1 ms)").arg(prepared.elapsedMs));
+        };
+
+        if (!m_taskPool)
+        {
+            apply(prepare());
+            return;
+        }
+
+        emit statusChanged("Preparing image...");
+        QPointer<AICompletionModel> self(this);
+        m_taskPool->submit(QStringLiteral("AI image encode"), TaskPriority::Background, [self, generation, prepare, apply]() {
+            const PreparedImage prepared = prepare();
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [self, generation, prepared, apply]() {
+                if (self && self->m_imageGeneration == generation)
+                    apply(prepared);
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    void AICompletionModel::decodeInBackground(const QByteArray& data, DecodeCallback done)
+    {
+        auto decode = [data, decoder = resultDecoder()]() {
+            QElapsedTimer timer;
+            timer.start();
+
+            DecodedImage decoded;
+            decoded.image = decoder(data);
+            decoded.elapsedMs = timer.elapsed();
+            return decoded;
+        };
+
+        if (!m_taskPool)
+        {
+            const DecodedImage decoded = decode();
+            done(QPixmap::fromImage(decoded.image), decoded.elapsedMs);
+            return;
+        }
 
-        if (!m_imageData.isEmpty())
+        QPointer<AICompletionModel> self(this);
+        m_taskPool->submit(QStringLiteral("AI result decode"), TaskPriority::Interactive, [self, decode, done]() {
+            const DecodedImage decoded = decode();
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [self, decoded, done]() {
+                if (self)
+                    done(QPixmap::fromImage(decoded.image), decoded.elapsedMs);
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    void AICompletionModel::setSourceImage(const QImage& image, const QByteArray& digest, const QByteArray& encodedData, const QPixmap& preview)
+    {
+        ++m_imageGeneration;
+        m_sourceImage = image;
+        m_imageDigest = digest;
+        m_region = m_region.intersected(image.rect());
+        if (!m_region.isEmpty())
+        {
+            m_imageData.clear();
+            m_rawPayload.clear();
+            m_rawPayloadSize = QSize();
+        }
+        else if (GrayPayload::isPayload(encodedData))
         {
-            m_previewPixmap.loadFromData(m_imageData);
+            m_imageData.clear();
+            m_rawPayload = encodedData;
+            m_rawPayloadSize = GrayPayload::size(encodedData);
         }
         else
         {
-            m_previewPixmap = QPixmap();
+            m_imageData = encodedData;
+            m_rawPayload.clear();
+            m_rawPayloadSize = QSize();
         }
 
+        if (!preview.isNull())
+            m_previewPixmap = preview;
+        else
+            m_previewPixmap = image.isNull() ? QPixmap() : QPixmap::fromImage(image);
+
         emit imageDataChanged(m_previewPixmap);
 
         m_resultPixmap = QPixmap();
         m_comparisonPixmaps.clear();
+        m_sweep.clearResults();
+        m_resultOrigins.clear();
 
         emit statusChanged("Ready to process");
     }
 
-    QByteArray AICompletionModel::imageData() const
+    QPixmap AICompletionModel::rememberResult(const InferenceCache::Result& result, const QRect& region)
+    {
+        if (!result.pixmap.isNull())
+            m_resultOrigins.insert(result.pixmap.cacheKey(), { region.isEmpty() ? result.encodedData : QByteArray(), region });
+        return result.pixmap;
+    }
+
+    void AICompletionModel::setRegionOfInterest(const QRect& region)
+    {
+        const QRect clamped = m_sourceImage.isNull() ? region.normalized() : region.normalized().intersected(m_sourceImage.rect());
+        if (clamped == m_region)
+            return;
+
+        m_region = clamped;
+        m_imageData.clear();
+        m_rawPayload.clear();
+        m_rawPayloadSize = QSize();
+
+        emit statusChanged(m_region.isEmpty()
+            ? QString("Processing the whole image.")
+            : QString("Processing region %1x%2 at (%3, %4).").arg(m_region.width()).arg(m_region.height()).arg(m_region.x()).arg(m_region.y()));
+    }
+
+    QRect AICompletionModel::regionOfInterest() const
+    {
+        return m_region;
+    }
+
+    QRect AICompletionModel::resultRegion(const QPixmap& pixmap) const
+    {
+        return m_resultOrigins.value(pixmap.cacheKey()).region;
+    }
+
+    QRect AICompletionModel::blendRect() const
+    {
+        return RegionCompositor::blendRect(m_region, m_sourceImage.rect());
+    }
+
+    QRect AICompletionModel::uploadRect() const
+    {
+        return RegionCompositor::contextRect(m_region, m_sourceImage.rect());
+    }
+
+    QByteArray AICompletionModel::requestDigest() const
     {
-        return m_imageData;
+        if (m_region.isEmpty() || m_imageDigest.isEmpty())
+            return m_imageDigest;
+
+        QByteArray digest = m_imageDigest;
+        for (const int value : { m_region.x(), m_region.y(), m_region.width(), m_region.height() })
+        {
+            char bytes[sizeof(qint32)];
+            qToLittleEndian<qint32>(value, bytes);
+            digest.append(bytes, sizeof(bytes));
+        }
+        return digest;
     }
 
     QPixmap AICompletionModel::previewPixmap() const
@@ -124,101 +372,332 @@ namespace paint
         return m_comparisonPixmaps.value(modelKey, QPixmap());
     }
 
-    void AICompletionModel::processImage(const QString& modelKey, int postprocessValue)
+    QPixmap AICompletionModel::sweepPixmap(int iteration) const
+    {
+        return m_sweep.result(iteration);
+    }
+
+    void AICompletionModel::processImage(const QString& modelKey, int postprocessValue, RequestPriority priority)
     {
-        if (m_imageData.isEmpty())
+        if (m_sourceImage.isNull())
         {
             emit statusChanged("No image data to process.");
             emit processingFinished(false, QPixmap());
             return;
         }
 
-        if (m_currentReply && m_currentReply->isRunning())
+        const bool tiled = useTiles(modelKey);
+        const ProcessRequest request{ modelKey, postprocessValue, tiled ? tiledDigest() : requestDigest(), ++m_processSequence };
+        auto found = [this, request, tiled, priority, region = blendRect()](const std::optional<InferenceCache::Result>& cached) {
+            emit cacheStatsChanged(m_resultCache.hits(), m_resultCache.misses());
+            if (request.sequence != m_processSequence)
+                return;
+
+            if (request.imageDigest != (tiled ? tiledDigest() : requestDigest()))
+            {
+                emit statusChanged("The image or region changed while " + request.modelKey + " was loading.");
+                emit processingFinished(false, QPixmap());
+                return;
+            }
+
+            if (cached)
+            {
+                m_resultPixmap = rememberResult(*cached, region);
+                emit processingStarted();
+                emit processingFinished(true, m_resultPixmap);
+                emit statusChanged("Loaded cached result for " + request.modelKey + ".");
+                return;
+            }
+
+            if (tiled)
+                processTiled(request, priority);
+            else
+                processRemote(request, priority);
+        };
+
+        m_resultCache.lookup(request.imageDigest, modelKey, postprocessValue, this, resultDecoder(), found);
+    }
+
+    void AICompletionModel::processRemote(const ProcessRequest& request, RequestPriority priority)
+    {
+        emit processingStarted();
+        emit statusChanged("Processing with model: " + request.modelKey + ", Postprocess: " + QString::number(request.postprocessValue));
+
+        encodeUpload({ modelKey }, [this, request, priority](const QByteArray& payload) {
+            if (request.sequence != m_processSequence)
+                return;
+
+            auto start = [this, request, payload]() -> QNetworkReply* {
+                if (request.sequence <= m_cancelledProcessSequence || request.imageDigest != requestDigest())
+                    return nullptr;
+
+                QNetworkReply* reply = postImage(buildRequestUrl("process", request.modelKey, request.postprocessValue), payload);
+                m_processReplies.append(reply);
+                connect(reply, &QNetworkReply::finished, this, [this, reply, request]() { handleProcessReply(reply, request); });
+                return reply;
+            };
+
+            auto cancelled = [this, request]() {
+                if (request.sequence != m_processSequence)
+                    return;
+
+                emit statusChanged("Request for " + request.modelKey + " was cancelled.");
+                emit processingFinished(false, QPixmap());
+            };
+
+            m_scheduler->enqueue(priority, "process:" + request.modelKey, start, cancelled, this);
+        });
+    }
+
+    void AICompletionModel::cancelProcessing()
+    {
+        m_cancelledProcessSequence = ++m_processSequence;
+
+        const QList<QNetworkReply*> replies = m_processReplies;
+        for (QNetworkReply* reply : replies)
         {
-            emit statusChanged("Another process is already running.");
-            return;
+            reply->abort();
         }
+    }
 
-        emit processingStarted();
-        emit statusChanged("Processing with model: " + modelKey + ", Postprocess: " + QString::number(postprocessValue));
+    void AICompletionModel::handleProcessReply(QNetworkReply* reply, const ProcessRequest& request)
+    {
+        m_processReplies.removeOne(reply);
+        reply->deleteLater();
 
-        m_currentProcessingModelKey = modelKey;
-        m_currentPostprocessValue = postprocessValue;
+        const bool latest = request.sequence == m_processSequence;
+        if (reply->error() != QNetworkReply::NoError)
+        {
+            if (!latest)
+                return;
 
-        QNetworkRequest request(buildRequestUrl("process", modelKey, postprocessValue));
-        request.setHeader(QNetworkRequest::ContentTypeHeader, "image/png");
+            m_resultPixmap = QPixmap();
+            emit statusChanged("Processing error: " + reply->errorString());
+            emit processingFinished(false, m_resultPixmap);
+            return;
+        }
 
-        if (m_currentReply)
+        if (request.imageDigest != requestDigest())
         {
-            m_currentReply->deleteLater();
+            if (!latest)
+                return;
+
+            m_resultPixmap = QPixmap();
+            emit statusChanged("The image or region changed while " + request.modelKey + " was processing.");
+            emit processingFinished(false, m_resultPixmap);
+            return;
         }
-        m_currentReply = m_networkManager->post(request, m_imageData);
 
-        connect(m_currentReply, &QNetworkReply::finished, this, &AICompletionModel::handleNetworkReply);
-        connect(m_currentReply, &QNetworkReply::errorOccurred, this, [this](QNetworkReply::NetworkError code) {
-            if (m_currentReply && m_currentReply->error() != QNetworkReply::NoError && m_currentReply->error() != QNetworkReply::OperationCanceledError)
+        const QByteArray responseData = reply->readAll();
+        decodeInBackground(responseData, [this, request, responseData, region = blendRect()](const QPixmap& pixmap, qint64 decodeMs) {
+            if (!pixmap.isNull())
+                m_resultCache.insert(request.imageDigest, request.modelKey, request.postprocessValue, pixmap, responseData);
+
+            if (request.sequence != m_processSequence)
+                return;
+
+            m_resultPixmap = pixmap;
+            if (pixmap.isNull())
             {
-                emit statusChanged("Network error: " + m_currentReply->errorString());
-                emit processingFinished(false, QPixmap());
-                m_currentReply->deleteLater();
-                m_currentReply = nullptr;
+                emit statusChanged("Failed to parse processed image from server response.");
+                emit processingFinished(false, m_resultPixmap);
+                return;
             }
+
+            rememberResult({ pixmap, responseData }, region);
+            emit processingFinished(true, m_resultPixmap);
+            emit statusChanged(QString("Image processed successfully with %1 (decoded in %2 ms).").arg(request.modelKey).arg(decodeMs));
         });
     }
 
-    void AICompletionModel::handleNetworkReply()
+    bool AICompletionModel::useTiles(const QString& modelKey) const
+    {
+        if (!m_tiledInference || m_sourceImage.isNull())
+            return false;
+
+        const QSize uploadSize = m_region.isEmpty() ? m_sourceImage.size() : uploadRect().size();
+        const QSize tile = tileSize(modelKey);
+        return uploadSize.width() > tile.width() || uploadSize.height() > tile.height();
+    }
+
+    QSize AICompletionModel::tileSize(const QString& modelKey) const
+    {
+        const QSize inputSize = m_modelInputSizes.value(modelKey);
+        return inputSize.isEmpty() ? QSize(DEFAULT_TILE_SIZE, DEFAULT_TILE_SIZE) : inputSize;
+    }
+
+    QByteArray AICompletionModel::tiledDigest() const
+    {
+        const QByteArray digest = requestDigest();
+        return digest.isEmpty() ? digest : digest + QByteArrayLiteral(":tiled");
+    }
+
+    void AICompletionModel::processTiled(const ProcessRequest& request, RequestPriority priority)
     {
-        if (!m_currentReply) return;
+        auto run = std::make_shared<TiledRun>(TiledRun{ request, TiledInference(m_sourceImage, m_region, tileSize(request.modelKey)) });
+        run->timer.start();
 
-        bool success = false;
-        QPixmap receivedPixmap;
+        emit processingStarted();
+        emit statusChanged(QString("Processing %1 tiles with model: %2, Postprocess: %3")
+            .arg(run->inference.tileCount()).arg(request.modelKey).arg(request.postprocessValue));
 
-        if (m_currentReply->error() == QNetworkReply::NoError)
+        const QSize rawSize = rawUploadSize({ request.modelKey });
+        for (int index = 0; index < run->inference.tileCount(); ++index)
         {
-            QByteArray responseData = m_currentReply->readAll();
-            if (receivedPixmap.loadFromData(responseData, "PNG"))
+            auto payload = std::make_shared<QByteArray>();
+            auto encode = [run, index, rawSize, payload]() {
+                *payload = encodePayload(run->inference.tileImage(index), rawSize);
+            };
+
+            auto encoded = [this, run, index, payload, priority]() {
+                if (run->failed || run->request.sequence != m_processSequence)
+                    return;
+
+                auto start = [this, run, index, payload]() -> QNetworkReply* {
+                    if (run->failed || run->request.sequence != m_processSequence)
+                        return nullptr;
+
+                    QNetworkReply* reply = postImage(buildRequestUrl("process", run->request.modelKey, run->request.postprocessValue), *payload);
+                    m_processReplies.append(reply);
+                    connect(reply, &QNetworkReply::finished, this, [this, reply, run, index]() { handleTileReply(reply, run, index); });
+                    return reply;
+                };
+
+                auto cancelled = [this, run]() {
+                    failTiledRun(run, "Tiled request for " + run->request.modelKey + " was cancelled.");
+                };
+
+                m_scheduler->enqueue(priority, QString(), start, cancelled, this);
+            };
+
+            runInBackground(QStringLiteral("AI tile encode"), encode, encoded);
+        }
+    }
+
+    void AICompletionModel::handleTileReply(QNetworkReply* reply, const TiledRunPtr& run, int index)
+    {
+        m_processReplies.removeOne(reply);
+        reply->deleteLater();
+
+        if (run->failed || run->request.sequence != m_processSequence)
+            return;
+
+        if (reply->error() != QNetworkReply::NoError)
+        {
+            failTiledRun(run, "Processing error: " + reply->errorString());
+            return;
+        }
+
+        auto ok = std::make_shared<bool>(false);
+        auto decode = [run, index, ok, data = reply->readAll()]() {
+            *ok = run->inference.decodeTile(index, data);
+        };
+
+        auto decoded = [this, run, index, ok]() {
+            if (run->failed || run->request.sequence != m_processSequence)
+                return;
+
+            if (!*ok)
             {
-                m_resultPixmap = receivedPixmap;
-                success = true;
-                emit statusChanged("Image processed successfully with " + m_currentProcessingModelKey + ".");
+                failTiledRun(run, QString("Failed to parse tile %1 from server response.").arg(index + 1));
+                return;
             }
-            else
+
+            const bool done = run->inference.finishTile();
+            emit statusChanged(QString("Processed %1 of %2 tiles...").arg(run->inference.completedCount()).arg(run->inference.tileCount()));
+            if (done)
+                finishTiledRun(run);
+        };
+
+        runInBackground(QStringLiteral("AI tile decode"), decode, decoded);
+    }
+
+    void AICompletionModel::finishTiledRun(const TiledRunPtr& run)
+    {
+        auto merge = [run]() {
+            run->inference.merge();
+        };
+
+        auto merged = [this, run]() {
+            const QPixmap pixmap = QPixmap::fromImage(run->inference.merged());
+            if (!pixmap.isNull())
+                m_resultCache.insert(run->request.imageDigest, run->request.modelKey, run->request.postprocessValue, pixmap, run->inference.encodedData());
+
+            if (run->request.sequence != m_processSequence)
+                return;
+
+            if (run->request.imageDigest != tiledDigest())
             {
-                m_resultPixmap = QPixmap();
-                emit statusChanged("Failed to parse processed image from server response.");
+                failTiledRun(run, "The image or region changed while " + run->request.modelKey + " was processing.");
+                return;
             }
-        }
-        else
+
+            m_resultPixmap = pixmap;
+            if (pixmap.isNull())
+            {
+                failTiledRun(run, "Failed to merge processed tiles.");
+                return;
+            }
+
+            rememberResult({ pixmap, run->inference.encodedData() }, run->inference.resultRegion());
+            emit processingFinished(true, m_resultPixmap);
+            emit statusChanged(QString("Image processed in %1 tiles with %2 (%3 ms).")
+                .arg(run->inference.tileCount()).arg(run->request.modelKey).arg(run->timer.elapsed()));
+        };
+
+        runInBackground(QStringLiteral("AI tile merge"), merge, merged);
+    }
+
+    void AICompletionModel::failTiledRun(const TiledRunPtr& run, const QString& message)
+    {
+        if (run->failed)
+            return;
+
+        run->failed = true;
+        if (run->request.sequence != m_processSequence)
+            return;
+
+        m_resultPixmap = QPixmap();
+        emit statusChanged(message);
+        emit processingFinished(false, m_resultPixmap);
+    }
+
+    void AICompletionModel::runInBackground(const QString& label, std::function<void()> work, std::function<void()> done)
+    {
+        if (!m_taskPool)
         {
-            m_resultPixmap = QPixmap();
-            emit statusChanged("Processing error: " + m_currentReply->errorString());
+            work();
+            done();
+            return;
         }
 
-        emit processingFinished(success, m_resultPixmap);
-        m_currentReply->deleteLater();
-        m_currentReply = nullptr;
-        m_currentProcessingModelKey = "";
-        m_currentPostprocessValue = 0;
+        QPointer<AICompletionModel> self(this);
+        m_taskPool->submit(label, TaskPriority::Interactive, [self, work, done]() {
+            work();
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [self, done]() {
+                if (self)
+                    done();
+            }, Qt::QueuedConnection);
+        });
     }
 
     void AICompletionModel::compareModels(const QList<QPair<QString, int>>& modelsToCompare)
     {
-        if (m_imageData.isEmpty())
+        if (m_sourceImage.isNull())
         {
             emit statusChanged("No image data for comparison.");
             emit allComparisonsFinished();
             return;
         }
 
-        for (const auto& req : std::as_const(m_activeComparisonRequests))
+        if (m_comparisonReply)
         {
-            if (req.reply && req.reply->isRunning())
-            {
-                req.reply->abort();
-            }
-            if (req.reply) req.reply->deleteLater();
+            m_comparisonReply->disconnect(this);
+            m_comparisonReply->abort();
+            m_comparisonReply->deleteLater();
+            m_comparisonReply = nullptr;
         }
-        m_activeComparisonRequests.clear();
+        const quint64 generation = m_comparison.restart();
         m_comparisonPixmaps.clear();
 
         if (modelsToCompare.isEmpty())
@@ -232,101 +711,411 @@ namespace paint
         for (const auto& pair : modelsToCompare) modelKeysOnly << pair.first;
         emit comparisonStarted(modelKeysOnly);
 
-        m_totalComparisonRequests = modelsToCompare.size();
-
+        const QByteArray imageDigest = requestDigest();
+        const InferenceCache::Decoder decoder = resultDecoder();
+        const QRect region = blendRect();
+        auto lookups = std::make_shared<int>(static_cast<int>(modelsToCompare.size()));
         for (const auto& modelPair : modelsToCompare)
         {
             const QString& modelKey = modelPair.first;
             int postprocessValue = modelPair.second;
 
-            emit statusChanged("Starting comparison for model: " + modelKey + ", Postprocess: " + QString::number(postprocessValue));
+            auto found = [this, generation, modelKey, postprocessValue, imageDigest, lookups, region](const std::optional<InferenceCache::Result>& cached) {
+                if (generation != m_comparison.generation())
+                    return;
+
+                if (cached)
+                {
+                    m_comparisonPixmaps[modelKey] = rememberResult(*cached, region);
+                    emit comparisonFinished(modelKey, true, cached->pixmap);
+                }
+                else
+                {
+                    m_comparison.add(modelKey, postprocessValue, imageDigest);
+                }
+
+                if (--*lookups == 0)
+                    requestComparisonBatch(generation, imageDigest);
+            };
+
+            m_resultCache.lookup(imageDigest, modelKey, postprocessValue, this, decoder, found);
+        }
+    }
+
+    void AICompletionModel::requestComparisonBatch(quint64 generation, const QByteArray& imageDigest)
+    {
+        emit cacheStatsChanged(m_resultCache.hits(), m_resultCache.misses());
+
+        if (!m_comparison.hasOutstanding())
+        {
+            emit statusChanged("Loaded all comparisons from cache.");
+            emit allComparisonsFinished();
+            return;
+        }
+
+        emit statusChanged(QString("Comparing %1 models in one batch...").arg(m_comparison.outstandingCount()));
+
+        QUrl url(SERVER_BASE_URL + "compare_batch");
+        url.setQuery(m_comparison.query());
+
+        encodeUpload(m_comparison.modelKeys(), [this, url, generation, imageDigest](const QByteArray& payload) {
+            if (generation != m_comparison.generation())
+                return;
 
-            QNetworkRequest request(buildRequestUrl("compare", modelKey, postprocessValue));
-            request.setHeader(QNetworkRequest::ContentTypeHeader, "image/png");
+            auto start = [this, url, payload, generation, imageDigest]() -> QNetworkReply* {
+                if (generation != m_comparison.generation() || imageDigest != requestDigest())
+                    return nullptr;
 
-            QNetworkReply* reply = m_networkManager->post(request, m_imageData);
+                m_comparisonReply = postImage(url, payload);
+                connect(m_comparisonReply, &QNetworkReply::readyRead, this, &AICompletionModel::handleComparisonFrames);
+                connect(m_comparisonReply, &QNetworkReply::finished, this, &AICompletionModel::handleComparisonFinished);
+                return m_comparisonReply;
+            };
 
-            m_activeComparisonRequests.append({ modelKey, postprocessValue, reply });
+            auto cancelled = [this, generation]() {
+                if (generation != m_comparison.generation())
+                    return;
 
-            connect(reply, &QNetworkReply::finished, this, &AICompletionModel::handleComparisonReply);
-            connect(reply, &QNetworkReply::errorOccurred, this, [this, reply](QNetworkReply::NetworkError code) {
-                for (int i = 0; i < m_activeComparisonRequests.size(); ++i) {
-                    if (m_activeComparisonRequests[i].reply == reply)
-                    {
-                        if (reply->error() != QNetworkReply::NoError && reply->error() != QNetworkReply::OperationCanceledError)
-                        {
-                            emit statusChanged("Network error for " + m_activeComparisonRequests[i].modelKey + ": " + reply->errorString());
-                            emit comparisonFinished(m_activeComparisonRequests[i].modelKey, false, QPixmap());
-                            m_activeComparisonRequests.removeAt(i);
-                        }
-                        break;
-                    }
+                for (const auto& pending : m_comparison.takeOutstanding())
+                {
+                    emit comparisonFinished(pending.modelKey, false, QPixmap());
                 }
-                reply->deleteLater();
-                if (m_activeComparisonRequests.isEmpty() && m_totalComparisonRequests > 0)
+                finishComparisonIfIdle();
+            };
+
+            m_scheduler->enqueue(RequestPriority::Comparison, "compare", start, cancelled, this);
+        });
+    }
+
+    void AICompletionModel::handleComparisonFrames()
+    {
+        if (!m_comparisonReply) return;
+
+        m_comparison.append(m_comparisonReply->readAll());
+
+        ComparisonSession::Frame frame;
+        while (m_comparison.next(frame))
+        {
+            const ComparisonSession::Request finished = frame.request;
+            if (!frame.ok)
+            {
+                emit statusChanged("Comparison error for " + finished.modelKey + ": " + frame.error);
+                emit comparisonFinished(finished.modelKey, false, QPixmap());
+                continue;
+            }
+
+            if (finished.imageDigest != requestDigest())
+            {
+                emit comparisonFinished(finished.modelKey, false, QPixmap());
+                continue;
+            }
+
+            const quint64 generation = m_comparison.generation();
+            m_comparison.beginDecode();
+            decodeInBackground(frame.payload, [this, generation, finished, payload = frame.payload, region = blendRect()](const QPixmap& pixmap, qint64 decodeMs) {
+                if (generation != m_comparison.generation())
+                    return;
+                m_comparison.endDecode();
+
+                if (!pixmap.isNull())
                 {
-                    m_totalComparisonRequests = 0;
-                    emit allComparisonsFinished();
+                    m_comparisonPixmaps[finished.modelKey] = rememberResult({ pixmap, payload }, region);
+                    m_resultCache.insert(finished.imageDigest, finished.modelKey, finished.postprocessValue, pixmap, payload);
+                    emit statusChanged(QString("Comparison for %1 successful (decoded in %2 ms).").arg(finished.modelKey).arg(decodeMs));
                 }
+                else
+                {
+                    emit statusChanged("Failed to parse comparison image for " + finished.modelKey + ".");
+                }
+
+                emit comparisonFinished(finished.modelKey, !pixmap.isNull(), pixmap);
+                finishComparisonIfIdle();
             });
         }
     }
 
-    void AICompletionModel::handleComparisonReply()
+    void AICompletionModel::handleComparisonFinished()
     {
-        QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
-        if (!reply) return;
+        if (!m_comparisonReply) return;
 
-        QString modelKeyForResult;
-        bool foundRequest = false;
+        handleComparisonFrames();
 
-        for (int i = 0; i < m_activeComparisonRequests.size(); ++i)
+        if (m_comparisonReply->error() != QNetworkReply::NoError)
         {
-            if (m_activeComparisonRequests[i].reply == reply)
-            {
-                modelKeyForResult = m_activeComparisonRequests[i].modelKey;
-                m_activeComparisonRequests.removeAt(i);
-                foundRequest = true;
-                break;
-            }
+            emit statusChanged("Comparison error: " + m_comparisonReply->errorString());
         }
 
-        if (!foundRequest)
+        for (const auto& pending : m_comparison.takeOutstanding())
         {
-            reply->deleteLater();
+            emit comparisonFinished(pending.modelKey, false, QPixmap());
+        }
+
+        m_comparisonReply->deleteLater();
+        m_comparisonReply = nullptr;
+
+        finishComparisonIfIdle();
+    }
+
+    void AICompletionModel::finishComparisonIfIdle()
+    {
+        if (!m_comparisonReply && m_comparison.pendingDecodes() == 0)
+            emit allComparisonsFinished();
+    }
+
+    void AICompletionModel::processSweep(const QString& modelKey, int iterations)
+    {
+        if (m_sourceImage.isNull())
+        {
+            emit statusChanged("No image data to process.");
+            emit sweepFinished(false);
             return;
         }
 
-        bool success = false;
-        QPixmap receivedPixmap;
+        if (m_sweepReply)
+        {
+            m_sweepReply->disconnect(this);
+            m_sweepReply->abort();
+            m_sweepReply->deleteLater();
+            m_sweepReply = nullptr;
+        }
+
+        const quint64 generation = m_sweep.restart(modelKey, requestDigest(), iterations);
+        emit sweepStarted(m_sweep.iterations());
 
-        if (reply->error() == QNetworkReply::NoError)
+        loadCachedSweep(generation, 1, resultDecoder(), blendRect());
+    }
+
+    void AICompletionModel::loadCachedSweep(quint64 generation, int iteration, const InferenceCache::Decoder& decoder, const QRect& region)
+    {
+        if (iteration > m_sweep.iterations())
         {
-            QByteArray responseData = reply->readAll();
-            if (receivedPixmap.loadFromData(responseData, "PNG"))
+            emit cacheStatsChanged(m_resultCache.hits(), m_resultCache.misses());
+            for (int cached = 1; cached <= m_sweep.iterations(); ++cached)
+                emit sweepIterationReady(cached, m_sweep.result(cached));
+            emit statusChanged("Loaded cached sweep for " + m_sweep.modelKey() + ".");
+            emit sweepFinished(true);
+            return;
+        }
+
+        auto found = [this, generation, iteration, decoder, region](const std::optional<InferenceCache::Result>& cached) {
+            if (generation != m_sweep.generation())
+                return;
+
+            if (!cached)
             {
-                m_comparisonPixmaps[modelKeyForResult] = receivedPixmap;
-                success = true;
-                emit statusChanged("Comparison for " + modelKeyForResult + " successful.");
+                requestSweep(generation);
+                return;
             }
-            else
+
+            m_sweep.setResult(iteration, rememberResult(*cached, region));
+            loadCachedSweep(generation, iteration + 1, decoder, region);
+        };
+
+        m_resultCache.lookup(m_sweep.imageDigest(), m_sweep.modelKey(), iteration, this, decoder, found);
+    }
+
+    void AICompletionModel::requestSweep(quint64 generation)
+    {
+        emit cacheStatsChanged(m_resultCache.hits(), m_resultCache.misses());
+        m_sweep.clearResults();
+
+        const QString modelKey = m_sweep.modelKey();
+        emit statusChanged("Sweeping " + modelKey + " through " + QString::number(m_sweep.iterations()) + " postprocess iterations...");
+
+        const QUrl url = buildRequestUrl("process_sweep", modelKey, m_sweep.iterations());
+
+        encodeUpload({ modelKey }, [this, url, generation](const QByteArray& payload) {
+            if (generation != m_sweep.generation())
+                return;
+
+            auto start = [this, url, payload, generation]() -> QNetworkReply* {
+                if (generation != m_sweep.generation() || m_sweep.imageDigest() != requestDigest())
+                    return nullptr;
+
+                m_sweepReply = postImage(url, payload);
+                connect(m_sweepReply, &QNetworkReply::readyRead, this, &AICompletionModel::handleSweepFrames);
+                connect(m_sweepReply, &QNetworkReply::finished, this, &AICompletionModel::handleSweepFinished);
+                return m_sweepReply;
+            };
+
+            auto cancelled = [this, generation]() {
+                if (generation != m_sweep.generation())
+                    return;
+
+                m_sweep.fail();
+                finishSweepIfIdle();
+            };
+
+            m_scheduler->enqueue(RequestPriority::Comparison, "sweep", start, cancelled, this);
+        });
+    }
+
+    void AICompletionModel::handleSweepFrames()
+    {
+        if (!m_sweepReply) return;
+
+        m_sweep.append(m_sweepReply->readAll());
+
+        SweepSession::Frame frame;
+        while (m_sweep.next(frame))
+        {
+            if (!frame.ok)
             {
-                emit statusChanged("Failed to parse comparison image for " + modelKeyForResult + ".");
+                emit statusChanged("Sweep error for " + m_sweep.modelKey() + ": " + frame.error);
+                continue;
             }
+
+            if (m_sweep.imageDigest() != requestDigest())
+                continue;
+
+            const quint64 generation = m_sweep.generation();
+            m_sweep.beginDecode();
+            decodeInBackground(frame.payload, [this, generation, iteration = frame.iteration, payload = frame.payload, region = blendRect()](const QPixmap& pixmap, qint64 decodeMs) {
+                if (generation != m_sweep.generation())
+                    return;
+                m_sweep.endDecode();
+
+                if (pixmap.isNull())
+                {
+                    emit statusChanged("Failed to parse sweep iteration from server response.");
+                }
+                else
+                {
+                    m_sweep.setResult(iteration, rememberResult({ pixmap, payload }, region));
+                    m_resultCache.insert(m_sweep.imageDigest(), m_sweep.modelKey(), iteration, pixmap, payload);
+                    emit statusChanged(QString("Sweep iteration %1 of %2 ready (decoded in %3 ms).").arg(iteration).arg(m_sweep.iterations()).arg(decodeMs));
+                    emit sweepIterationReady(iteration, pixmap);
+                }
+                finishSweepIfIdle();
+            });
         }
-        else
+    }
+
+    void AICompletionModel::handleSweepFinished()
+    {
+        if (!m_sweepReply) return;
+
+        handleSweepFrames();
+
+        const bool failed = m_sweepReply->error() != QNetworkReply::NoError;
+        if (failed)
         {
-            emit statusChanged("Comparison error for " + modelKeyForResult + ": " + reply->errorString());
+            emit statusChanged("Sweep error: " + m_sweepReply->errorString());
         }
+        m_sweep.endStream(failed);
 
-        emit comparisonFinished(modelKeyForResult, success, receivedPixmap);
-        reply->deleteLater();
+        m_sweepReply->deleteLater();
+        m_sweepReply = nullptr;
+
+        finishSweepIfIdle();
+    }
+
+    void AICompletionModel::finishSweepIfIdle()
+    {
+        if (m_sweepReply || m_sweep.pendingDecodes() > 0)
+            return;
 
-        if (m_activeComparisonRequests.isEmpty() && m_totalComparisonRequests > 0)
+        const bool success = m_sweep.isComplete();
+        if (success)
         {
-            m_totalComparisonRequests = 0;
-            emit allComparisonsFinished();
+            emit statusChanged("Sweep finished for " + m_sweep.modelKey() + ".");
+        }
+        emit sweepFinished(success);
+    }
+
+    QSize AICompletionModel::rawUploadSize(const QStringList& modelKeys) const
+    {
+        if (!m_rawUploadSupported || modelKeys.isEmpty())
+            return QSize();
+
+        QSize inputSize;
+        for (const QString& modelKey : modelKeys)
+        {
+            const QSize size = m_modelInputSizes.value(modelKey);
+            if (size.isEmpty() || (inputSize.isValid() && size != inputSize))
+                return QSize();
+            inputSize = size;
         }
+        return inputSize;
+    }
+
+    void AICompletionModel::encodeUpload(const QStringList& modelKeys, UploadCallback ready)
+    {
+        const QSize rawSize = rawUploadSize(modelKeys);
+        if (rawSize.isEmpty() && !m_imageData.isEmpty())
+        {
+            ready(m_imageData);
+            return;
+        }
+        if (!rawSize.isEmpty() && m_rawPayloadSize == rawSize && !m_rawPayload.isEmpty())
+        {
+            ready(m_rawPayload);
+            return;
+        }
+
+        auto payload = std::make_shared<QByteArray>();
+        auto encode = [payload, source = m_sourceImage, uploadRect = uploadRect(), region = m_region, rawSize]() {
+            *payload = encodePayload(region.isEmpty() ? source : source.copy(uploadRect), rawSize);
+        };
+
+        auto encoded = [this, payload, digest = requestDigest(), rawSize, ready]() {
+            if (digest == requestDigest())
+            {
+                if (rawSize.isEmpty())
+                {
+                    m_imageData = *payload;
+                }
+                else
+                {
+                    m_rawPayload = *payload;
+                    m_rawPayloadSize = rawSize;
+                }
+            }
+            ready(*payload);
+        };
+
+        runInBackground(QStringLiteral("AI upload encode"), encode, encoded);
+    }
+
+    QByteArray AICompletionModel::encodePayload(const QImage& image, const QSize& rawSize)
+    {
+        if (!rawSize.isEmpty())
+            return GrayPayload::encode(image, rawSize);
+
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "PNG");
+        return data;
+    }
+
+    QNetworkReply* AICompletionModel::postImage(const QUrl& url, const QByteArray& payload)
+    {
+        QNetworkRequest request(url);
+        request.setHeader(QNetworkRequest::ContentTypeHeader, GrayPayload::isPayload(payload) ? QByteArray(GrayPayload::CONTENT_TYPE) : QByteArray("image/png"));
+        return m_networkManager->post(request, payload);
+    }
+
+    InferenceCache::Decoder AICompletionModel::resultDecoder() const
+    {
+        return [source = m_sourceImage, uploadRect = uploadRect(), region = m_region](const QByteArray& data) {
+            return decodeResultImage(data, source, uploadRect, region);
+        };
+    }
+
+    QImage AICompletionModel::decodeResultImage(const QByteArray& data, const QImage& source, const QRect& uploadRect, const QRect& region)
+    {
+        const bool raw = GrayPayload::isPayload(data);
+        QImage image = raw ? GrayPayload::decode(data) : QImage::fromData(data, "PNG");
+        if (image.isNull())
+            return image;
+
+        if (!region.isEmpty())
+            return RegionCompositor::stitch(source, image, uploadRect, region);
+
+        if (raw && !source.isNull() && image.size() != source.size())
+            image = image.scaled(source.size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        return image;
     }
 
     QStringList AICompletionModel::modelNames() const
@@ -339,6 +1128,16 @@ namespace paint
         return m_modelKeys;
     }
 
+    int AICompletionModel::cacheHits() const
+    {
+        return m_resultCache.hits();
+    }
+
+    int AICompletionModel::cacheMisses() const
+    {
+        return m_resultCache.misses();
+    }
+
     QUrl AICompletionModel::buildRequestUrl(const QString& endpoint, const QString& modelKey, int postprocessValue) const
     {
         QUrl url(SERVER_BASE_URL + endpoint);
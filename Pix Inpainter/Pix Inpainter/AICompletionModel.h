@@ -1,12 +1,27 @@
 #pragma once
+#include "WorkStealingPool.h"
+#include "InferenceCache.h"
+#include "RequestScheduler.h"
+#include "ComparisonSession.h"
+#include "SweepSession.h"
+#include "TiledInference.h"
+
 #include <QObject>
 #include <QPixmap>
+#include <QImage>
 #include <QByteArray>
 #include <QStringList>
 #include <QMap>
+#include <QHash>
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QPair>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QPointer>
+
+#include <functional>
+#include <memory>
 
 namespace paint
 {
@@ -15,7 +30,13 @@ namespace paint
         Q_OBJECT
 
     public:
-        explicit AICompletionModel(QObject* parent = nullptr);
+        using ImageSource = std::function<QImage()>;
+        using DecodeCallback = std::function<void(const QPixmap&, qint64)>;
+
+        static constexpr int DEFAULT_TILE_SIZE = 256;
+
+    public:
+        explicit AICompletionModel(QObject* parent = nullptr, WorkStealingPoolPtr taskPool = nullptr, RequestScheduler* scheduler = nullptr);
         ~AICompletionModel();
 
         AICompletionModel(const AICompletionModel&) = delete;
@@ -25,18 +46,36 @@ namespace paint
         AICompletionModel& operator=(AICompletionModel&&) = delete;
 
         void setImageData(const QByteArray& pngData);
-        QByteArray imageData() const;
+        void setImage(const QImage& image);
+        void setImageSource(ImageSource source);
+        void promoteResult(const QPixmap& pixmap);
+
+        void setRegionOfInterest(const QRect& region);
+        QRect regionOfInterest() const;
+        QRect resultRegion(const QPixmap& pixmap) const;
         QPixmap previewPixmap() const;
         QPixmap resultPixmap() const;
         QPixmap comparisonPixmap(const QString& modelKey) const;
+        QPixmap sweepPixmap(int iteration) const;
 
-        void processImage(const QString& modelKey, int postprocessValue);
+        void processImage(const QString& modelKey, int postprocessValue, RequestPriority priority = RequestPriority::Interactive);
+        void cancelProcessing();
         void compareModels(const QList<QPair<QString, int>>& modelsToCompare);
+        void processSweep(const QString& modelKey, int iterations);
         void reinitializeModels();
 
+        void setMaxConcurrentRequests(int maxInFlight);
+        int maxConcurrentRequests() const;
+
+        void setTiledInference(bool enabled);
+        bool tiledInference() const;
+
         QStringList modelNames() const;
         QStringList modelKeys() const;
 
+        int cacheHits() const;
+        int cacheMisses() const;
+
     signals:
         void imageDataChanged(const QPixmap& pixmap);
         void processingStarted();
@@ -44,37 +83,103 @@ namespace paint
         void comparisonStarted(const QStringList& modelKeys);
         void comparisonFinished(const QString& modelKey, bool success, const QPixmap& resultPixmap);
         void allComparisonsFinished();
+        void sweepStarted(int iterations);
+        void sweepIterationReady(int iteration, const QPixmap& resultPixmap);
+        void sweepFinished(bool success);
         void statusChanged(const QString& message);
         void modelsInitialized(const QStringList& modelNames, const QStringList& modelKeys);
+        void cacheStatsChanged(int hits, int misses);
 
     private slots:
-        void handleNetworkReply();
-        void handleComparisonReply();
+        void handleComparisonFrames();
+        void handleComparisonFinished();
+        void handleSweepFrames();
+        void handleSweepFinished();
 
     private:
+        struct ProcessRequest {
+            QString modelKey;
+            int postprocessValue;
+            QByteArray imageDigest;
+            quint64 sequence;
+        };
+
+        struct TiledRun {
+            ProcessRequest request;
+            TiledInference inference;
+            bool failed = false;
+            QElapsedTimer timer;
+        };
+        using TiledRunPtr = std::shared_ptr<TiledRun>;
+
+        struct ResultOrigin {
+            QByteArray encodedData;
+            QRect region;
+        };
+        using UploadCallback = std::function<void(const QByteArray&)>;
+
         void initializeModels();
+        void processRemote(const ProcessRequest& request, RequestPriority priority);
+        void handleProcessReply(QNetworkReply* reply, const ProcessRequest& request);
+        bool useTiles(const QString& modelKey) const;
+        QSize tileSize(const QString& modelKey) const;
+        QByteArray tiledDigest() const;
+        void processTiled(const ProcessRequest& request, RequestPriority priority);
+        void handleTileReply(QNetworkReply* reply, const TiledRunPtr& run, int index);
+        void finishTiledRun(const TiledRunPtr& run);
+        void failTiledRun(const TiledRunPtr& run, const QString& message);
+        void runInBackground(const QString& label, std::function<void()> work, std::function<void()> done);
         QUrl buildRequestUrl(const QString& endpoint, const QString& modelKey, int postprocessValue) const;
+        void prepareImage(ImageSource source, const QByteArray& encodedData, const QPixmap& preview = QPixmap());
+        void setSourceImage(const QImage& image, const QByteArray& digest, const QByteArray& encodedData, const QPixmap& preview);
+        QPixmap rememberResult(const InferenceCache::Result& result, const QRect& region);
+        void decodeInBackground(const QByteArray& data, DecodeCallback done);
+        void requestComparisonBatch(quint64 generation, const QByteArray& imageDigest);
+        void finishComparisonIfIdle();
+        void loadCachedSweep(quint64 generation, int iteration, const InferenceCache::Decoder& decoder, const QRect& region);
+        void requestSweep(quint64 generation);
+        void finishSweepIfIdle();
+        QSize rawUploadSize(const QStringList& modelKeys) const;
+        void encodeUpload(const QStringList& modelKeys, UploadCallback ready);
+        QNetworkReply* postImage(const QUrl& url, const QByteArray& payload);
+        static QByteArray encodePayload(const QImage& image, const QSize& rawSize);
+        QRect blendRect() const;
+        QRect uploadRect() const;
+        QByteArray requestDigest() const;
+        InferenceCache::Decoder resultDecoder() const;
+        static QImage decodeResultImage(const QByteArray& data, const QImage& source, const QRect& uploadRect, const QRect& region);
 
+        QImage m_sourceImage;
         QByteArray m_imageData;
+        QByteArray m_imageDigest;
+        QRect m_region;
+        QSize m_rawPayloadSize;
+        QByteArray m_rawPayload;
         QPixmap m_previewPixmap;
         QPixmap m_resultPixmap;
+        QHash<qint64, ResultOrigin> m_resultOrigins;
         QNetworkAccessManager* m_networkManager;
+        WorkStealingPoolPtr m_taskPool;
+        quint64 m_imageGeneration;
+        InferenceCache m_resultCache;
+        QPointer<RequestScheduler> m_scheduler;
 
-        QNetworkReply* m_currentReply;
-        QString m_currentProcessingModelKey;
-        int m_currentPostprocessValue;
+        QList<QNetworkReply*> m_processReplies;
+        quint64 m_processSequence;
+        quint64 m_cancelledProcessSequence;
+        bool m_tiledInference;
 
-        struct ComparisonRequest {
-            QString modelKey;
-            int postprocessValue;
-            QNetworkReply* reply;
-        };
-        QList<ComparisonRequest> m_activeComparisonRequests;
-        int m_totalComparisonRequests;
+        QNetworkReply* m_comparisonReply;
+        ComparisonSession m_comparison;
 
         QStringList m_modelNames;
         QStringList m_modelKeys;
+        QMap<QString, QSize> m_modelInputSizes;
+        bool m_rawUploadSupported;
 
         QMap<QString, QPixmap> m_comparisonPixmaps;
+
+        QNetworkReply* m_sweepReply;
+        SweepSession m_sweep;
     };
 }
@@ -17,12 +17,20 @@ namespace paint
         , m_comparisonPreviewWidget(new ZoomableImageWidget)
         , m_processButton(new QPushButton("Generate"))
         , m_compareButton(new QPushButton("Compare Models"))
+        , m_sweepButton(new QPushButton("Sweep Postprocess"))
         , m_applyResultButton(new QPushButton("Apply to Canvas"))
         , m_copyResultToPreviewButton(new QPushButton("Use as Preview"))
         , m_modelSelector(new QComboBox)
         , m_statusLabel(new QLabel)
+        , m_cacheStatsLabel(new QLabel)
+        , m_regionCheckbox(new QCheckBox("Selected Region Only"))
+        , m_tiledCheckbox(new QCheckBox("Tiled Inference"))
+        , m_concurrencySpinBox(new QSpinBox())
         , m_processPostprocessCheckbox(new QCheckBox("Use Postprocess"))
         , m_processPostprocessSpinBox(new QSpinBox())
+        , m_sweepSlider(new QSlider(Qt::Horizontal))
+        , m_sweepLabel(new QLabel)
+        , m_sweepIterations(0)
         , m_modelsListLayout(new QVBoxLayout)
         , m_compResultsLayout(new QVBoxLayout)
     {
@@ -34,6 +42,15 @@ namespace paint
         m_processPostprocessSpinBox->setValue(1);
         m_processPostprocessSpinBox->setEnabled(m_processPostprocessCheckbox->isChecked());
         connect(m_processPostprocessCheckbox, &QCheckBox::toggled, m_processPostprocessSpinBox, &QSpinBox::setEnabled);
+
+        m_sweepButton->setToolTip("Run every postprocess iteration up to the selected count in one request");
+        m_regionCheckbox->setToolTip("Drag a rectangle on the preview to send only that region and blend the result back into it");
+
+        m_concurrencySpinBox->setRange(1, MAX_CONCURRENT_REQUESTS);
+        m_concurrencySpinBox->setValue(RequestScheduler::DEFAULT_MAX_IN_FLIGHT);
+        m_concurrencySpinBox->setToolTip("Number of requests sent to the server at the same time");
+        m_tiledCheckbox->setToolTip("Split images larger than the model input into overlapping tiles and blend the results");
+        setSweepRange(0);
     }
 
     AICompletionWidget::~AICompletionWidget() = default;
@@ -46,11 +63,16 @@ namespace paint
         setupComparisonTab();
 
         mainLayout->addWidget(m_tabWidget);
-        mainLayout->addWidget(m_statusLabel);
+
+        QHBoxLayout* statusLayout = new QHBoxLayout();
+        statusLayout->addWidget(m_statusLabel, 1);
+        statusLayout->addWidget(m_cacheStatsLabel);
+        mainLayout->addLayout(statusLayout);
 
         setLayout(mainLayout);
 
         m_statusLabel->setText("Ready");
+        setCacheStats(0, 0);
         setMinimumSize(1000, 700);
         setWindowTitle("Ai Completion Tool");
     }
@@ -81,15 +103,26 @@ namespace paint
         modelAndProcessLayout->addWidget(new QLabel("Model:"));
         modelAndProcessLayout->addWidget(m_modelSelector);
         modelAndProcessLayout->addWidget(m_processButton);
+        modelAndProcessLayout->addWidget(m_regionCheckbox);
+        modelAndProcessLayout->addWidget(m_tiledCheckbox);
+        modelAndProcessLayout->addWidget(new QLabel("Parallel Requests:"));
+        modelAndProcessLayout->addWidget(m_concurrencySpinBox);
         modelAndProcessLayout->addStretch();
         groupLayout->addLayout(modelAndProcessLayout);
 
         QHBoxLayout* postprocessLayout = new QHBoxLayout();
         postprocessLayout->addWidget(m_processPostprocessCheckbox);
         postprocessLayout->addWidget(m_processPostprocessSpinBox);
+        postprocessLayout->addWidget(m_sweepButton);
         postprocessLayout->addStretch();
         groupLayout->addLayout(postprocessLayout);
 
+        QHBoxLayout* sweepLayout = new QHBoxLayout();
+        sweepLayout->addWidget(new QLabel("Iteration:"));
+        sweepLayout->addWidget(m_sweepSlider, 1);
+        sweepLayout->addWidget(m_sweepLabel);
+        groupLayout->addLayout(sweepLayout);
+
         QHBoxLayout* actionButtonsLayout = new QHBoxLayout();
         actionButtonsLayout->addWidget(m_copyResultToPreviewButton);
         actionButtonsLayout->addWidget(m_applyResultButton);
@@ -101,9 +134,15 @@ namespace paint
         m_tabWidget->addTab(processingTab, "Ai Completion");
 
         connect(m_processButton, &QPushButton::clicked, this, &AICompletionWidget::onProcessButtonClicked);
+        connect(m_sweepButton, &QPushButton::clicked, this, &AICompletionWidget::onSweepButtonClicked);
+        connect(m_sweepSlider, &QSlider::valueChanged, this, &AICompletionWidget::onSweepSliderMoved);
         connect(m_copyResultToPreviewButton, &QPushButton::clicked, this, &AICompletionWidget::onCopyResultToPreviewButtonClicked);
         connect(m_applyResultButton, &QPushButton::clicked, this, &AICompletionWidget::onApplyResultButtonClicked);
         connect(m_modelSelector, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &AICompletionWidget::modelSelectionChanged);
+        connect(m_regionCheckbox, &QCheckBox::toggled, m_previewWidget, &ZoomableImageWidget::setSelectionEnabled);
+        connect(m_previewWidget, &ZoomableImageWidget::selectionChanged, this, &AICompletionWidget::regionOfInterestChanged);
+        connect(m_concurrencySpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &AICompletionWidget::maxConcurrentRequestsChanged);
+        connect(m_tiledCheckbox, &QCheckBox::toggled, this, &AICompletionWidget::tiledInferenceToggled);
     }
 
     void AICompletionWidget::setupComparisonTab()
@@ -193,9 +232,40 @@ namespace paint
         m_statusLabel->setText(text);
     }
 
+    void AICompletionWidget::setCacheStats(int hits, int misses)
+    {
+        const int lookups = hits + misses;
+        const int ratio = lookups > 0 ? qRound(100.0 * hits / lookups) : 0;
+        m_cacheStatsLabel->setText(QString("Cache: %1 hits / %2 misses (%3%)").arg(hits).arg(misses).arg(ratio));
+    }
+
     void AICompletionWidget::setProcessButtonEnabled(bool enabled)
     {
         m_processButton->setEnabled(enabled);
+        m_sweepButton->setEnabled(enabled);
+    }
+
+    void AICompletionWidget::setSweepRange(int iterations)
+    {
+        m_sweepIterations = iterations;
+
+        QSignalBlocker blocker(m_sweepSlider);
+        m_sweepSlider->setRange(0, 0);
+        m_sweepSlider->setValue(0);
+        m_sweepSlider->setEnabled(false);
+        m_sweepLabel->setText(iterations > 0 ? QString("0 / %1").arg(iterations) : QString("-"));
+    }
+
+    void AICompletionWidget::setSweepIterationAvailable(int iteration)
+    {
+        if (iteration <= m_sweepSlider->maximum())
+            return;
+
+        const bool following = m_sweepSlider->value() == m_sweepSlider->maximum();
+        m_sweepSlider->setEnabled(true);
+        m_sweepSlider->setRange(1, iteration);
+        if (following)
+            m_sweepSlider->setValue(iteration);
     }
 
     void AICompletionWidget::setCompareButtonEnabled(bool enabled)
@@ -333,6 +403,31 @@ namespace paint
         return 0;
     }
 
+    int AICompletionWidget::getSweepIterations() const
+    {
+        return m_processPostprocessSpinBox->value();
+    }
+
+    int AICompletionWidget::getSelectedSweepIteration() const
+    {
+        return m_sweepSlider->value();
+    }
+
+    QRect AICompletionWidget::getRegionOfInterest() const
+    {
+        return m_previewWidget->selection();
+    }
+
+    bool AICompletionWidget::isTiledInferenceEnabled() const
+    {
+        return m_tiledCheckbox->isChecked();
+    }
+
+    int AICompletionWidget::getMaxConcurrentRequests() const
+    {
+        return m_concurrencySpinBox->value();
+    }
+
     QList<QPair<QString, int>> AICompletionWidget::getCompareTabSelectedModelsPostprocessValues() const
     {
         QList<QPair<QString, int>> values;
@@ -379,6 +474,20 @@ namespace paint
         emit compareModelsRequested();
     }
 
+    void AICompletionWidget::onSweepButtonClicked()
+    {
+        emit sweepRequested();
+    }
+
+    void AICompletionWidget::onSweepSliderMoved(int iteration)
+    {
+        if (iteration < 1)
+            return;
+
+        m_sweepLabel->setText(QString("%1 / %2").arg(iteration).arg(m_sweepIterations));
+        emit sweepIterationSelected(iteration);
+    }
+
     void AICompletionWidget::onApplyResultButtonClicked()
     {
         if (m_resultWidget && !m_resultWidget->pixmap().isNull())
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ZoomableImageWidget.h"
+#include "RequestScheduler.h"
 
 #include <QCloseEvent>
 #include <QPushButton>
@@ -11,6 +12,7 @@
 #include <QCheckBox>
 #include <QComboBox>
 #include <QSpinBox>
+#include <QSlider>
 #include <QWidget>
 #include <QString>
 #include <QPixmap>
@@ -23,6 +25,9 @@ namespace paint
     {
         Q_OBJECT
 
+    public:
+        static constexpr int MAX_CONCURRENT_REQUESTS = 16;
+
     public:
         AICompletionWidget(QWidget* parent = nullptr);
         ~AICompletionWidget();
@@ -38,8 +43,11 @@ namespace paint
         void displayResultImage(const QPixmap& pixmap);
         void displayComparisonImage(const QString& modelKey, const QPixmap& pixmap);
         void setStatusText(const QString& text);
+        void setCacheStats(int hits, int misses);
         void setProcessButtonEnabled(bool enabled);
         void setCompareButtonEnabled(bool enabled);
+        void setSweepRange(int iterations);
+        void setSweepIterationAvailable(int iteration);
         void resetResults();
         void populateModels(const QStringList& modelNames, const QStringList& modelKeys);
 
@@ -47,14 +55,24 @@ namespace paint
         QStringList getSelectedComparisonModelKeys() const;
 
         int getProcessTabPostprocessValue() const;
+        int getSweepIterations() const;
+        int getSelectedSweepIteration() const;
+        QRect getRegionOfInterest() const;
+        bool isTiledInferenceEnabled() const;
+        int getMaxConcurrentRequests() const;
         QList<QPair<QString, int>> getCompareTabSelectedModelsPostprocessValues() const;
 
     signals:
         void processImageRequested();
         void compareModelsRequested();
+        void sweepRequested();
+        void sweepIterationSelected(int iteration);
         void modelSelectionChanged();
         void applyResultToCanvasRequested(const QPixmap& resultImage);
         void previewImageChanged(const QPixmap& newPreviewImage);
+        void regionOfInterestChanged(const QRect& region);
+        void maxConcurrentRequestsChanged(int maxInFlight);
+        void tiledInferenceToggled(bool enabled);
 
     protected:
         void closeEvent(QCloseEvent* event) override;
@@ -62,6 +80,8 @@ namespace paint
     private slots:
         void onProcessButtonClicked();
         void onCompareButtonClicked();
+        void onSweepButtonClicked();
+        void onSweepSliderMoved(int iteration);
         void onModelCheckboxToggled();
         void onApplyResultButtonClicked();
         void onCopyResultToPreviewButtonClicked();
@@ -77,15 +97,24 @@ namespace paint
 
         QPushButton* m_processButton;
         QPushButton* m_compareButton;
+        QPushButton* m_sweepButton;
         QPushButton* m_applyResultButton;
         QPushButton* m_copyResultToPreviewButton;
 
         QComboBox* m_modelSelector;
         QLabel* m_statusLabel;
+        QLabel* m_cacheStatsLabel;
 
+        QCheckBox* m_regionCheckbox;
+        QCheckBox* m_tiledCheckbox;
+        QSpinBox* m_concurrencySpinBox;
         QCheckBox* m_processPostprocessCheckbox;
         QSpinBox* m_processPostprocessSpinBox;
 
+        QSlider* m_sweepSlider;
+        QLabel* m_sweepLabel;
+        int m_sweepIterations;
+
         QMap<QString, QCheckBox*> m_modelCheckboxes;
         QMap<QString, QCheckBox*> m_comparePostprocessCheckboxes;
         QMap<QString, QSpinBox*>  m_comparePostprocessSpinboxes;
@@ -2,8 +2,35 @@
 #include "CanvasColor.h"
 #include <QPainter>
 
+#include <algorithm>
+#include <cstring>
+#include <new>
+
 namespace paint
 {
+    namespace
+    {
+        qsizetype alignedStride(int width)
+        {
+            const qsizetype bytes = static_cast<qsizetype>(width) * sizeof(QRgb);
+            return (bytes + CanvasImage::ALIGNMENT - 1) / CanvasImage::ALIGNMENT * CanvasImage::ALIGNMENT;
+        }
+
+        std::shared_ptr<uchar> allocateAligned(qsizetype size)
+        {
+            const size_t bytes = std::max<size_t>(static_cast<size_t>(size), CanvasImage::ALIGNMENT);
+            uchar* data = static_cast<uchar*>(::operator new(bytes, std::align_val_t(CanvasImage::ALIGNMENT)));
+            return std::shared_ptr<uchar>(data, [](uchar* buffer) {
+                ::operator delete(buffer, std::align_val_t(CanvasImage::ALIGNMENT));
+            });
+        }
+
+        void releaseView(void* info)
+        {
+            delete static_cast<std::shared_ptr<uchar>*>(info);
+        }
+    }
+
     ICanvasImagePtr ICanvasImage::create(int width, int height)
     {
         return CanvasImage::create(width, height);
@@ -20,73 +47,156 @@ namespace paint
     }
 
     CanvasImage::CanvasImage(int width, int height)
-        : m_image(width, height, QImage::Format_ARGB32)
     {
-        m_image.fill(Qt::white);
+        allocate(width, height);
+        m_view.fill(Qt::white);
     }
 
     CanvasImage::CanvasImage(const QImage& image)
-        : m_image(image)
     {
-        if (m_image.format() != QImage::Format_ARGB32)
+        const QImage source = image.format() == FORMAT ? image : image.convertToFormat(FORMAT);
+        allocate(source.width(), source.height());
+
+        const qsizetype rowBytes = static_cast<qsizetype>(m_width) * sizeof(QRgb);
+        for (int y = 0; y < m_height; ++y)
         {
-            m_image = m_image.convertToFormat(QImage::Format_ARGB32);
+            std::memcpy(m_buffer.get() + y * m_stride, source.constScanLine(y), rowBytes);
         }
     }
 
+    CanvasImage::CanvasImage(const CanvasImage& other)
+        : m_width(other.m_width)
+        , m_height(other.m_height)
+        , m_stride(other.m_stride)
+        , m_buffer(other.m_buffer)
+    {
+        updateView();
+    }
+
+    CanvasImage& CanvasImage::operator=(const CanvasImage& other)
+    {
+        if (this != &other)
+        {
+            m_width = other.m_width;
+            m_height = other.m_height;
+            m_stride = other.m_stride;
+            m_buffer = other.m_buffer;
+            updateView();
+        }
+        return *this;
+    }
+
     int CanvasImage::width() const
     {
-        return m_image.width();
+        return m_width;
     }
 
     int CanvasImage::height() const
     {
-        return m_image.height();
+        return m_height;
     }
 
     ICanvasColorConstPtr CanvasImage::pixelAt(int x, int y) const
     {
-        if (m_image.rect().contains(x, y))
+        if (m_view.rect().contains(x, y))
         {
-            return CanvasColor::create(m_image.pixelColor(x, y));
+            return CanvasColor::create(m_view.pixelColor(x, y));
         }
         return nullptr;
     }
 
     void CanvasImage::setPixel(int x, int y, ICanvasColorConstPtr color)
     {
-        if (m_image.rect().contains(x, y) && color)
+        if (m_view.rect().contains(x, y) && color)
         {
+            detach();
+
             auto concreteColor = std::dynamic_pointer_cast<const CanvasColor>(color);
             if (concreteColor)
             {
-                m_image.setPixelColor(x, y, concreteColor->toQColor());
+                m_view.setPixelColor(x, y, concreteColor->toQColor());
             }
             else
             {
-                m_image.setPixelColor(x, y, QColor(color->red(), color->green(), color->blue(), color->alpha()));
+                m_view.setPixelColor(x, y, QColor(color->red(), color->green(), color->blue(), color->alpha()));
             }
         }
     }
 
     ICanvasImagePtr CanvasImage::clone() const
     {
-        return std::make_shared<CanvasImage>(m_image);
+        return std::make_shared<CanvasImage>(*this);
     }
 
     QImage CanvasImage::toQImage() const
     {
-        return m_image;
+        if (!m_buffer || m_width == 0 || m_height == 0)
+            return QImage();
+
+        return QImage(static_cast<const uchar*>(m_buffer.get()), m_width, m_height, m_stride, FORMAT,
+            releaseView, new std::shared_ptr<uchar>(m_buffer));
+    }
+
+    qsizetype CanvasImage::stride() const
+    {
+        return m_stride;
+    }
+
+    uchar* CanvasImage::bits()
+    {
+        detach();
+        return m_buffer.get();
+    }
+
+    const uchar* CanvasImage::constBits() const
+    {
+        return m_buffer.get();
     }
 
     QImage& CanvasImage::getQImage_impl()
     {
-        return m_image;
+        detach();
+        return m_view;
     }
 
     const QImage& CanvasImage::getQImage_impl() const
     {
-        return m_image;
+        return m_view;
+    }
+
+    void CanvasImage::allocate(int width, int height)
+    {
+        m_width = std::max(width, 0);
+        m_height = std::max(height, 0);
+        m_stride = alignedStride(m_width);
+        m_buffer = allocateAligned(m_stride * m_height);
+        updateView();
+    }
+
+    void CanvasImage::detach()
+    {
+        if (!m_buffer)
+            return;
+
+        // m_view holds one reference of its own; anything beyond that, or a shared copy
+        // of m_view itself, is a reader that must keep seeing the old pixels.
+        const long ownReferences = m_view.isNull() ? 1 : 2;
+        if (m_buffer.use_count() > ownReferences || !m_view.isDetached())
+        {
+            std::shared_ptr<uchar> buffer = allocateAligned(m_stride * m_height);
+            std::memcpy(buffer.get(), m_buffer.get(), static_cast<size_t>(m_stride) * m_height);
+            m_buffer = std::move(buffer);
+            updateView();
+        }
+        else if (m_view.constBits() != m_buffer.get())
+        {
+            updateView();
+        }
+    }
+
+    void CanvasImage::updateView()
+    {
+        m_view = m_buffer ? QImage(m_buffer.get(), m_width, m_height, m_stride, FORMAT, releaseView, new std::shared_ptr<uchar>(m_buffer)) : QImage();
     }
 
 }
\ No newline at end of file
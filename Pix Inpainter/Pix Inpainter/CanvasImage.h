@@ -8,13 +8,18 @@ namespace paint
 {
     class CanvasImage : public ICanvasImage
     {
+    public:
+        static constexpr QImage::Format FORMAT = QImage::Format_ARGB32_Premultiplied;
+        static constexpr QImage::Format EXPORT_FORMAT = QImage::Format_ARGB32;
+        static constexpr size_t ALIGNMENT = 64;
+
     public:
         CanvasImage(int width, int height);
         explicit CanvasImage(const QImage& image);
 
         ~CanvasImage() override = default;
-        CanvasImage(const CanvasImage&) = default;
-        CanvasImage& operator=(const CanvasImage&) = default;
+        CanvasImage(const CanvasImage& other);
+        CanvasImage& operator=(const CanvasImage& other);
         CanvasImage(CanvasImage&&) noexcept = default;
         CanvasImage& operator=(CanvasImage&&) noexcept = default;
 
@@ -26,6 +31,10 @@ namespace paint
 
         QImage toQImage() const;
 
+        qsizetype stride() const;
+        uchar* bits();
+        const uchar* constBits() const;
+
         QImage& getQImage_impl();
         const QImage& getQImage_impl() const;
 
@@ -33,6 +42,14 @@ namespace paint
         static ICanvasImagePtr create(const QImage& image);
 
     private:
-        QImage m_image;
+        void allocate(int width, int height);
+        void detach();
+        void updateView();
+
+        int m_width = 0;
+        int m_height = 0;
+        qsizetype m_stride = 0;
+        std::shared_ptr<uchar> m_buffer;
+        QImage m_view;
     };
 }
\ No newline at end of file
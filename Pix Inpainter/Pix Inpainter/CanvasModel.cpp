@@ -1,15 +1,20 @@
 #include "CanvasModel.h"
+#include "TiledCanvasImage.h"
+#include "ContentHash.h"
+
+#include <QPainter>
 
 namespace paint
 {
-    ICanvasModelPtr ICanvasModel::create(int width, int height)
+    ICanvasModelPtr ICanvasModel::create(int width, int height, WorkStealingPoolPtr taskPool)
     {
-        return std::make_shared<CanvasModel>(width, height);
+        return std::make_shared<CanvasModel>(width, height, std::move(taskPool));
     }
 
-    CanvasModel::CanvasModel(int width, int height)
-        : m_image(ICanvasImage::create(width, height))
-        , m_painter(ICanvasPainter::create(m_image))
+    CanvasModel::CanvasModel(int width, int height, WorkStealingPoolPtr taskPool)
+        : m_image(TiledCanvasImage::create(width, height))
+        , m_painter(ICanvasPainter::create(m_image, taskPool))
+        , m_taskPool(std::move(taskPool))
     {
     }
 
@@ -23,7 +28,7 @@ namespace paint
         m_image = m_undoStack.back();
         m_undoStack.pop_back();
         
-        m_painter = ICanvasPainter::create(m_image);
+        m_painter = ICanvasPainter::create(m_image, m_taskPool);
     }
 
     void CanvasModel::redo()
@@ -34,7 +39,7 @@ namespace paint
         m_image = m_redoStack.back();
         m_redoStack.pop_back();
         
-        m_painter = ICanvasPainter::create(m_image);
+        m_painter = ICanvasPainter::create(m_image, m_taskPool);
     }
     
     bool CanvasModel::canUndo() const
@@ -48,10 +53,15 @@ namespace paint
     }
 
     void CanvasModel::clear()
+    {
+        reset(width(), height());
+    }
+
+    void CanvasModel::reset(int width, int height)
     {
         saveState();
-        m_image = ICanvasImage::create(width(), height());
-        m_painter = ICanvasPainter::create(m_image);
+        m_image = TiledCanvasImage::create(width, height);
+        m_painter = ICanvasPainter::create(m_image, m_taskPool);
     }
 
     void CanvasModel::saveState()
@@ -97,23 +107,173 @@ namespace paint
         m_painter->drawEllipse(rect, pen);
     }
 
+    void CanvasModel::drawTriangle(ICanvasPointConstPtr a, ICanvasPointConstPtr b, ICanvasPointConstPtr c, ICanvasPenConstPtr pen)
+    {
+        if (!m_painter) return;
+        m_painter->drawTriangle(a, b, c, pen);
+    }
+
+    void CanvasModel::fillRect(ICanvasRectConstPtr rect, ICanvasColorConstPtr fillColor)
+    {
+        if (!m_painter) return;
+        m_painter->fillRect(rect, fillColor);
+    }
+
+    void CanvasModel::fillEllipse(ICanvasRectConstPtr rect, ICanvasColorConstPtr fillColor)
+    {
+        if (!m_painter) return;
+        m_painter->fillEllipse(rect, fillColor);
+    }
+
+    void CanvasModel::fillTriangle(ICanvasPointConstPtr a, ICanvasPointConstPtr b, ICanvasPointConstPtr c, ICanvasColorConstPtr fillColor)
+    {
+        if (!m_painter) return;
+        m_painter->fillTriangle(a, b, c, fillColor);
+    }
+
+    void CanvasModel::drawPolygon(const std::vector<ICanvasPointConstPtr>& points, ICanvasPenConstPtr pen)
+    {
+        if (!m_painter) return;
+        m_painter->drawPolygon(points, pen);
+    }
+
+    void CanvasModel::fillPolygon(const std::vector<ICanvasPointConstPtr>& points, ICanvasColorConstPtr fillColor, FillRule rule)
+    {
+        if (!m_painter) return;
+        m_painter->fillPolygon(points, fillColor, rule);
+    }
+
     void CanvasModel::fillPoint(ICanvasPointConstPtr point, ICanvasColorConstPtr fillColor)
     {
         if (!m_painter) return;
         m_painter->fillPoint(point, fillColor);
     }
 
+    void CanvasModel::drawImage(ICanvasImageConstPtr image, ICanvasPointConstPtr topLeft)
+    {
+        auto* source = dynamic_cast<const CanvasImage*>(image.get());
+        if (!m_image || !source || !topLeft) return;
+
+        const QPoint position(topLeft->x(), topLeft->y());
+        if (auto* tiledImage = dynamic_cast<TiledCanvasImage*>(m_image.get()))
+        {
+            tiledImage->writeImage(source->toQImage(), position);
+        }
+        else if (auto* concreteImage = dynamic_cast<CanvasImage*>(m_image.get()))
+        {
+            QPainter painter(&concreteImage->getQImage_impl());
+            painter.setCompositionMode(QPainter::CompositionMode_Source);
+            painter.drawImage(position, source->toQImage());
+        }
+    }
+
     ICanvasImageConstPtr CanvasModel::image() const
     {
         return m_image;
     }
 
+    ICanvasImageConstPtr CanvasModel::snapshot() const
+    {
+        return m_image ? m_image->clone() : nullptr;
+    }
+
+    quint64 CanvasModel::contentHash() const
+    {
+        if (!m_image)
+            return 0;
+
+        quint64 hash = ContentHash::combine(ContentHash::SEED, (static_cast<quint64>(width()) << 32) | static_cast<quint32>(height()));
+
+        auto* tiledImage = dynamic_cast<const TiledCanvasImage*>(m_image.get());
+        if (tiledImage)
+        {
+            updateTileHashes();
+            for (const TileHash& tile : m_tileHashes)
+                hash = ContentHash::combine(hash, tile.hash);
+            return hash;
+        }
+
+        auto* concreteImage = dynamic_cast<const CanvasImage*>(m_image.get());
+        if (concreteImage)
+        {
+            for (int y = 0; y < concreteImage->height(); ++y)
+            {
+                const QRgb* line = reinterpret_cast<const QRgb*>(concreteImage->constBits() + y * concreteImage->stride());
+                hash = ContentHash::combine(hash, ContentHash::hashRow(line, concreteImage->width()));
+            }
+        }
+        return hash;
+    }
+
+    quint64 CanvasModel::tileHash(int column, int row) const
+    {
+        updateTileHashes();
+        if (column < 0 || row < 0 || column >= m_hashColumns || row >= m_hashRows)
+            return 0;
+        return m_tileHashes[static_cast<size_t>(row) * m_hashColumns + column].hash;
+    }
+
+    void CanvasModel::updateTileHashes() const
+    {
+        auto* tiledImage = dynamic_cast<const TiledCanvasImage*>(m_image.get());
+        if (!tiledImage)
+        {
+            m_tileHashes.clear();
+            m_hashColumns = m_hashRows = 0;
+            return;
+        }
+
+        if (m_hashColumns != tiledImage->columns() || m_hashRows != tiledImage->rows())
+        {
+            m_hashColumns = tiledImage->columns();
+            m_hashRows = tiledImage->rows();
+            m_tileHashes.assign(static_cast<size_t>(m_hashColumns) * m_hashRows, TileHash());
+        }
+
+        for (int row = 0; row < m_hashRows; ++row)
+        {
+            for (int column = 0; column < m_hashColumns; ++column)
+            {
+                TileHash& cached = m_tileHashes[static_cast<size_t>(row) * m_hashColumns + column];
+                const quint64 version = tiledImage->tileVersion(column, row);
+                if (cached.version == version)
+                    continue;
+
+                const QRect bounds = tiledImage->tileRect(column, row);
+                quint64 hash = ContentHash::combine(ContentHash::SEED, (static_cast<quint64>(bounds.width()) << 32) | static_cast<quint32>(bounds.height()));
+
+                if (const CanvasImage* tile = tiledImage->tileData(column, row))
+                {
+                    for (int y = 0; y < bounds.height(); ++y)
+                    {
+                        const QRgb* line = reinterpret_cast<const QRgb*>(tile->constBits() + y * tile->stride());
+                        hash = ContentHash::combine(hash, ContentHash::hashRow(line, bounds.width()));
+                    }
+                }
+                else
+                {
+                    const std::vector<QRgb> line(bounds.width(), tiledImage->tileColor(column, row));
+                    const quint64 lineHash = ContentHash::hashRow(line.data(), bounds.width());
+                    for (int y = 0; y < bounds.height(); ++y)
+                        hash = ContentHash::combine(hash, lineHash);
+                }
+
+                cached.version = version;
+                cached.hash = hash;
+            }
+        }
+    }
+
     void CanvasModel::loadImage(ICanvasImagePtr image)
     {
         if (!image) return;
         saveState();
+        if (auto* concreteImage = dynamic_cast<const CanvasImage*>(image.get()))
+        {
+            image = TiledCanvasImage::create(concreteImage->toQImage());
+        }
         m_image = image;
-        m_painter = ICanvasPainter::create(m_image);
+        m_painter = ICanvasPainter::create(m_image, m_taskPool);
     }
 
     int CanvasModel::width() const
@@ -4,6 +4,7 @@
 #include "ICanvasPainter.h"
 
 #include <deque>
+#include <vector>
 #include <memory>
 
 namespace paint
@@ -14,7 +15,7 @@ namespace paint
         static constexpr int MAX_UNDO = 10;
 
     public:
-        explicit CanvasModel(int width, int height);
+        CanvasModel(int width, int height, WorkStealingPoolPtr taskPool = nullptr);
         ~CanvasModel() override;
 
         CanvasModel(const CanvasModel&) = delete;
@@ -29,6 +30,7 @@ namespace paint
         bool canUndo() const override;
         bool canRedo() const override;
         void clear() override;
+        void reset(int width, int height) override;
         void saveState() override;
 
         void drawPoint(ICanvasPointConstPtr point, ICanvasPenConstPtr pen) override;
@@ -36,17 +38,40 @@ namespace paint
         void drawLines(const std::vector<std::pair<ICanvasPointConstPtr, ICanvasPointConstPtr>>& lines, ICanvasPenConstPtr pen) override;
         void drawRect(ICanvasRectConstPtr rect, ICanvasPenConstPtr pen) override;
         void drawEllipse(ICanvasRectConstPtr rect, ICanvasPenConstPtr pen) override;
+        void drawTriangle(ICanvasPointConstPtr a, ICanvasPointConstPtr b, ICanvasPointConstPtr c, ICanvasPenConstPtr pen) override;
+        void fillRect(ICanvasRectConstPtr rect, ICanvasColorConstPtr fillColor) override;
+        void fillEllipse(ICanvasRectConstPtr rect, ICanvasColorConstPtr fillColor) override;
+        void fillTriangle(ICanvasPointConstPtr a, ICanvasPointConstPtr b, ICanvasPointConstPtr c, ICanvasColorConstPtr fillColor) override;
+        void drawPolygon(const std::vector<ICanvasPointConstPtr>& points, ICanvasPenConstPtr pen) override;
+        void fillPolygon(const std::vector<ICanvasPointConstPtr>& points, ICanvasColorConstPtr fillColor, FillRule rule) override;
         void fillPoint(ICanvasPointConstPtr point, ICanvasColorConstPtr fillColor) override;
+        void drawImage(ICanvasImageConstPtr image, ICanvasPointConstPtr topLeft) override;
 
         ICanvasImageConstPtr image() const override;
+        ICanvasImageConstPtr snapshot() const override;
+        quint64 contentHash() const override;
+        quint64 tileHash(int column, int row) const;
         void loadImage(ICanvasImagePtr image) override;
         int width() const override;
         int height() const override;
 
     private:
+        struct TileHash
+        {
+            quint64 version = 0;
+            quint64 hash = 0;
+        };
+
+        void updateTileHashes() const;
+
         ICanvasImagePtr m_image;
         std::deque<ICanvasImagePtr> m_undoStack;
         std::deque<ICanvasImagePtr> m_redoStack;
         ICanvasPainterUniquePtr m_painter;
+        WorkStealingPoolPtr m_taskPool;
+
+        mutable std::vector<TileHash> m_tileHashes;
+        mutable int m_hashColumns = 0;
+        mutable int m_hashRows = 0;
     };
 }
\ No newline at end of file
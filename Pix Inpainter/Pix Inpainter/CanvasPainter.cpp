@@ -1,148 +1,371 @@
 #include "CanvasPainter.h"
 
 #include <QPainter>
-#include <QStack> 
+#include <QStack>
 
-namespace paint 
+#include <algorithm>
+
+namespace paint
 {
-    ICanvasPainterUniquePtr ICanvasPainter::create(ICanvasImagePtr image)
+    namespace
+    {
+        QRect strokeBounds(const QRect& area, int penWidth)
+        {
+            const int margin = penWidth + 2;
+            return area.normalized().adjusted(-margin, -margin, margin, margin);
+        }
+
+        QRgb scalePixel(QRgb pixel, uint factor)
+        {
+            uint redBlue = (pixel & 0x00ff00ff) * factor;
+            redBlue = ((redBlue + ((redBlue >> 8) & 0x00ff00ff) + 0x00800080) >> 8) & 0x00ff00ff;
+            uint alphaGreen = ((pixel >> 8) & 0x00ff00ff) * factor;
+            alphaGreen = (alphaGreen + ((alphaGreen >> 8) & 0x00ff00ff) + 0x00800080) & 0xff00ff00;
+            return alphaGreen | redBlue;
+        }
+
+        void blendSpan(QRgb* line, int count, QRgb rawColor)
+        {
+            const uint inverseAlpha = 255 - qAlpha(rawColor);
+            if (inverseAlpha == 0)
+            {
+                std::fill_n(line, count, rawColor);
+                return;
+            }
+
+            for (int i = 0; i < count; ++i)
+            {
+                line[i] = rawColor + scalePixel(line[i], inverseAlpha);
+            }
+        }
+
+        std::vector<QPoint> touchedTiles(const TiledCanvasImage& image, const std::vector<Span>& spans)
+        {
+            std::vector<qint64> keys;
+            for (const Span& span : spans)
+            {
+                const qint64 row = span.y / TiledCanvasImage::TILE_SIZE;
+                for (int column = span.left / TiledCanvasImage::TILE_SIZE; column <= span.right / TiledCanvasImage::TILE_SIZE; ++column)
+                    keys.push_back(row * image.columns() + column);
+            }
+
+            std::sort(keys.begin(), keys.end());
+            keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+            std::vector<QPoint> tiles;
+            tiles.reserve(keys.size());
+            for (qint64 key : keys)
+                tiles.push_back(QPoint(static_cast<int>(key % image.columns()), static_cast<int>(key / image.columns())));
+            return tiles;
+        }
+
+        std::vector<QPoint> toQPoints(const std::vector<ICanvasPointConstPtr>& points)
+        {
+            std::vector<QPoint> qpoints;
+            qpoints.reserve(points.size());
+            for (const auto& point : points)
+            {
+                auto* canvasPoint = point ? dynamic_cast<const CanvasPoint*>(point.get()) : nullptr;
+                if (canvasPoint)
+                    qpoints.push_back(canvasPoint->qpoint());
+            }
+            return qpoints;
+        }
+
+        QRgb toRawColor(const ICanvasColorConstPtr& color)
+        {
+            auto concreteColor = std::dynamic_pointer_cast<const CanvasColor>(color);
+            if (concreteColor)
+                return qPremultiply(concreteColor->toQColor().rgba());
+            return qPremultiply(qRgba(color->red(), color->green(), color->blue(), color->alpha()));
+        }
+    }
+
+    std::atomic<int> CanvasPainter::s_parallelThreshold{ CanvasPainter::DEFAULT_PARALLEL_THRESHOLD };
+
+    ICanvasPainterUniquePtr ICanvasPainter::create(ICanvasImagePtr image, WorkStealingPoolPtr taskPool)
     {
-        return std::make_unique<CanvasPainter>(std::move(image));
+        return std::make_unique<CanvasPainter>(std::move(image), std::move(taskPool));
     }
 
-    CanvasPainter::CanvasPainter(ICanvasImagePtr image)
+    CanvasPainter::CanvasPainter(ICanvasImagePtr image, WorkStealingPoolPtr taskPool)
         : m_image(std::move(image))
+        , m_taskPool(std::move(taskPool))
     {
     }
 
-    CanvasImage* CanvasPainter::getConcreteImage() const 
+    CanvasImage* CanvasPainter::getConcreteImage() const
     {
         if (!m_image)
             return nullptr;
         return dynamic_cast<CanvasImage*>(m_image.get());
     }
 
+    TiledCanvasImage* CanvasPainter::getTiledImage() const
+    {
+        if (!m_image)
+            return nullptr;
+        return dynamic_cast<TiledCanvasImage*>(m_image.get());
+    }
+
+    template <typename PaintFunction>
+    void CanvasPainter::paint(const QRect& bounds, PaintFunction&& paintFunction)
+    {
+        if (TiledCanvasImage* tiledImage = getTiledImage())
+        {
+            const QRect tiles = tiledImage->tilesIntersecting(bounds);
+            const QRect area = bounds.normalized().intersected(tiledImage->rect());
+            if (isParallelWorkload(static_cast<qint64>(area.width()) * area.height(), tiles.width() * tiles.height()))
+            {
+                std::vector<std::pair<QImage*, QPoint>> targets;
+                targets.reserve(static_cast<size_t>(tiles.width()) * tiles.height());
+                for (int row = tiles.top(); row <= tiles.bottom(); ++row)
+                {
+                    for (int column = tiles.left(); column <= tiles.right(); ++column)
+                        targets.push_back({ &tiledImage->tileForWrite(column, row), tiledImage->tileRect(column, row).topLeft() });
+                }
+
+                forEachTile(static_cast<int>(targets.size()), [&](int index) {
+                    QPainter painter(targets[index].first);
+                    painter.translate(-targets[index].second);
+                    paintFunction(painter);
+                });
+            }
+            else
+            {
+                for (int row = tiles.top(); row <= tiles.bottom(); ++row)
+                {
+                    for (int column = tiles.left(); column <= tiles.right(); ++column)
+                    {
+                        const QPoint origin = tiledImage->tileRect(column, row).topLeft();
+                        QPainter painter(&tiledImage->tileForWrite(column, row));
+                        painter.translate(-origin);
+                        paintFunction(painter);
+                    }
+                }
+            }
+
+            for (int row = tiles.top(); row <= tiles.bottom(); ++row)
+            {
+                for (int column = tiles.left(); column <= tiles.right(); ++column)
+                    tiledImage->collapseIfUniform(column, row);
+            }
+            return;
+        }
+
+        if (CanvasImage* concreteImage = getConcreteImage())
+        {
+            QPainter painter(&concreteImage->getQImage_impl());
+            paintFunction(painter);
+        }
+    }
+
     void CanvasPainter::drawPoint(ICanvasPointConstPtr point, ICanvasPenConstPtr pen)
     {
-        CanvasImage* concreteImage = getConcreteImage();
-        if (!concreteImage || !point || !pen)
+        if (!m_image || !point || !pen)
             return;
 
         auto* canvasPoint = dynamic_cast<const CanvasPoint*>(point.get());
         auto* canvasPen = dynamic_cast<const CanvasPen*>(pen.get());
 
-        if (!canvasPoint || !canvasPen) 
+        if (!canvasPoint || !canvasPen)
             return;
-        
-        QPainter painter(&concreteImage->getQImage_impl());
-        painter.setPen(canvasPen->qpen());
-        painter.drawPoint(canvasPoint->qpoint());
+
+        const QPen qpenInstance = canvasPen->qpen();
+        const QPoint qpoint = canvasPoint->qpoint();
+        paint(strokeBounds(QRect(qpoint, qpoint), qpenInstance.width()), [&](QPainter& painter) {
+            painter.setPen(qpenInstance);
+            painter.drawPoint(qpoint);
+        });
     }
 
-    void CanvasPainter::drawLine(ICanvasPointConstPtr from, ICanvasPointConstPtr to, ICanvasPenConstPtr pen) 
+    void CanvasPainter::drawLine(ICanvasPointConstPtr from, ICanvasPointConstPtr to, ICanvasPenConstPtr pen)
     {
-        CanvasImage* concreteImage = getConcreteImage();
-        if (!concreteImage || !from || !to || !pen) 
+        if (!m_image || !from || !to || !pen)
             return;
 
         auto* canvasFrom = dynamic_cast<const CanvasPoint*>(from.get());
         auto* canvasTo = dynamic_cast<const CanvasPoint*>(to.get());
         auto* canvasPen = dynamic_cast<const CanvasPen*>(pen.get());
 
-        if (!canvasFrom || !canvasTo || !canvasPen) 
+        if (!canvasFrom || !canvasTo || !canvasPen)
             return;
-        
-        QPainter painter(&concreteImage->getQImage_impl());
-        painter.setPen(canvasPen->qpen());
-        painter.drawLine(canvasFrom->qpoint(), canvasTo->qpoint());
+
+        const QPen qpenInstance = canvasPen->qpen();
+        const QPoint start = canvasFrom->qpoint();
+        const QPoint end = canvasTo->qpoint();
+        paint(strokeBounds(QRect(start, end), qpenInstance.width()), [&](QPainter& painter) {
+            painter.setPen(qpenInstance);
+            painter.drawLine(start, end);
+        });
     }
 
-    void CanvasPainter::drawLines(const std::vector<std::pair<ICanvasPointConstPtr, ICanvasPointConstPtr>>& lines, ICanvasPenConstPtr pen) 
+    void CanvasPainter::drawLines(const std::vector<std::pair<ICanvasPointConstPtr, ICanvasPointConstPtr>>& lines, ICanvasPenConstPtr pen)
     {
-        CanvasImage* concreteImage = getConcreteImage();
         auto* canvasPen = pen ? dynamic_cast<const CanvasPen*>(pen.get()) : nullptr;
-        if (!concreteImage || !canvasPen || lines.empty())
+        if (!m_image || !canvasPen || lines.empty())
             return;
-        
-        QPainter painter(&concreteImage->getQImage_impl());
-        painter.setPen(canvasPen->qpen());
-        
-        for (const auto& linePair : lines) 
+
+        QVector<QLine> qlines;
+        qlines.reserve(static_cast<int>(lines.size()));
+        QRect bounds;
+
+        for (const auto& linePair : lines)
         {
             auto* startPoint = dynamic_cast<const CanvasPoint*>(linePair.first.get());
             auto* endPoint = dynamic_cast<const CanvasPoint*>(linePair.second.get());
             if (!startPoint || !endPoint)
                 continue;
-            painter.drawLine(startPoint->qpoint(), endPoint->qpoint());
+            qlines.append(QLine(startPoint->qpoint(), endPoint->qpoint()));
+            bounds |= QRect(startPoint->qpoint(), endPoint->qpoint()).normalized();
         }
+
+        const QPen qpenInstance = canvasPen->qpen();
+        paint(strokeBounds(bounds, qpenInstance.width()), [&](QPainter& painter) {
+            painter.setPen(qpenInstance);
+            painter.drawLines(qlines);
+        });
     }
 
-    void CanvasPainter::drawRect(ICanvasRectConstPtr rect, ICanvasPenConstPtr pen) 
+    void CanvasPainter::drawRect(ICanvasRectConstPtr rect, ICanvasPenConstPtr pen)
     {
-        CanvasImage* concreteImage = getConcreteImage();
         auto* canvasRect = rect ? dynamic_cast<const CanvasRect*>(rect.get()) : nullptr;
         auto* canvasPen = pen ? dynamic_cast<const CanvasPen*>(pen.get()) : nullptr;
 
-        if (!concreteImage || !canvasRect || !canvasPen) 
+        if (!m_image || !canvasRect || !canvasPen)
             return;
-        
-        QPainter painter(&concreteImage->getQImage_impl());
-        QPen qpenInstance = canvasPen->qpen();
-        qpenInstance.setJoinStyle(Qt::MiterJoin); 
-        painter.setPen(qpenInstance);
-        painter.drawRect(canvasRect->qrect());
+
+        const QRect clip(0, 0, m_image->width(), m_image->height());
+        fillSpans(ShapeRasterizer::strokeRect(canvasRect->qrect(), canvasPen->width(), clip), toRawColor(canvasPen->color()));
     }
 
     void CanvasPainter::drawEllipse(ICanvasRectConstPtr rect, ICanvasPenConstPtr pen)
     {
-        CanvasImage* concreteImage = getConcreteImage();
         auto* canvasRect = rect ? dynamic_cast<const CanvasRect*>(rect.get()) : nullptr;
         auto* canvasPen = pen ? dynamic_cast<const CanvasPen*>(pen.get()) : nullptr;
 
-        if (!concreteImage || !canvasRect || !canvasPen) 
+        if (!m_image || !canvasRect || !canvasPen)
             return;
-        
-        QPainter painter(&concreteImage->getQImage_impl());
-        painter.setPen(canvasPen->qpen());
-        painter.drawEllipse(canvasRect->qrect());
+
+        const QRect clip(0, 0, m_image->width(), m_image->height());
+        fillSpans(ShapeRasterizer::strokeEllipse(canvasRect->qrect(), canvasPen->width(), clip), toRawColor(canvasPen->color()));
     }
 
-    void CanvasPainter::fillPoint(ICanvasPointConstPtr point, ICanvasColorConstPtr fillColor)
+    void CanvasPainter::drawTriangle(ICanvasPointConstPtr a, ICanvasPointConstPtr b, ICanvasPointConstPtr c, ICanvasPenConstPtr pen)
     {
-        CanvasImage* concreteImage = getConcreteImage();
+        auto* canvasA = a ? dynamic_cast<const CanvasPoint*>(a.get()) : nullptr;
+        auto* canvasB = b ? dynamic_cast<const CanvasPoint*>(b.get()) : nullptr;
+        auto* canvasC = c ? dynamic_cast<const CanvasPoint*>(c.get()) : nullptr;
+        auto* canvasPen = pen ? dynamic_cast<const CanvasPen*>(pen.get()) : nullptr;
 
-        ICanvasColorConstPtr targetColor = (concreteImage) ? concreteImage->pixelAt(point->x(), point->y()) : nullptr;
-        
-        auto* canvasPoint = point ? dynamic_cast<const CanvasPoint*>(point.get()) : nullptr;
-        
-        if (!concreteImage || !canvasPoint || !targetColor || !fillColor) 
+        if (!m_image || !canvasA || !canvasB || !canvasC || !canvasPen)
             return;
-        
-        QImage& img = concreteImage->getQImage_impl();
 
-        QColor qtTargetColor;
-        auto concreteTargetColor = std::dynamic_pointer_cast<const CanvasColor>(targetColor);
-        if (concreteTargetColor)
-            qtTargetColor = concreteTargetColor->toQColor();
-        else 
-            qtTargetColor = QColor(targetColor->red(), targetColor->green(), targetColor->blue(), targetColor->alpha());
+        const QRect clip(0, 0, m_image->width(), m_image->height());
+        fillSpans(ShapeRasterizer::strokeTriangle(canvasA->qpoint(), canvasB->qpoint(), canvasC->qpoint(), canvasPen->width(), clip),
+            toRawColor(canvasPen->color()));
+    }
 
-        QColor qtFillColor;
-        auto concreteFillColor = std::dynamic_pointer_cast<const CanvasColor>(fillColor);
-        if (concreteFillColor) 
-            qtFillColor = concreteFillColor->toQColor();
-        else 
-            qtFillColor = QColor(fillColor->red(), fillColor->green(), fillColor->blue(), fillColor->alpha());
+    void CanvasPainter::fillRect(ICanvasRectConstPtr rect, ICanvasColorConstPtr fillColor)
+    {
+        auto* canvasRect = rect ? dynamic_cast<const CanvasRect*>(rect.get()) : nullptr;
+        if (!m_image || !canvasRect || !fillColor)
+            return;
 
+        const QRect clip(0, 0, m_image->width(), m_image->height());
+        const QRect area = canvasRect->qrect().normalized().intersected(clip);
+        const QRgb rawColor = toRawColor(fillColor);
 
-        if (qtTargetColor == qtFillColor)
+        TiledCanvasImage* tiledImage = getTiledImage();
+        if (!tiledImage || qAlpha(rawColor) != 255)
+        {
+            fillSpans(ShapeRasterizer::fillRect(area, clip), rawColor);
             return;
+        }
 
-        QPoint startQPoint = canvasPoint->qpoint();
-        if (!img.rect().contains(startQPoint) || img.pixelColor(startQPoint) != qtTargetColor)
+        const QRect tiles = tiledImage->tilesIntersecting(area);
+        for (int row = tiles.top(); row <= tiles.bottom(); ++row)
         {
-            return; 
+            for (int column = tiles.left(); column <= tiles.right(); ++column)
+            {
+                const QRect bounds = tiledImage->tileRect(column, row);
+                if (area.contains(bounds))
+                    tiledImage->fillTile(column, row, rawColor);
+                else
+                    fillSpans(ShapeRasterizer::fillRect(area, bounds), rawColor);
+            }
         }
+    }
+
+    void CanvasPainter::fillEllipse(ICanvasRectConstPtr rect, ICanvasColorConstPtr fillColor)
+    {
+        auto* canvasRect = rect ? dynamic_cast<const CanvasRect*>(rect.get()) : nullptr;
+        if (!m_image || !canvasRect || !fillColor)
+            return;
+
+        const QRect clip(0, 0, m_image->width(), m_image->height());
+        fillSpans(ShapeRasterizer::fillEllipse(canvasRect->qrect(), clip), toRawColor(fillColor));
+    }
+
+    void CanvasPainter::fillTriangle(ICanvasPointConstPtr a, ICanvasPointConstPtr b, ICanvasPointConstPtr c, ICanvasColorConstPtr fillColor)
+    {
+        auto* canvasA = a ? dynamic_cast<const CanvasPoint*>(a.get()) : nullptr;
+        auto* canvasB = b ? dynamic_cast<const CanvasPoint*>(b.get()) : nullptr;
+        auto* canvasC = c ? dynamic_cast<const CanvasPoint*>(c.get()) : nullptr;
+
+        if (!m_image || !canvasA || !canvasB || !canvasC || !fillColor)
+            return;
+
+        const QRect clip(0, 0, m_image->width(), m_image->height());
+        fillSpans(ShapeRasterizer::fillTriangle(canvasA->qpoint(), canvasB->qpoint(), canvasC->qpoint(), clip), toRawColor(fillColor));
+    }
+
+    void CanvasPainter::drawPolygon(const std::vector<ICanvasPointConstPtr>& points, ICanvasPenConstPtr pen)
+    {
+        auto* canvasPen = pen ? dynamic_cast<const CanvasPen*>(pen.get()) : nullptr;
+        if (!m_image || !canvasPen || points.empty())
+            return;
+
+        const QRect clip(0, 0, m_image->width(), m_image->height());
+        fillSpans(ShapeRasterizer::strokePolygon(toQPoints(points), canvasPen->width(), clip), toRawColor(canvasPen->color()));
+    }
+
+    void CanvasPainter::fillPolygon(const std::vector<ICanvasPointConstPtr>& points, ICanvasColorConstPtr fillColor, FillRule rule)
+    {
+        if (!m_image || !fillColor || points.size() < 3)
+            return;
+
+        const QRect clip(0, 0, m_image->width(), m_image->height());
+        fillSpans(ShapeRasterizer::fillPolygon(toQPoints(points), rule, clip), toRawColor(fillColor));
+    }
+
+    void CanvasPainter::fillPoint(ICanvasPointConstPtr point, ICanvasColorConstPtr fillColor)
+    {
+        auto* canvasPoint = point ? dynamic_cast<const CanvasPoint*>(point.get()) : nullptr;
+        if (!m_image || !canvasPoint || !fillColor)
+            return;
+
+        const QPoint startQPoint = canvasPoint->qpoint();
+        if (startQPoint.x() < 0 || startQPoint.y() < 0 || startQPoint.x() >= m_image->width() || startQPoint.y() >= m_image->height())
+            return;
+
+        const QRgb rawFill = toRawColor(fillColor);
+
+        if (TiledCanvasImage* tiledImage = getTiledImage())
+        {
+            fillTiled(*tiledImage, startQPoint, rawFill);
+            return;
+        }
+
+        CanvasImage* concreteImage = getConcreteImage();
+        if (!concreteImage)
+            return;
+
+        QImage& img = concreteImage->getQImage_impl();
+
+        const QRgb rawTarget = reinterpret_cast<const QRgb*>(img.constScanLine(startQPoint.y()))[startQPoint.x()];
+        if (rawTarget == rawFill)
+            return;
 
         QStack<QPoint> stack;
         stack.push(startQPoint);
@@ -153,13 +376,14 @@ namespace paint
         while (!stack.isEmpty())
         {
             QPoint p = stack.pop();
-            
+
             if (p.x() < 0 || p.x() >= imgWidth || p.y() < 0 || p.y() >= imgHeight)
                 continue;
-            
-            if (img.pixelColor(p) == qtTargetColor)
+
+            QRgb* row = reinterpret_cast<QRgb*>(img.scanLine(p.y()));
+            if (row[p.x()] == rawTarget)
             {
-                img.setPixelColor(p, qtFillColor);
+                row[p.x()] = rawFill;
 
                 if (p.x() + 1 < imgWidth) stack.push(QPoint(p.x() + 1, p.y()));
                 if (p.x() - 1 >= 0) stack.push(QPoint(p.x() - 1, p.y()));
@@ -168,4 +392,218 @@ namespace paint
             }
         }
     }
-}
\ No newline at end of file
+
+    void CanvasPainter::fillTiled(TiledCanvasImage& image, const QPoint& start, QRgb rawFill)
+    {
+        const QRgb rawTarget = image.rawPixel(start.x(), start.y());
+        if (rawTarget == rawFill)
+            return;
+
+        const int imgWidth = image.width();
+        const int imgHeight = image.height();
+
+        QStack<QPoint> stack;
+        stack.push(start);
+
+        std::vector<char> written(static_cast<size_t>(image.columns()) * image.rows(), 0);
+
+        auto pushRuns = [&](int left, int right, int y) {
+            if (y < 0 || y >= imgHeight)
+                return;
+            bool inRun = false;
+            for (int x = left; x <= right; ++x)
+            {
+                const bool matches = image.rawPixel(x, y) == rawTarget;
+                if (matches && !inRun)
+                    stack.push(QPoint(x, y));
+                inRun = matches;
+            }
+        };
+
+        while (!stack.isEmpty())
+        {
+            const QPoint p = stack.pop();
+            if (image.rawPixel(p.x(), p.y()) != rawTarget)
+                continue;
+
+            const int column = p.x() / TiledCanvasImage::TILE_SIZE;
+            const int row = p.y() / TiledCanvasImage::TILE_SIZE;
+            const QRect bounds = image.tileRect(column, row);
+
+            if (!image.isTileAllocated(column, row))
+            {
+                // A uniform tile of the target color is fully connected, so it is filled
+                // wholesale and the flood continues from the pixels bordering it.
+                image.fillTile(column, row, rawFill);
+                pushRuns(bounds.left(), bounds.right(), bounds.top() - 1);
+                pushRuns(bounds.left(), bounds.right(), bounds.bottom() + 1);
+                for (int y = bounds.top(); y <= bounds.bottom(); ++y)
+                {
+                    if (bounds.left() > 0 && image.rawPixel(bounds.left() - 1, y) == rawTarget)
+                        stack.push(QPoint(bounds.left() - 1, y));
+                    if (bounds.right() + 1 < imgWidth && image.rawPixel(bounds.right() + 1, y) == rawTarget)
+                        stack.push(QPoint(bounds.right() + 1, y));
+                }
+                continue;
+            }
+
+            QImage& tile = image.tileForWrite(column, row);
+            written[static_cast<size_t>(row) * image.columns() + column] = 1;
+            QRgb* line = reinterpret_cast<QRgb*>(tile.scanLine(p.y() - bounds.top()));
+            const int localX = p.x() - bounds.left();
+
+            int localLeft = localX;
+            while (localLeft > 0 && line[localLeft - 1] == rawTarget)
+                --localLeft;
+            int localRight = localX;
+            while (localRight < bounds.width() - 1 && line[localRight + 1] == rawTarget)
+                ++localRight;
+
+            std::fill(line + localLeft, line + localRight + 1, rawFill);
+
+            const int left = bounds.left() + localLeft;
+            const int right = bounds.left() + localRight;
+
+            if (left == bounds.left() && left > 0)
+                stack.push(QPoint(left - 1, p.y()));
+            if (right == bounds.right() && right + 1 < imgWidth)
+                stack.push(QPoint(right + 1, p.y()));
+
+            pushRuns(left, right, p.y() - 1);
+            pushRuns(left, right, p.y() + 1);
+        }
+
+        for (int row = 0; row < image.rows(); ++row)
+        {
+            for (int column = 0; column < image.columns(); ++column)
+            {
+                if (written[static_cast<size_t>(row) * image.columns() + column])
+                    image.collapseIfUniform(column, row);
+            }
+        }
+    }
+
+    void CanvasPainter::fillSpans(const std::vector<Span>& spans, QRgb rawColor)
+    {
+        if (TiledCanvasImage* tiledImage = getTiledImage())
+        {
+            qint64 pixels = 0;
+            for (const Span& span : spans)
+                pixels += span.right - span.left + 1;
+
+            const std::vector<QPoint> tiles = touchedTiles(*tiledImage, spans);
+            if (isParallelWorkload(pixels, static_cast<int>(tiles.size())))
+            {
+                fillSpansParallel(*tiledImage, spans, rawColor);
+            }
+            else
+            {
+                const bool opaque = qAlpha(rawColor) == 255;
+                for (const Span& span : spans)
+                {
+                    const int row = span.y / TiledCanvasImage::TILE_SIZE;
+                    for (int column = span.left / TiledCanvasImage::TILE_SIZE; column <= span.right / TiledCanvasImage::TILE_SIZE; ++column)
+                    {
+                        if (opaque && !tiledImage->isTileAllocated(column, row) && tiledImage->tileColor(column, row) == rawColor)
+                            continue;
+
+                        const QRect bounds = tiledImage->tileRect(column, row);
+                        const int left = std::max(span.left, bounds.left());
+                        const int right = std::min(span.right, bounds.right());
+
+                        QImage& tile = tiledImage->tileForWrite(column, row);
+                        QRgb* line = reinterpret_cast<QRgb*>(tile.scanLine(span.y - bounds.top()));
+                        blendSpan(line + (left - bounds.left()), right - left + 1, rawColor);
+                    }
+                }
+            }
+
+            for (const QPoint& tile : tiles)
+                tiledImage->collapseIfUniform(tile.x(), tile.y());
+            return;
+        }
+
+        if (CanvasImage* concreteImage = getConcreteImage())
+        {
+            QImage& img = concreteImage->getQImage_impl();
+            for (const Span& span : spans)
+            {
+                QRgb* line = reinterpret_cast<QRgb*>(img.scanLine(span.y));
+                blendSpan(line + span.left, span.right - span.left + 1, rawColor);
+            }
+        }
+    }
+
+    void CanvasPainter::fillSpansParallel(TiledCanvasImage& image, const std::vector<Span>& spans, QRgb rawColor)
+    {
+        struct TileTask
+        {
+            QImage* tile;
+            QRect bounds;
+            int row;
+        };
+
+        const bool opaque = qAlpha(rawColor) == 255;
+        const int columns = image.columns();
+
+        std::vector<std::vector<int>> spansByRow(image.rows());
+        std::vector<char> touched(static_cast<size_t>(columns) * image.rows(), 0);
+        for (int i = 0; i < static_cast<int>(spans.size()); ++i)
+        {
+            const Span& span = spans[i];
+            const int row = span.y / TiledCanvasImage::TILE_SIZE;
+            spansByRow[row].push_back(i);
+            for (int column = span.left / TiledCanvasImage::TILE_SIZE; column <= span.right / TiledCanvasImage::TILE_SIZE; ++column)
+                touched[static_cast<size_t>(row) * columns + column] = 1;
+        }
+
+        std::vector<TileTask> tasks;
+        for (int row = 0; row < image.rows(); ++row)
+        {
+            for (int column = 0; column < columns; ++column)
+            {
+                if (!touched[static_cast<size_t>(row) * columns + column])
+                    continue;
+                if (opaque && !image.isTileAllocated(column, row) && image.tileColor(column, row) == rawColor)
+                    continue;
+                tasks.push_back({ &image.tileForWrite(column, row), image.tileRect(column, row), row });
+            }
+        }
+
+        forEachTile(static_cast<int>(tasks.size()), [&](int index) {
+            const TileTask& task = tasks[index];
+            for (int spanIndex : spansByRow[task.row])
+            {
+                const Span& span = spans[spanIndex];
+                const int left = std::max(span.left, task.bounds.left());
+                const int right = std::min(span.right, task.bounds.right());
+                if (left > right)
+                    continue;
+
+                QRgb* line = reinterpret_cast<QRgb*>(task.tile->scanLine(span.y - task.bounds.top()));
+                blendSpan(line + (left - task.bounds.left()), right - left + 1, rawColor);
+            }
+        });
+    }
+
+    void CanvasPainter::setParallelThreshold(int pixels)
+    {
+        s_parallelThreshold.store(pixels, std::memory_order_relaxed);
+    }
+
+    int CanvasPainter::getParallelThreshold()
+    {
+        return s_parallelThreshold.load(std::memory_order_relaxed);
+    }
+
+    bool CanvasPainter::isParallelWorkload(qint64 pixels, int tileCount) const
+    {
+        const int threshold = s_parallelThreshold.load(std::memory_order_relaxed);
+        return m_taskPool && threshold >= 0 && tileCount > 1 && pixels >= threshold;
+    }
+
+    void CanvasPainter::forEachTile(int count, const std::function<void(int)>& body) const
+    {
+        m_taskPool->parallelFor(QStringLiteral("Tile rasterization"), count, body, TaskPriority::Interactive);
+    }
+}
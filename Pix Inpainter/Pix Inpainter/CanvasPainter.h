@@ -2,17 +2,26 @@
 
 #include "ICanvasPainter.h"
 #include "CanvasImage.h"
+#include "TiledCanvasImage.h"
 #include "CanvasPoint.h"
 #include "CanvasPen.h"
 #include "CanvasRect.h" 
 #include "CanvasColor.h"
+#include "ShapeRasterizer.h"
+
+#include <atomic>
+#include <functional>
+#include <vector>
 
 namespace paint
 {
     class CanvasPainter : public ICanvasPainter
     {
     public:
-        explicit CanvasPainter(ICanvasImagePtr image);
+        static constexpr int DEFAULT_PARALLEL_THRESHOLD = 4 * TiledCanvasImage::TILE_SIZE * TiledCanvasImage::TILE_SIZE;
+
+    public:
+        explicit CanvasPainter(ICanvasImagePtr image, WorkStealingPoolPtr taskPool = nullptr);
 
         CanvasPainter(const CanvasPainter&) = default;
         CanvasPainter& operator=(const CanvasPainter&) = default;
@@ -26,11 +35,34 @@ namespace paint
         void drawLines(const std::vector<std::pair<ICanvasPointConstPtr, ICanvasPointConstPtr>>& lines, ICanvasPenConstPtr pen) override;
         void drawRect(ICanvasRectConstPtr rect, ICanvasPenConstPtr pen) override;
         void drawEllipse(ICanvasRectConstPtr rect, ICanvasPenConstPtr pen) override;
+        void drawTriangle(ICanvasPointConstPtr a, ICanvasPointConstPtr b, ICanvasPointConstPtr c, ICanvasPenConstPtr pen) override;
+        void fillRect(ICanvasRectConstPtr rect, ICanvasColorConstPtr fillColor) override;
+        void fillEllipse(ICanvasRectConstPtr rect, ICanvasColorConstPtr fillColor) override;
+        void fillTriangle(ICanvasPointConstPtr a, ICanvasPointConstPtr b, ICanvasPointConstPtr c, ICanvasColorConstPtr fillColor) override;
+        void drawPolygon(const std::vector<ICanvasPointConstPtr>& points, ICanvasPenConstPtr pen) override;
+        void fillPolygon(const std::vector<ICanvasPointConstPtr>& points, ICanvasColorConstPtr fillColor, FillRule rule) override;
         void fillPoint(ICanvasPointConstPtr point, ICanvasColorConstPtr fillColor) override;
 
+        static void setParallelThreshold(int pixels);
+        static int getParallelThreshold();
+
     private:
         ICanvasImagePtr m_image;
+        WorkStealingPoolPtr m_taskPool;
 
         CanvasImage* getConcreteImage() const;
+        TiledCanvasImage* getTiledImage() const;
+
+        template <typename PaintFunction>
+        void paint(const QRect& bounds, PaintFunction&& paintFunction);
+
+        void fillTiled(TiledCanvasImage& image, const QPoint& start, QRgb rawFill);
+        void fillSpans(const std::vector<Span>& spans, QRgb rawColor);
+        void fillSpansParallel(TiledCanvasImage& image, const std::vector<Span>& spans, QRgb rawColor);
+
+        bool isParallelWorkload(qint64 pixels, int tileCount) const;
+        void forEachTile(int count, const std::function<void(int)>& body) const;
+
+        static std::atomic<int> s_parallelThreshold;
     };
 }
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "ComparisonSession.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace paint
+{
+    ComparisonSession::ComparisonSession()
+        : m_generation(0)
+        , m_pendingDecodes(0)
+    {
+    }
+
+    quint64 ComparisonSession::restart()
+    {
+        m_requests.clear();
+        m_parser.clear();
+        m_pendingDecodes = 0;
+        return ++m_generation;
+    }
+
+    quint64 ComparisonSession::generation() const
+    {
+        return m_generation;
+    }
+
+    void ComparisonSession::add(const QString& modelKey, int postprocessValue, const QByteArray& imageDigest)
+    {
+        m_requests.append({ modelKey, postprocessValue, imageDigest });
+    }
+
+    bool ComparisonSession::hasOutstanding() const
+    {
+        return !m_requests.isEmpty();
+    }
+
+    int ComparisonSession::outstandingCount() const
+    {
+        return static_cast<int>(m_requests.size());
+    }
+
+    QStringList ComparisonSession::modelKeys() const
+    {
+        QStringList keys;
+        for (const Request& request : m_requests)
+            keys << request.modelKey;
+        return keys;
+    }
+
+    QUrlQuery ComparisonSession::query() const
+    {
+        QUrlQuery query;
+        for (const Request& request : m_requests)
+            query.addQueryItem("model", request.modelKey + ":" + QString::number(std::max(request.postprocessValue, 0)));
+        return query;
+    }
+
+    void ComparisonSession::append(const QByteArray& data)
+    {
+        m_parser.append(data);
+    }
+
+    bool ComparisonSession::next(Frame& frame)
+    {
+        QJsonObject header;
+        QByteArray payload;
+        while (m_parser.next(header, payload))
+        {
+            const QString modelKey = header.value("model_id").toString();
+            const int postprocessValue = header.value("postprocess_value").toInt();
+
+            auto found = std::find_if(m_requests.begin(), m_requests.end(), [&](const Request& request) {
+                return request.modelKey == modelKey && std::max(request.postprocessValue, 0) == postprocessValue;
+            });
+            if (found == m_requests.end())
+                continue;
+
+            frame.request = *found;
+            frame.ok = header.value("ok").toBool();
+            frame.error = header.value("error").toString();
+            frame.payload = payload;
+            m_requests.erase(found);
+            return true;
+        }
+        return false;
+    }
+
+    QList<ComparisonSession::Request> ComparisonSession::takeOutstanding()
+    {
+        // The stream is over: hand back whatever it did not answer and drop any partial frame.
+        m_parser.clear();
+        return std::exchange(m_requests, {});
+    }
+
+    void ComparisonSession::beginDecode()
+    {
+        ++m_pendingDecodes;
+    }
+
+    void ComparisonSession::endDecode()
+    {
+        m_pendingDecodes = std::max(m_pendingDecodes - 1, 0);
+    }
+
+    int ComparisonSession::pendingDecodes() const
+    {
+        return m_pendingDecodes;
+    }
+}
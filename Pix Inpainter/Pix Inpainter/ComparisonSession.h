@@ -0,0 +1,63 @@
+#pragma once
+
+#include "FrameParser.h"
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QStringList>
+#include <QUrlQuery>
+
+namespace paint
+{
+    class ComparisonSession
+    {
+    public:
+        struct Request
+        {
+            QString modelKey;
+            int postprocessValue = 0;
+            QByteArray imageDigest;
+        };
+
+        struct Frame
+        {
+            Request request;
+            bool ok = false;
+            QString error;
+            QByteArray payload;
+        };
+
+    public:
+        ComparisonSession();
+        ~ComparisonSession() = default;
+
+        ComparisonSession(const ComparisonSession&) = default;
+        ComparisonSession& operator=(const ComparisonSession&) = default;
+        ComparisonSession(ComparisonSession&&) noexcept = default;
+        ComparisonSession& operator=(ComparisonSession&&) noexcept = default;
+
+        quint64 restart();
+        quint64 generation() const;
+
+        void add(const QString& modelKey, int postprocessValue, const QByteArray& imageDigest);
+        bool hasOutstanding() const;
+        int outstandingCount() const;
+        QStringList modelKeys() const;
+        QUrlQuery query() const;
+
+        void append(const QByteArray& data);
+        bool next(Frame& frame);
+        QList<Request> takeOutstanding();
+
+        void beginDecode();
+        void endDecode();
+        int pendingDecodes() const;
+
+    private:
+        QList<Request> m_requests;
+        FrameParser m_parser;
+        quint64 m_generation;
+        int m_pendingDecodes;
+    };
+}
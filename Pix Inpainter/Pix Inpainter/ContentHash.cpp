@@ -0,0 +1,83 @@
+#include "ContentHash.h"
+
+#include <cstring>
+
+namespace paint
+{
+    namespace
+    {
+        constexpr quint64 PRIME_1 = 11400714785074694791ULL;
+        constexpr quint64 PRIME_2 = 14029467366897019727ULL;
+        constexpr quint64 PRIME_3 = 1609587929392839161ULL;
+        constexpr quint64 PRIME_4 = 9650029242287828579ULL;
+        constexpr quint64 PRIME_5 = 2870177450012600261ULL;
+        constexpr int LANES = 4;
+
+        inline quint64 rotateLeft(quint64 value, int bits)
+        {
+            return (value << bits) | (value >> (64 - bits));
+        }
+
+        inline quint64 mixRound(quint64 accumulator, quint64 input)
+        {
+            accumulator += input * PRIME_2;
+            accumulator = rotateLeft(accumulator, 31);
+            return accumulator * PRIME_1;
+        }
+
+        inline quint64 mergeRound(quint64 accumulator, quint64 value)
+        {
+            accumulator ^= mixRound(0, value);
+            return accumulator * PRIME_1 + PRIME_4;
+        }
+
+        inline quint64 avalanche(quint64 hash)
+        {
+            hash ^= hash >> 33;
+            hash *= PRIME_2;
+            hash ^= hash >> 29;
+            hash *= PRIME_3;
+            hash ^= hash >> 32;
+            return hash;
+        }
+
+        inline quint64 load(const QRgb* pixels)
+        {
+            quint64 word;
+            std::memcpy(&word, pixels, sizeof(word));
+            return word;
+        }
+    }
+
+    quint64 ContentHash::hashRow(const QRgb* pixels, int count)
+    {
+        const int words = count / 2;
+        const int stripes = words / LANES;
+
+        quint64 lanes[LANES] = { ContentHash::SEED + PRIME_1 + PRIME_2, ContentHash::SEED + PRIME_2, ContentHash::SEED, ContentHash::SEED - PRIME_1 };
+        for (int stripe = 0; stripe < stripes; ++stripe)
+        {
+            const QRgb* block = pixels + stripe * LANES * 2;
+            for (int lane = 0; lane < LANES; ++lane)
+                lanes[lane] = mixRound(lanes[lane], load(block + lane * 2));
+        }
+
+        quint64 hash = rotateLeft(lanes[0], 1) + rotateLeft(lanes[1], 7) + rotateLeft(lanes[2], 12) + rotateLeft(lanes[3], 18);
+        for (int lane = 0; lane < LANES; ++lane)
+            hash = mergeRound(hash, lanes[lane]);
+        hash += static_cast<quint64>(count) * sizeof(QRgb);
+
+        for (int word = stripes * LANES; word < words; ++word)
+            hash = rotateLeft(hash ^ mixRound(0, load(pixels + word * 2)), 27) * PRIME_1 + PRIME_4;
+
+        if (count % 2)
+            hash = rotateLeft(hash ^ (static_cast<quint64>(pixels[count - 1]) * PRIME_1), 23) * PRIME_2 + PRIME_3;
+
+        return avalanche(hash);
+    }
+
+    quint64 ContentHash::combine(quint64 seed, quint64 value)
+    {
+        return avalanche(seed ^ (mixRound(PRIME_5, value) + rotateLeft(seed, 17)));
+    }
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QRgb>
+#include <QtGlobal>
+
+namespace paint
+{
+    class ContentHash
+    {
+    public:
+        static constexpr quint64 SEED = 0x9e3779b97f4a7c15ULL;
+
+    public:
+        ContentHash() = delete;
+
+        static quint64 hashRow(const QRgb* pixels, int count);
+        static quint64 combine(quint64 seed, quint64 value);
+    };
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+
 namespace paint
 {
     enum class Tool
@@ -10,7 +12,38 @@ namespace paint
         Ellipse,
         Line,
         Triangle,
+        Polygon,
+        Lasso,
         Eyedropper,
         Fill
     };
+
+    inline constexpr size_t TOOL_COUNT = static_cast<size_t>(Tool::Fill) + 1;
+
+    enum class ShapeStyle
+    {
+        Outline,
+        Filled
+    };
+
+    enum class FillRule
+    {
+        EvenOdd,
+        NonZero
+    };
+
+    enum class TaskPriority
+    {
+        Interactive,
+        Background
+    };
+
+    enum class RequestPriority
+    {
+        Interactive,
+        Comparison,
+        Speculative
+    };
+
+    inline constexpr size_t REQUEST_PRIORITY_COUNT = static_cast<size_t>(RequestPriority::Speculative) + 1;
 }
\ No newline at end of file
@@ -0,0 +1,57 @@
+#include "FrameParser.h"
+
+#include <QJsonDocument>
+#include <QtEndian>
+
+#include <cstring>
+
+namespace paint
+{
+    void FrameParser::append(const QByteArray& data)
+    {
+        m_buffer += data;
+    }
+
+    bool FrameParser::next(QJsonObject& header, QByteArray& payload)
+    {
+        if (m_buffer.size() < LENGTH_SIZE)
+            return false;
+        const qsizetype headerSize = qFromBigEndian<quint32>(m_buffer.constData());
+
+        if (m_buffer.size() < 2 * LENGTH_SIZE + headerSize)
+            return false;
+        const qsizetype payloadSize = qFromBigEndian<quint32>(m_buffer.constData() + LENGTH_SIZE + headerSize);
+
+        const qsizetype frameSize = 2 * LENGTH_SIZE + headerSize + payloadSize;
+        if (m_buffer.size() < frameSize)
+            return false;
+
+        header = QJsonDocument::fromJson(m_buffer.mid(LENGTH_SIZE, headerSize)).object();
+        payload = m_buffer.mid(2 * LENGTH_SIZE + headerSize, payloadSize);
+        m_buffer.remove(0, frameSize);
+        return true;
+    }
+
+    void FrameParser::clear()
+    {
+        m_buffer.clear();
+    }
+
+    qsizetype FrameParser::bufferedSize() const
+    {
+        return m_buffer.size();
+    }
+
+    QByteArray FrameParser::encode(const QJsonObject& header, const QByteArray& payload)
+    {
+        const QByteArray headerBytes = QJsonDocument(header).toJson(QJsonDocument::Compact);
+
+        QByteArray frame(2 * LENGTH_SIZE + headerBytes.size() + payload.size(), Qt::Uninitialized);
+        char* out = frame.data();
+        qToBigEndian<quint32>(static_cast<quint32>(headerBytes.size()), out);
+        std::memcpy(out + LENGTH_SIZE, headerBytes.constData(), headerBytes.size());
+        qToBigEndian<quint32>(static_cast<quint32>(payload.size()), out + LENGTH_SIZE + headerBytes.size());
+        std::memcpy(out + 2 * LENGTH_SIZE + headerBytes.size(), payload.constData(), payload.size());
+        return frame;
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <QByteArray>
+#include <QJsonObject>
+
+namespace paint
+{
+    // Splits the streamed compare and sweep responses into frames. Each frame is a
+    // big-endian quint32 header length, a JSON header, a quint32 payload length and the payload.
+    class FrameParser
+    {
+    public:
+        static constexpr qsizetype LENGTH_SIZE = sizeof(quint32);
+
+    public:
+        FrameParser() = default;
+        ~FrameParser() = default;
+
+        FrameParser(const FrameParser&) = default;
+        FrameParser& operator=(const FrameParser&) = default;
+        FrameParser(FrameParser&&) noexcept = default;
+        FrameParser& operator=(FrameParser&&) noexcept = default;
+
+        void append(const QByteArray& data);
+        bool next(QJsonObject& header, QByteArray& payload);
+        void clear();
+        qsizetype bufferedSize() const;
+
+        static QByteArray encode(const QJsonObject& header, const QByteArray& payload = QByteArray());
+
+    private:
+        QByteArray m_buffer;
+    };
+}
@@ -0,0 +1,65 @@
+#include "GrayPayload.h"
+
+#include <QtEndian>
+
+#include <cstring>
+
+namespace paint
+{
+    QByteArray GrayPayload::encode(const QImage& image, const QSize& size)
+    {
+        if (image.isNull() || size.isEmpty() || size.width() > 0xffff || size.height() > 0xffff)
+            return QByteArray();
+
+        const QImage gray = image.convertToFormat(QImage::Format_Grayscale8)
+            .scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+        QByteArray data(HEADER_SIZE + static_cast<qsizetype>(gray.width()) * gray.height(), Qt::Uninitialized);
+        char* out = data.data();
+        std::memcpy(out, MAGIC, MAGIC_SIZE);
+        qToBigEndian<quint16>(static_cast<quint16>(gray.width()), out + MAGIC_SIZE);
+        qToBigEndian<quint16>(static_cast<quint16>(gray.height()), out + MAGIC_SIZE + sizeof(quint16));
+
+        out += HEADER_SIZE;
+        for (int y = 0; y < gray.height(); ++y)
+        {
+            std::memcpy(out, gray.constScanLine(y), gray.width());
+            out += gray.width();
+        }
+        return data;
+    }
+
+    QImage GrayPayload::decode(const QByteArray& data)
+    {
+        if (!isPayload(data))
+            return QImage();
+
+        const int width = qFromBigEndian<quint16>(data.constData() + MAGIC_SIZE);
+        const int height = qFromBigEndian<quint16>(data.constData() + MAGIC_SIZE + sizeof(quint16));
+        if (data.size() < HEADER_SIZE + static_cast<qsizetype>(width) * height)
+            return QImage();
+
+        QImage image(width, height, QImage::Format_Grayscale8);
+        const char* in = data.constData() + HEADER_SIZE;
+        for (int y = 0; y < height; ++y)
+        {
+            std::memcpy(image.scanLine(y), in, width);
+            in += width;
+        }
+        return image;
+    }
+
+    QSize GrayPayload::size(const QByteArray& data)
+    {
+        if (!isPayload(data))
+            return QSize();
+
+        return QSize(qFromBigEndian<quint16>(data.constData() + MAGIC_SIZE),
+            qFromBigEndian<quint16>(data.constData() + MAGIC_SIZE + sizeof(quint16)));
+    }
+
+    bool GrayPayload::isPayload(const QByteArray& data)
+    {
+        return data.size() >= HEADER_SIZE && std::memcmp(data.constData(), MAGIC, MAGIC_SIZE) == 0;
+    }
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QSize>
+
+namespace paint
+{
+    class GrayPayload
+    {
+    public:
+        static constexpr char CONTENT_TYPE[] = "application/x-pix-gray";
+        static constexpr char MAGIC[] = "PXG1";
+        static constexpr int MAGIC_SIZE = 4;
+        static constexpr int HEADER_SIZE = MAGIC_SIZE + 2 * sizeof(quint16);
+
+    public:
+        GrayPayload() = delete;
+
+        static QByteArray encode(const QImage& image, const QSize& size);
+        static QImage decode(const QByteArray& data);
+        static QSize size(const QByteArray& data);
+        static bool isPayload(const QByteArray& data);
+    };
+}
@@ -5,6 +5,10 @@
 #include "ICanvasRect.h"
 #include "ICanvasImage.h"
 #include "ICanvasColor.h"
+#include "WorkStealingPool.h"
+#include "Enums.h"
+
+#include <QtGlobal>
 
 #include <memory>
 #include <vector>
@@ -25,6 +29,7 @@ namespace paint
         virtual bool canUndo() const = 0;
         virtual bool canRedo() const = 0;
         virtual void clear() = 0;
+        virtual void reset(int width, int height) = 0;
         virtual void saveState() = 0;
 
         virtual void drawPoint(ICanvasPointConstPtr point, ICanvasPenConstPtr pen) = 0;
@@ -32,13 +37,22 @@ namespace paint
         virtual void drawLines(const std::vector<std::pair<ICanvasPointConstPtr, ICanvasPointConstPtr>>& lines, ICanvasPenConstPtr pen) = 0;
         virtual void drawRect(ICanvasRectConstPtr rect, ICanvasPenConstPtr pen) = 0;
         virtual void drawEllipse(ICanvasRectConstPtr rect, ICanvasPenConstPtr pen) = 0;
+        virtual void drawTriangle(ICanvasPointConstPtr a, ICanvasPointConstPtr b, ICanvasPointConstPtr c, ICanvasPenConstPtr pen) = 0;
+        virtual void fillRect(ICanvasRectConstPtr rect, ICanvasColorConstPtr fillColor) = 0;
+        virtual void fillEllipse(ICanvasRectConstPtr rect, ICanvasColorConstPtr fillColor) = 0;
+        virtual void fillTriangle(ICanvasPointConstPtr a, ICanvasPointConstPtr b, ICanvasPointConstPtr c, ICanvasColorConstPtr fillColor) = 0;
+        virtual void drawPolygon(const std::vector<ICanvasPointConstPtr>& points, ICanvasPenConstPtr pen) = 0;
+        virtual void fillPolygon(const std::vector<ICanvasPointConstPtr>& points, ICanvasColorConstPtr fillColor, FillRule rule) = 0;
         virtual void fillPoint(ICanvasPointConstPtr point, ICanvasColorConstPtr fillColor) = 0;
+        virtual void drawImage(ICanvasImageConstPtr image, ICanvasPointConstPtr topLeft) = 0;
 
         virtual ICanvasImageConstPtr image() const = 0;
+        virtual ICanvasImageConstPtr snapshot() const = 0;
+        virtual quint64 contentHash() const = 0;
         virtual void loadImage(ICanvasImagePtr image) = 0;
         virtual int width() const = 0;
         virtual int height() const = 0;
 
-        static ICanvasModelPtr create(int width, int height);
+        static ICanvasModelPtr create(int width, int height, WorkStealingPoolPtr taskPool = nullptr);
     };
 }
\ No newline at end of file
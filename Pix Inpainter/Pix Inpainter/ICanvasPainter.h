@@ -5,6 +5,8 @@
 #include "ICanvasPen.h"
 #include "ICanvasRect.h"
 #include "ICanvasColor.h"
+#include "WorkStealingPool.h"
+#include "Enums.h"
 
 #include <memory>
 #include <vector>
@@ -24,8 +26,14 @@ namespace paint
         virtual void drawLines(const std::vector<std::pair<ICanvasPointConstPtr, ICanvasPointConstPtr>>& lines, ICanvasPenConstPtr pen) = 0;
         virtual void drawRect(ICanvasRectConstPtr rect, ICanvasPenConstPtr pen) = 0;
         virtual void drawEllipse(ICanvasRectConstPtr rect, ICanvasPenConstPtr pen) = 0;
+        virtual void drawTriangle(ICanvasPointConstPtr a, ICanvasPointConstPtr b, ICanvasPointConstPtr c, ICanvasPenConstPtr pen) = 0;
+        virtual void fillRect(ICanvasRectConstPtr rect, ICanvasColorConstPtr fillColor) = 0;
+        virtual void fillEllipse(ICanvasRectConstPtr rect, ICanvasColorConstPtr fillColor) = 0;
+        virtual void fillTriangle(ICanvasPointConstPtr a, ICanvasPointConstPtr b, ICanvasPointConstPtr c, ICanvasColorConstPtr fillColor) = 0;
+        virtual void drawPolygon(const std::vector<ICanvasPointConstPtr>& points, ICanvasPenConstPtr pen) = 0;
+        virtual void fillPolygon(const std::vector<ICanvasPointConstPtr>& points, ICanvasColorConstPtr fillColor, FillRule rule) = 0;
         virtual void fillPoint(ICanvasPointConstPtr point, ICanvasColorConstPtr fillColor) = 0;
 
-        static ICanvasPainterUniquePtr create(ICanvasImagePtr image);
+        static ICanvasPainterUniquePtr create(ICanvasImagePtr image, WorkStealingPoolPtr taskPool = nullptr);
     };
 }
\ No newline at end of file
@@ -19,5 +19,7 @@ namespace paint
         virtual void onMousePress(PaintController* controller, const QPoint& point, const QPen& pen) = 0;
         virtual void onMouseMove(PaintController* controller, const QPoint& point, const QPen& pen) = 0;
         virtual void onMouseRelease(PaintController* controller, const QPoint& point, const QPen& pen) = 0;
+        virtual void deactivate() {}
+        virtual void finish(PaintController* controller, const QPen& pen) {}
     };
 }
\ No newline at end of file
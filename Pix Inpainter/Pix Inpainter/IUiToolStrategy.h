@@ -21,5 +21,7 @@ namespace paint
         virtual void onMouseRelease(PaintWidget* widget, QMouseEvent* event) = 0;
         virtual void drawPreview(PaintWidget* widget, QPainter& painter) = 0;
         virtual void updateCursor(PaintWidget* widget) = 0;
+        virtual void deactivate(PaintWidget* widget) {}
+        virtual bool finish(PaintWidget* widget) { return false; }
     };
 }
\ No newline at end of file
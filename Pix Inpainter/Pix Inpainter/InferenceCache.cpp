@@ -0,0 +1,237 @@
+#include "InferenceCache.h"
+#include "ContentHash.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QPointer>
+#include <QSaveFile>
+#include <QtEndian>
+
+#include <algorithm>
+
+namespace paint
+{
+    InferenceCache::InferenceCache(qint64 memoryBudget, const QString& diskDirectory, WorkStealingPoolPtr taskPool)
+        : m_memoryBudget(memoryBudget)
+        , m_memoryUsage(0)
+        , m_diskDirectory(diskDirectory)
+        , m_taskPool(std::move(taskPool))
+        , m_hits(0)
+        , m_misses(0)
+    {
+        if (!m_diskDirectory.isEmpty() && !QDir().mkpath(m_diskDirectory))
+            m_diskDirectory.clear();
+    }
+
+    std::optional<InferenceCache::Result> InferenceCache::find(const QByteArray& imageDigest, const QString& modelKey, int postprocessValue)
+    {
+        std::optional<Result> found = findInMemory(buildKey(imageDigest, modelKey, postprocessValue));
+        if (found)
+            ++m_hits;
+        else
+            ++m_misses;
+        return found;
+    }
+
+    void InferenceCache::lookup(const QByteArray& imageDigest, const QString& modelKey, int postprocessValue,
+        QObject* context, Decoder decode, LookupCallback done)
+    {
+        const QByteArray key = buildKey(imageDigest, modelKey, postprocessValue);
+        if (std::optional<Result> found = findInMemory(key))
+        {
+            ++m_hits;
+            done(found);
+            return;
+        }
+
+        if (m_diskDirectory.isEmpty())
+        {
+            ++m_misses;
+            done(std::nullopt);
+            return;
+        }
+
+        auto load = [path = diskPath(key), decode]() {
+            Loaded loaded;
+            QFile file(path);
+            if (file.open(QIODevice::ReadOnly))
+            {
+                loaded.encodedData = file.readAll();
+                loaded.image = decode ? decode(loaded.encodedData) : QImage::fromData(loaded.encodedData, "PNG");
+            }
+            return loaded;
+        };
+
+        auto finish = [this, key, done](const Loaded& loaded) {
+            const QPixmap pixmap = QPixmap::fromImage(loaded.image);
+            if (pixmap.isNull())
+            {
+                ++m_misses;
+                done(std::nullopt);
+                return;
+            }
+
+            storeInMemory(key, pixmap, loaded.encodedData);
+            ++m_hits;
+            done(Result{ pixmap, loaded.encodedData });
+        };
+
+        if (!m_taskPool)
+        {
+            finish(load());
+            return;
+        }
+
+        QPointer<QObject> guard(context);
+        m_taskPool->submit(QStringLiteral("Inference cache read"), TaskPriority::Interactive, [guard, load, finish]() {
+            const Loaded loaded = load();
+            QMetaObject::invokeMethod(QCoreApplication::instance(), [guard, loaded, finish]() {
+                if (guard)
+                    finish(loaded);
+            }, Qt::QueuedConnection);
+        });
+    }
+
+    void InferenceCache::insert(const QByteArray& imageDigest, const QString& modelKey, int postprocessValue,
+        const QPixmap& pixmap, const QByteArray& encodedData)
+    {
+        if (imageDigest.isEmpty() || pixmap.isNull())
+            return;
+
+        const QByteArray key = buildKey(imageDigest, modelKey, postprocessValue);
+        storeInMemory(key, pixmap, encodedData);
+        if (!encodedData.isEmpty())
+            storeOnDisk(key, encodedData);
+    }
+
+    void InferenceCache::clear()
+    {
+        m_entries.clear();
+        m_index.clear();
+        m_memoryUsage = 0;
+
+        if (!m_diskDirectory.isEmpty())
+        {
+            QDir directory(m_diskDirectory);
+            for (const QString& name : directory.entryList({ "*.result" }, QDir::Files))
+                directory.remove(name);
+        }
+    }
+
+    int InferenceCache::hits() const
+    {
+        return m_hits;
+    }
+
+    int InferenceCache::misses() const
+    {
+        return m_misses;
+    }
+
+    qint64 InferenceCache::memoryUsage() const
+    {
+        return m_memoryUsage;
+    }
+
+    QByteArray InferenceCache::digest(const QImage& image)
+    {
+        if (image.isNull())
+            return QByteArray();
+
+        const QImage pixels = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        quint64 hash = ContentHash::combine(ContentHash::SEED, (static_cast<quint64>(pixels.width()) << 32) | static_cast<quint32>(pixels.height()));
+        for (int y = 0; y < pixels.height(); ++y)
+        {
+            const QRgb* line = reinterpret_cast<const QRgb*>(pixels.constScanLine(y));
+            hash = ContentHash::combine(hash, ContentHash::hashRow(line, pixels.width()));
+        }
+
+        QByteArray digest(sizeof(hash), Qt::Uninitialized);
+        qToLittleEndian(hash, digest.data());
+        return digest;
+    }
+
+    QByteArray InferenceCache::buildKey(const QByteArray& imageDigest, const QString& modelKey, int postprocessValue)
+    {
+        QByteArray key = imageDigest;
+        key += '\0';
+        key += modelKey.toUtf8();
+        key += '\0';
+        key += QByteArray::number(std::max(postprocessValue, 0));
+        return key;
+    }
+
+    qint64 InferenceCache::costOf(const QPixmap& pixmap, const QByteArray& encodedData)
+    {
+        return static_cast<qint64>(pixmap.width()) * pixmap.height() * std::max(pixmap.depth(), 8) / 8 + encodedData.size();
+    }
+
+    QString InferenceCache::diskPath(const QByteArray& key) const
+    {
+        const QByteArray name = QCryptographicHash::hash(key, QCryptographicHash::Sha256).toHex();
+        return QDir(m_diskDirectory).filePath(QString::fromLatin1(name) + ".result");
+    }
+
+    std::optional<InferenceCache::Result> InferenceCache::findInMemory(const QByteArray& key)
+    {
+        auto found = m_index.find(key);
+        if (found == m_index.end())
+            return std::nullopt;
+
+        m_entries.splice(m_entries.begin(), m_entries, found.value());
+        return Result{ m_entries.front().pixmap, m_entries.front().encodedData };
+    }
+
+    void InferenceCache::storeInMemory(const QByteArray& key, const QPixmap& pixmap, const QByteArray& encodedData)
+    {
+        const qint64 cost = costOf(pixmap, encodedData);
+        if (cost > m_memoryBudget)
+            return;
+
+        auto found = m_index.find(key);
+        if (found != m_index.end())
+        {
+            m_memoryUsage -= found.value()->cost;
+            m_entries.erase(found.value());
+            m_index.erase(found);
+        }
+
+        m_entries.push_front({ key, pixmap, encodedData, cost });
+        m_index.insert(key, m_entries.begin());
+        m_memoryUsage += cost;
+        evict();
+    }
+
+    void InferenceCache::storeOnDisk(const QByteArray& key, const QByteArray& encodedData)
+    {
+        if (m_diskDirectory.isEmpty())
+            return;
+
+        auto write = [path = diskPath(key), encodedData]() {
+            QSaveFile file(path);
+            if (file.open(QIODevice::WriteOnly))
+            {
+                file.write(encodedData);
+                file.commit();
+            }
+        };
+
+        if (m_taskPool)
+            m_taskPool->submit(QStringLiteral("Inference cache write"), TaskPriority::Background, write);
+        else
+            write();
+    }
+
+    void InferenceCache::evict()
+    {
+        while (m_memoryUsage > m_memoryBudget && !m_entries.empty())
+        {
+            const Entry& oldest = m_entries.back();
+            m_memoryUsage -= oldest.cost;
+            m_index.remove(oldest.key);
+            m_entries.pop_back();
+        }
+    }
+}
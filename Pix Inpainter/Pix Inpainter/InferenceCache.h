@@ -0,0 +1,93 @@
+#pragma once
+
+#include "WorkStealingPool.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QImage>
+#include <QObject>
+#include <QPixmap>
+#include <QString>
+
+#include <functional>
+#include <list>
+#include <optional>
+
+namespace paint
+{
+    class InferenceCache
+    {
+    public:
+        using Decoder = std::function<QImage(const QByteArray&)>;
+
+        static constexpr qint64 DEFAULT_MEMORY_BUDGET = 256LL * 1024 * 1024;
+
+        struct Result
+        {
+            QPixmap pixmap;
+            QByteArray encodedData;
+        };
+
+        using LookupCallback = std::function<void(const std::optional<Result>&)>;
+
+    public:
+        explicit InferenceCache(qint64 memoryBudget = DEFAULT_MEMORY_BUDGET, const QString& diskDirectory = QString(),
+            WorkStealingPoolPtr taskPool = nullptr);
+        ~InferenceCache() = default;
+
+        InferenceCache(const InferenceCache&) = delete;
+        InferenceCache& operator=(const InferenceCache&) = delete;
+        InferenceCache(InferenceCache&&) = delete;
+        InferenceCache& operator=(InferenceCache&&) = delete;
+
+        std::optional<Result> find(const QByteArray& imageDigest, const QString& modelKey, int postprocessValue);
+        // Memory hits complete immediately; disk hits are read and decoded on the task pool and
+        // complete on the GUI thread, provided context (which must own the cache) is still alive.
+        void lookup(const QByteArray& imageDigest, const QString& modelKey, int postprocessValue,
+            QObject* context, Decoder decode, LookupCallback done);
+        void insert(const QByteArray& imageDigest, const QString& modelKey, int postprocessValue,
+            const QPixmap& pixmap, const QByteArray& encodedData);
+        void clear();
+
+        int hits() const;
+        int misses() const;
+        qint64 memoryUsage() const;
+
+        static QByteArray digest(const QImage& image);
+
+    private:
+        struct Entry
+        {
+            QByteArray key;
+            QPixmap pixmap;
+            QByteArray encodedData;
+            qint64 cost;
+        };
+
+        struct Loaded
+        {
+            QImage image;
+            QByteArray encodedData;
+        };
+
+        static QByteArray buildKey(const QByteArray& imageDigest, const QString& modelKey, int postprocessValue);
+        static qint64 costOf(const QPixmap& pixmap, const QByteArray& encodedData);
+
+        QString diskPath(const QByteArray& key) const;
+        std::optional<Result> findInMemory(const QByteArray& key);
+        void storeInMemory(const QByteArray& key, const QPixmap& pixmap, const QByteArray& encodedData);
+        void storeOnDisk(const QByteArray& key, const QByteArray& encodedData);
+        void evict();
+
+        qint64 m_memoryBudget;
+        qint64 m_memoryUsage;
+        QString m_diskDirectory;
+        WorkStealingPoolPtr m_taskPool;
+
+        std::list<Entry> m_entries;
+        QHash<QByteArray, std::list<Entry>::iterator> m_index;
+
+        int m_hits;
+        int m_misses;
+    };
+}
@@ -0,0 +1,78 @@
+#include "InkPredictor.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace paint
+{
+    void InkPredictor::reset()
+    {
+        m_history.clear();
+    }
+
+    void InkPredictor::addSample(const QPointF& point, qint64 timestampNs)
+    {
+        const qreal timeMs = timestampNs / 1.0e6;
+        if (!m_history.isEmpty() && timeMs <= m_history.last().timeMs)
+        {
+            m_history.last().point = point;
+            return;
+        }
+
+        m_history.append({ point, timeMs });
+        if (m_history.size() > HISTORY_SIZE)
+            m_history.removeFirst();
+    }
+
+    QVector<QPointF> InkPredictor::predict(qreal horizonMs) const
+    {
+        QVector<QPointF> predicted;
+        if (m_history.size() < 2 || horizonMs <= 0.0)
+            return predicted;
+
+        qreal meanTime = 0.0;
+        QPointF meanPoint;
+        for (const Sample& sample : m_history)
+        {
+            meanTime += sample.timeMs;
+            meanPoint += sample.point;
+        }
+        meanTime /= m_history.size();
+        meanPoint /= m_history.size();
+
+        qreal timeVariance = 0.0;
+        QPointF covariance;
+        for (const Sample& sample : m_history)
+        {
+            const qreal dt = sample.timeMs - meanTime;
+            timeVariance += dt * dt;
+            covariance += (sample.point - meanPoint) * dt;
+        }
+        if (timeVariance <= 0.0)
+            return predicted;
+
+        const QPointF velocity = covariance / timeVariance;
+        const qreal speed = std::hypot(velocity.x(), velocity.y());
+        if (speed < MIN_SPEED)
+            return predicted;
+
+        const qreal horizon = std::min({ horizonMs, MAX_HORIZON_MS, MAX_DISTANCE / speed });
+        const QPointF origin = m_history.last().point;
+        predicted.reserve(PREDICTED_POINTS);
+        for (int i = 1; i <= PREDICTED_POINTS; ++i)
+        {
+            predicted.append(origin + velocity * (horizon * i / PREDICTED_POINTS));
+        }
+        return predicted;
+    }
+
+    bool InkPredictor::isEmpty() const
+    {
+        return m_history.isEmpty();
+    }
+
+    QPointF InkPredictor::lastPoint() const
+    {
+        return m_history.isEmpty() ? QPointF() : m_history.last().point;
+    }
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <QPointF>
+#include <QVector>
+
+namespace paint
+{
+    class InkPredictor
+    {
+    public:
+        static constexpr int HISTORY_SIZE = 5;
+        static constexpr int PREDICTED_POINTS = 3;
+        static constexpr qreal MAX_HORIZON_MS = 32.0;
+        static constexpr qreal MAX_DISTANCE = 48.0;
+        static constexpr qreal MIN_SPEED = 0.01;
+
+    public:
+        InkPredictor() = default;
+        ~InkPredictor() = default;
+        InkPredictor(const InkPredictor&) = default;
+        InkPredictor& operator=(const InkPredictor&) = default;
+        InkPredictor(InkPredictor&&) = default;
+        InkPredictor& operator=(InkPredictor&&) = default;
+
+        void reset();
+        void addSample(const QPointF& point, qint64 timestampNs);
+        QVector<QPointF> predict(qreal horizonMs) const;
+
+        bool isEmpty() const;
+        QPointF lastPoint() const;
+
+    private:
+        struct Sample
+        {
+            QPointF point;
+            qreal timeMs;
+        };
+
+        QVector<Sample> m_history;
+    };
+}
@@ -0,0 +1,185 @@
+#include "LiveCompletionController.h"
+
+#include <algorithm>
+
+namespace paint
+{
+    LiveCompletionController::LiveCompletionController(QObject* parent, PaintWidget* paintWidget, PaintController* paintController,
+        WorkStealingPoolPtr taskPool, RequestScheduler* scheduler)
+        : QObject(parent)
+        , m_paintWidget(paintWidget)
+        , m_paintController(paintController)
+        , m_taskPool(std::move(taskPool))
+        , m_scheduler(scheduler)
+        , m_model(nullptr)
+        , m_debounceTimer(new QTimer(this))
+        , m_enabled(false)
+        , m_drawing(false)
+        , m_awaitingImage(false)
+        , m_postprocessValue(0)
+        , m_pendingHash(0)
+        , m_overlayHash(0)
+    {
+        m_debounceTimer->setSingleShot(true);
+        m_debounceTimer->setInterval(DEFAULT_DEBOUNCE_MS);
+        connect(m_debounceTimer, &QTimer::timeout, this, &LiveCompletionController::onDebounceElapsed);
+
+        connect(m_paintWidget, &PaintWidget::strokeStarted, this, &LiveCompletionController::onStrokeStarted);
+        connect(m_paintWidget, &PaintWidget::strokeFinished, this, &LiveCompletionController::onStrokeFinished);
+        connect(m_paintController, &PaintController::canvasChanged, this, &LiveCompletionController::onCanvasChanged);
+    }
+
+    void LiveCompletionController::setEnabled(bool enabled)
+    {
+        if (m_enabled == enabled)
+            return;
+
+        m_enabled = enabled;
+        if (!m_enabled)
+        {
+            cancelPending();
+            m_overlayHash = 0;
+            m_overlay = QPixmap();
+            m_paintWidget->clearCompletionOverlay();
+            return;
+        }
+
+        if (!m_model)
+        {
+            m_model = new AICompletionModel(this, m_taskPool, m_scheduler);
+            connect(m_model, &AICompletionModel::imageDataChanged, this, &LiveCompletionController::onImagePrepared);
+            connect(m_model, &AICompletionModel::processingFinished, this, &LiveCompletionController::onProcessingFinished);
+        }
+        m_debounceTimer->start();
+    }
+
+    bool LiveCompletionController::isEnabled() const
+    {
+        return m_enabled;
+    }
+
+    void LiveCompletionController::setDebounceInterval(int milliseconds)
+    {
+        m_debounceTimer->setInterval(std::clamp(milliseconds, MIN_DEBOUNCE_MS, MAX_DEBOUNCE_MS));
+    }
+
+    int LiveCompletionController::debounceInterval() const
+    {
+        return m_debounceTimer->interval();
+    }
+
+    void LiveCompletionController::setModel(const QString& modelKey, int postprocessValue)
+    {
+        if (m_modelKey == modelKey && m_postprocessValue == postprocessValue)
+            return;
+
+        m_modelKey = modelKey;
+        m_postprocessValue = postprocessValue;
+        if (!m_enabled)
+            return;
+
+        cancelPending();
+        m_overlayHash = 0;
+        m_overlay = QPixmap();
+        m_paintWidget->clearCompletionOverlay();
+        if (!m_drawing)
+            m_debounceTimer->start();
+    }
+
+    void LiveCompletionController::onStrokeStarted()
+    {
+        m_drawing = true;
+        if (!m_enabled)
+            return;
+
+        cancelPending();
+        m_paintWidget->clearCompletionOverlay();
+    }
+
+    void LiveCompletionController::onStrokeFinished()
+    {
+        m_drawing = false;
+        if (m_enabled)
+            m_debounceTimer->start();
+    }
+
+    void LiveCompletionController::onCanvasChanged()
+    {
+        if (!m_enabled || m_drawing)
+            return;
+
+        const quint64 hash = m_paintController->getContentHash();
+        if (hash != 0 && (hash == m_overlayHash || hash == m_pendingHash))
+            return;
+
+        cancelPending();
+        m_paintWidget->clearCompletionOverlay();
+        m_debounceTimer->start();
+    }
+
+    void LiveCompletionController::onDebounceElapsed()
+    {
+        if (!m_enabled || m_drawing || !m_model)
+            return;
+
+        const quint64 hash = m_paintController->getContentHash();
+        if (hash == 0 || hash == m_pendingHash)
+            return;
+
+        if (hash == m_overlayHash)
+        {
+            m_paintWidget->setCompletionOverlay(m_overlay);
+            return;
+        }
+
+        if (currentModelKey().isEmpty())
+            return;
+
+        const ICanvasImageConstPtr snapshot = m_paintController->getSnapshot();
+        if (!snapshot)
+            return;
+
+        m_pendingHash = hash;
+        m_awaitingImage = true;
+        m_model->setImageSource([snapshot]() {
+            return PaintController::toQImage(snapshot);
+        });
+    }
+
+    void LiveCompletionController::onImagePrepared()
+    {
+        if (!m_awaitingImage)
+            return;
+
+        m_awaitingImage = false;
+        m_model->processImage(currentModelKey(), m_postprocessValue, RequestPriority::Speculative);
+    }
+
+    void LiveCompletionController::onProcessingFinished(bool success, const QPixmap& resultPixmap)
+    {
+        const quint64 hash = m_pendingHash;
+        m_pendingHash = 0;
+        if (!m_enabled || m_drawing || !success || hash == 0 || hash != m_paintController->getContentHash())
+            return;
+
+        m_overlayHash = hash;
+        m_overlay = resultPixmap;
+        m_paintWidget->setCompletionOverlay(m_overlay);
+    }
+
+    void LiveCompletionController::cancelPending()
+    {
+        m_debounceTimer->stop();
+        m_awaitingImage = false;
+        m_pendingHash = 0;
+        if (m_model)
+            m_model->cancelProcessing();
+    }
+
+    QString LiveCompletionController::currentModelKey() const
+    {
+        if (!m_modelKey.isEmpty() || !m_model)
+            return m_modelKey;
+        return m_model->modelKeys().value(0);
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "AICompletionModel.h"
+#include "PaintController.h"
+#include "PaintWidget.h"
+#include "WorkStealingPool.h"
+
+#include <QObject>
+#include <QPixmap>
+#include <QString>
+#include <QTimer>
+
+namespace paint
+{
+    class LiveCompletionController : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        static constexpr int DEFAULT_DEBOUNCE_MS = 800;
+        static constexpr int MIN_DEBOUNCE_MS = 100;
+        static constexpr int MAX_DEBOUNCE_MS = 10000;
+
+    public:
+        LiveCompletionController(QObject* parent, PaintWidget* paintWidget, PaintController* paintController,
+            WorkStealingPoolPtr taskPool, RequestScheduler* scheduler);
+        ~LiveCompletionController() = default;
+
+        LiveCompletionController(const LiveCompletionController&) = delete;
+        LiveCompletionController& operator=(const LiveCompletionController&) = delete;
+
+        LiveCompletionController(LiveCompletionController&&) = delete;
+        LiveCompletionController& operator=(LiveCompletionController&&) = delete;
+
+        void setEnabled(bool enabled);
+        bool isEnabled() const;
+
+        void setDebounceInterval(int milliseconds);
+        int debounceInterval() const;
+
+        void setModel(const QString& modelKey, int postprocessValue);
+
+    private slots:
+        void onStrokeStarted();
+        void onStrokeFinished();
+        void onCanvasChanged();
+        void onDebounceElapsed();
+        void onImagePrepared();
+        void onProcessingFinished(bool success, const QPixmap& resultPixmap);
+
+    private:
+        void cancelPending();
+        QString currentModelKey() const;
+
+        PaintWidget* m_paintWidget;
+        PaintController* m_paintController;
+        WorkStealingPoolPtr m_taskPool;
+        RequestScheduler* m_scheduler;
+        AICompletionModel* m_model;
+        QTimer* m_debounceTimer;
+
+        bool m_enabled;
+        bool m_drawing;
+        bool m_awaitingImage;
+
+        QString m_modelKey;
+        int m_postprocessValue;
+
+        quint64 m_pendingHash;
+        quint64 m_overlayHash;
+        QPixmap m_overlay;
+    };
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+namespace paint
+{
+    template <typename T>
+    class LockFreeQueue
+    {
+    public:
+        LockFreeQueue()
+            : m_head(new Node())
+            , m_tail(m_head)
+        {
+        }
+
+        ~LockFreeQueue()
+        {
+            while (m_head)
+            {
+                Node* next = m_head->next.load(std::memory_order_relaxed);
+                delete m_head;
+                m_head = next;
+            }
+        }
+
+        LockFreeQueue(const LockFreeQueue&) = delete;
+        LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+        LockFreeQueue(LockFreeQueue&&) = delete;
+        LockFreeQueue& operator=(LockFreeQueue&&) = delete;
+
+        void push(T value)
+        {
+            Node* node = new Node();
+            node->value = std::move(value);
+            m_tail->next.store(node, std::memory_order_release);
+            m_tail = node;
+        }
+
+        bool pop(T& value)
+        {
+            Node* next = m_head->next.load(std::memory_order_acquire);
+            if (!next)
+                return false;
+
+            value = std::move(next->value);
+            delete m_head;
+            m_head = next;
+            return true;
+        }
+
+    private:
+        struct Node
+        {
+            T value{};
+            std::atomic<Node*> next{ nullptr };
+        };
+
+        Node* m_head;
+        Node* m_tail;
+    };
+}
@@ -6,32 +6,49 @@
 #include "CanvasColor.h"
 #include "CanvasPen.h"
 #include "CanvasImage.h"
+#include "TiledCanvasImage.h"
 
 #include <QPainter>
 
+#include <cmath>
+
 namespace paint
 {
     PaintController::PaintController(QObject* parent, ICanvasModelPtr model)
         : QObject(parent)
-        , m_model(model)
+        , m_toolStrategies(ToolStrategyFactory::createRegistry())
         , m_currentToolStrategy(nullptr)
+        , m_shapeStyle(ShapeStyle::Outline)
+        , m_fillRule(FillRule::EvenOdd)
+        , m_batching(false)
+        , m_batchChanged(false)
+        , m_requestedFrame(0)
     {
+        if (model)
+        {
+            m_renderWorker = RenderWorker::create(model, [this]() {
+                QMetaObject::invokeMethod(this, &PaintController::onFrameReady, Qt::QueuedConnection);
+            });
+        }
         notifyCanvasChanged();
     }
 
     PaintController::~PaintController()
     {
+        m_renderWorker.reset();
     }
 
     void PaintController::drawLine(const QPoint& from, const QPoint& to, const QPen& pen)
     {
-        if (!m_model) return;
-        m_model->drawLine(toCanvasPoint(from), toCanvasPoint(to), toCanvasPen(pen));
+        if (!m_renderWorker) return;
+        m_renderWorker->submit([from = toCanvasPoint(from), to = toCanvasPoint(to), pen = toCanvasPen(pen)](ICanvasModel& model) {
+            model.drawLine(from, to, pen);
+        });
     }
 
     void PaintController::drawLines(const QVector<QPair<QPoint, QPoint>>& lines, const QPen& pen)
     {
-        if (!m_model) return;
+        if (!m_renderWorker) return;
         
         std::vector<std::pair<ICanvasPointConstPtr, ICanvasPointConstPtr>> canvasLines;
         canvasLines.reserve(lines.size());
@@ -41,31 +58,89 @@ namespace paint
             canvasLines.push_back({toCanvasPoint(line.first), toCanvasPoint(line.second)});
         }
         
-        m_model->drawLines(canvasLines, toCanvasPen(pen));
+        m_renderWorker->submit([canvasLines = std::move(canvasLines), pen = toCanvasPen(pen)](ICanvasModel& model) {
+            model.drawLines(canvasLines, pen);
+        });
     }
 
     void PaintController::drawRect(const QRect& rect, const QPen& pen)
     {
-        if (!m_model) return;
-        m_model->drawRect(toCanvasRect(rect), toCanvasPen(pen));
+        if (!m_renderWorker) return;
+        m_renderWorker->submit([rect = toCanvasRect(rect), pen = toCanvasPen(pen)](ICanvasModel& model) {
+            model.drawRect(rect, pen);
+        });
     }
 
     void PaintController::drawEllipse(const QRect& rect, const QPen& pen)
     {
-        if (!m_model) return;
-        m_model->drawEllipse(toCanvasRect(rect), toCanvasPen(pen));
+        if (!m_renderWorker) return;
+        m_renderWorker->submit([rect = toCanvasRect(rect), pen = toCanvasPen(pen)](ICanvasModel& model) {
+            model.drawEllipse(rect, pen);
+        });
+    }
+
+    void PaintController::drawTriangle(const QPoint& a, const QPoint& b, const QPoint& c, const QPen& pen)
+    {
+        if (!m_renderWorker) return;
+        m_renderWorker->submit([a = toCanvasPoint(a), b = toCanvasPoint(b), c = toCanvasPoint(c), pen = toCanvasPen(pen)](ICanvasModel& model) {
+            model.drawTriangle(a, b, c, pen);
+        });
+    }
+
+    void PaintController::fillRect(const QRect& rect, const QColor& fillColor)
+    {
+        if (!m_renderWorker) return;
+        m_renderWorker->submit([rect = toCanvasRect(rect), color = toCanvasColor(fillColor)](ICanvasModel& model) {
+            model.fillRect(rect, color);
+        });
+    }
+
+    void PaintController::fillEllipse(const QRect& rect, const QColor& fillColor)
+    {
+        if (!m_renderWorker) return;
+        m_renderWorker->submit([rect = toCanvasRect(rect), color = toCanvasColor(fillColor)](ICanvasModel& model) {
+            model.fillEllipse(rect, color);
+        });
+    }
+
+    void PaintController::fillTriangle(const QPoint& a, const QPoint& b, const QPoint& c, const QColor& fillColor)
+    {
+        if (!m_renderWorker) return;
+        m_renderWorker->submit([a = toCanvasPoint(a), b = toCanvasPoint(b), c = toCanvasPoint(c), color = toCanvasColor(fillColor)](ICanvasModel& model) {
+            model.fillTriangle(a, b, c, color);
+        });
+    }
+
+    void PaintController::drawPolygon(const QVector<QPoint>& points, const QPen& pen)
+    {
+        if (!m_renderWorker) return;
+        m_renderWorker->submit([points = toCanvasPoints(points), pen = toCanvasPen(pen)](ICanvasModel& model) {
+            model.drawPolygon(points, pen);
+        });
+    }
+
+    void PaintController::fillPolygon(const QVector<QPoint>& points, const QColor& fillColor)
+    {
+        if (!m_renderWorker) return;
+        m_renderWorker->submit([points = toCanvasPoints(points), color = toCanvasColor(fillColor), rule = m_fillRule](ICanvasModel& model) {
+            model.fillPolygon(points, color, rule);
+        });
     }
 
     void PaintController::drawPoint(const QPoint& point, const QPen& pen)
     {
-        if (!m_model) return;
-        m_model->drawPoint(toCanvasPoint(point), toCanvasPen(pen));
+        if (!m_renderWorker) return;
+        m_renderWorker->submit([point = toCanvasPoint(point), pen = toCanvasPen(pen)](ICanvasModel& model) {
+            model.drawPoint(point, pen);
+        });
     }
 
     void PaintController::fillPoint(const QPoint& point, const QColor& fillColor)
     {
-        if (!m_model) return;
-        m_model->fillPoint(toCanvasPoint(point), toCanvasColor(fillColor));
+        if (!m_renderWorker) return;
+        m_renderWorker->submit([point = toCanvasPoint(point), color = toCanvasColor(fillColor)](ICanvasModel& model) {
+            model.fillPoint(point, color);
+        });
     }
 
     void PaintController::handleMousePress(const QPoint& point, const QPen& pen)
@@ -83,79 +158,238 @@ namespace paint
         m_currentToolStrategy->onMouseRelease(this, point, pen);
     }
 
+    void PaintController::finishShape(const QPen& pen)
+    {
+        if (!m_currentToolStrategy) return;
+        m_currentToolStrategy->finish(this, pen);
+    }
+
+    void PaintController::cancelShape()
+    {
+        if (!m_currentToolStrategy) return;
+        m_currentToolStrategy->deactivate();
+    }
+
+    void PaintController::handleTabletPress(const StrokeSample& sample, const QPen& pen)
+    {
+        if (!m_currentToolStrategy) return;
+        m_currentToolStrategy->onMousePress(this, sample.position, pressurePen(pen, sample));
+    }
+
+    void PaintController::handleTabletMove(const QVector<StrokeSample>& samples, const QPen& pen)
+    {
+        if (!m_currentToolStrategy || samples.isEmpty()) return;
+
+        m_batching = true;
+        m_batchChanged = false;
+        for (const StrokeSample& sample : samples)
+        {
+            m_currentToolStrategy->onMouseMove(this, sample.position, pressurePen(pen, sample));
+        }
+        m_batching = false;
+
+        if (m_batchChanged)
+            notifyCanvasChanged();
+    }
+
+    void PaintController::handleTabletRelease(const StrokeSample& sample, const QPen& pen)
+    {
+        if (!m_currentToolStrategy) return;
+        m_currentToolStrategy->onMouseRelease(this, sample.position, pressurePen(pen, sample));
+    }
+
     void PaintController::setTool(Tool tool)
     {
-        m_currentToolStrategy = ToolStrategyFactory::createStrategy(tool);
+        IToolStrategy* strategy = m_toolStrategies.strategy(tool);
+        if (m_currentToolStrategy && m_currentToolStrategy != strategy)
+            m_currentToolStrategy->deactivate();
+        m_currentToolStrategy = strategy;
+    }
+
+    void PaintController::setShapeStyle(ShapeStyle style)
+    {
+        m_shapeStyle = style;
+    }
+
+    ShapeStyle PaintController::getShapeStyle() const
+    {
+        return m_shapeStyle;
+    }
+
+    void PaintController::setFillRule(FillRule rule)
+    {
+        m_fillRule = rule;
+    }
+
+    FillRule PaintController::getFillRule() const
+    {
+        return m_fillRule;
     }
 
     void PaintController::undo()
     {
-        if (!m_model) return;
-        m_model->undo();
+        if (!m_renderWorker) return;
+        m_renderWorker->submit([](ICanvasModel& model) {
+            model.undo();
+        });
         notifyCanvasChanged();
     }
 
     void PaintController::redo()
     {
-        if (!m_model) return;
-        m_model->redo();
+        if (!m_renderWorker) return;
+        m_renderWorker->submit([](ICanvasModel& model) {
+            model.redo();
+        });
         notifyCanvasChanged();
     }
 
     void PaintController::clear()
     {
-        if (!m_model) return;
-        m_model->clear();
+        if (!m_renderWorker) return;
+        m_renderWorker->submit([](ICanvasModel& model) {
+            model.clear();
+        });
+        notifyCanvasChanged();
+    }
+
+    void PaintController::newCanvas(int width, int height)
+    {
+        if (!m_renderWorker) return;
+        m_renderWorker->submit([width, height](ICanvasModel& model) {
+            model.reset(width, height);
+        });
         notifyCanvasChanged();
     }
 
     void PaintController::saveState()
     {
-        if (!m_model) return;
-        m_model->saveState();
+        if (!m_renderWorker) return;
+        m_renderWorker->submit([](ICanvasModel& model) {
+            model.saveState();
+        });
     }
 
     void PaintController::loadImage(const QImage& image)
     {
-        if (!m_model) return;
+        if (!m_renderWorker) return;
 
-        int width = m_model->image()->width();
-        int height = m_model->image()->height();
+        m_renderWorker->submit([image](ICanvasModel& model) {
+            int width = model.width();
+            int height = model.height();
 
-        QImage img = image.scaled(width, height, Qt::KeepAspectRatio);
+            QImage img = image.scaled(width, height, Qt::KeepAspectRatio);
 
-        if ((image.width() != width) || (image.height() != height))
-        {
-            QImage background(width, height, QImage::Format_RGB32);
-            background.fill(Qt::white);
+            if ((image.width() != width) || (image.height() != height))
+            {
+                QImage background(width, height, CanvasImage::FORMAT);
+                background.fill(Qt::white);
 
-            QPainter painter(&background);
-            int x = (width - img.width()) / 2;
-            int y = (height - img.height()) / 2;
-            painter.drawImage(x, y, img);
+                QPainter painter(&background);
+                int x = (width - img.width()) / 2;
+                int y = (height - img.height()) / 2;
+                painter.drawImage(x, y, img);
 
-            img = background;
-        }
+                img = background;
+            }
+
+            model.loadImage(TiledCanvasImage::create(img));
+        });
+        notifyCanvasChanged();
+    }
+
+    void PaintController::drawImage(const QImage& image, const QPoint& topLeft)
+    {
+        if (!m_renderWorker || image.isNull()) return;
 
-        ICanvasImagePtr canvasImage = CanvasImage::create(img);
-        m_model->loadImage(canvasImage);
+        m_renderWorker->submit([image = CanvasImage::create(image), topLeft = toCanvasPoint(topLeft)](ICanvasModel& model) {
+            model.saveState();
+            model.drawImage(image, topLeft);
+        });
         notifyCanvasChanged();
     }
 
     QImage PaintController::getImage() const
     {
-        if (!m_model) return QImage(); 
-        return fromCanvasImage(m_model->image());
+        if (!m_renderWorker) return QImage();
+        return toQImage(m_renderWorker->frame().image);
+    }
+
+    ICanvasImageConstPtr PaintController::getSnapshot() const
+    {
+        return m_renderWorker ? m_renderWorker->frame().image : nullptr;
+    }
+
+    quint64 PaintController::getContentHash() const
+    {
+        return m_renderWorker ? m_renderWorker->frame().contentHash : 0;
+    }
+
+    QSize PaintController::getCanvasSize() const
+    {
+        ICanvasImageConstPtr image = m_renderWorker ? m_renderWorker->frame().image : nullptr;
+        if (!image) return QSize();
+        return QSize(image->width(), image->height());
+    }
+
+    QColor PaintController::getPixelColor(const QPoint& point) const
+    {
+        ICanvasImageConstPtr image = m_renderWorker ? m_renderWorker->frame().image : nullptr;
+        if (!image) return QColor();
+
+        ICanvasColorConstPtr color = image->pixelAt(point.x(), point.y());
+        if (!color) return QColor();
+        return QColor(color->red(), color->green(), color->blue(), color->alpha());
+    }
+
+    int PaintController::getTileSize() const
+    {
+        return TiledCanvasImage::TILE_SIZE;
+    }
+
+    quint64 PaintController::getTileVersion(int column, int row) const
+    {
+        auto tiledImage = m_renderWorker ? std::dynamic_pointer_cast<const TiledCanvasImage>(m_renderWorker->frame().image) : nullptr;
+        if (!tiledImage || column < 0 || row < 0 || column >= tiledImage->columns() || row >= tiledImage->rows())
+            return 0;
+        return tiledImage->tileVersion(column, row);
+    }
+
+    QImage PaintController::getTileImage(int column, int row) const
+    {
+        ICanvasImageConstPtr image = m_renderWorker ? m_renderWorker->frame().image : nullptr;
+        if (!image) return QImage();
+
+        auto tiledImage = std::dynamic_pointer_cast<const TiledCanvasImage>(image);
+        if (tiledImage)
+        {
+            if (column < 0 || row < 0 || column >= tiledImage->columns() || row >= tiledImage->rows())
+                return QImage();
+            return tiledImage->tileImage(column, row);
+        }
+
+        const int tileSize = getTileSize();
+        return toQImage(image).copy(column * tileSize, row * tileSize, tileSize, tileSize);
     }
 
     bool PaintController::canUndo() const
     {
-        return m_model ? m_model->canUndo() : false;
+        return m_renderWorker ? m_renderWorker->frame().canUndo : false;
     }
 
     bool PaintController::canRedo() const
     {
-        return m_model ? m_model->canRedo() : false;
+        return m_renderWorker ? m_renderWorker->frame().canRedo : false;
+    }
+
+    quint64 PaintController::getRequestedFrame() const
+    {
+        return m_requestedFrame;
+    }
+
+    quint64 PaintController::getPresentedFrame() const
+    {
+        return m_renderWorker ? m_renderWorker->frame().request : 0;
     }
 
     ICanvasPointPtr PaintController::toCanvasPoint(const QPoint& point) const
@@ -168,6 +402,17 @@ namespace paint
         return CanvasRect::create(rect);
     }
 
+    std::vector<ICanvasPointConstPtr> PaintController::toCanvasPoints(const QVector<QPoint>& points) const
+    {
+        std::vector<ICanvasPointConstPtr> canvasPoints;
+        canvasPoints.reserve(points.size());
+        for (const QPoint& point : points)
+        {
+            canvasPoints.push_back(toCanvasPoint(point));
+        }
+        return canvasPoints;
+    }
+
     ICanvasColorPtr PaintController::toCanvasColor(const QColor& color) const
     {
         return CanvasColor::create(color);
@@ -179,7 +424,7 @@ namespace paint
         return CanvasPen::create(canvasColor, pen.width());
     }
 
-    QImage PaintController::fromCanvasImage(ICanvasImageConstPtr canvasImage) const
+    QImage PaintController::toQImage(ICanvasImageConstPtr canvasImage)
     {
         if (!canvasImage)
             return QImage();
@@ -189,8 +434,14 @@ namespace paint
         {
             return concreteImage->toQImage(); 
         }
+
+        auto tiledImage = std::dynamic_pointer_cast<const TiledCanvasImage>(canvasImage);
+        if (tiledImage)
+        {
+            return tiledImage->toQImage();
+        }
         
-        QImage image(canvasImage->width(), canvasImage->height(), QImage::Format_ARGB32);
+        QImage image(canvasImage->width(), canvasImage->height(), CanvasImage::FORMAT);
         image.fill(Qt::transparent); 
         for (int y = 0; y < canvasImage->height(); ++y)
         {
@@ -214,8 +465,31 @@ namespace paint
         return image;
     }
     
+    QPen PaintController::pressurePen(const QPen& pen, const StrokeSample& sample) const
+    {
+        const qreal pressureScale = MIN_PRESSURE_SCALE + (1.0 - MIN_PRESSURE_SCALE) * qBound(0.0, sample.pressure, 1.0);
+        const qreal tilt = qMin(std::hypot(sample.xTilt, sample.yTilt), MAX_TILT) / MAX_TILT;
+
+        QPen scaledPen(pen);
+        scaledPen.setWidth(qMax(1, qRound(pen.width() * pressureScale * (1.0 + TILT_WIDTH_FACTOR * tilt))));
+        return scaledPen;
+    }
+
     void PaintController::notifyCanvasChanged()
     {
-        emit canvasChanged();
+        if (m_batching)
+        {
+            m_batchChanged = true;
+            return;
+        }
+
+        if (m_renderWorker)
+            m_requestedFrame = m_renderWorker->requestFrame();
+    }
+
+    void PaintController::onFrameReady()
+    {
+        if (m_renderWorker && m_renderWorker->acquireFrame())
+            emit canvasChanged();
     }
 }
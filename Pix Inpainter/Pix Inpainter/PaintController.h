@@ -2,6 +2,9 @@
 
 #include "ICanvasModel.h"
 #include "IToolStrategy.h"
+#include "ToolStrategyFactory.h"
+#include "RenderWorker.h"
+#include "StrokeSample.h"
 #include "Enums.h"
 
 #include <QObject>
@@ -11,6 +14,7 @@
 #include <QImage>
 #include <QPair>
 #include <QRect>
+#include <QSize>
 
 namespace paint
 {
@@ -18,6 +22,11 @@ namespace paint
     {
         Q_OBJECT
 
+    public:
+        static constexpr qreal MIN_PRESSURE_SCALE = 0.2;
+        static constexpr qreal TILT_WIDTH_FACTOR = 0.5;
+        static constexpr qreal MAX_TILT = 60.0;
+
     public:
         explicit PaintController(QObject* parent, ICanvasModelPtr model);
         ~PaintController();
@@ -33,39 +42,78 @@ namespace paint
         void drawLines(const QVector<QPair<QPoint, QPoint>>& lines, const QPen& pen);
         void drawRect(const QRect& rect, const QPen& pen);
         void drawEllipse(const QRect& rect, const QPen& pen);
+        void drawTriangle(const QPoint& a, const QPoint& b, const QPoint& c, const QPen& pen);
+        void fillRect(const QRect& rect, const QColor& fillColor);
+        void fillEllipse(const QRect& rect, const QColor& fillColor);
+        void fillTriangle(const QPoint& a, const QPoint& b, const QPoint& c, const QColor& fillColor);
+        void drawPolygon(const QVector<QPoint>& points, const QPen& pen);
+        void fillPolygon(const QVector<QPoint>& points, const QColor& fillColor);
         void drawPoint(const QPoint& point, const QPen& pen);
         void fillPoint(const QPoint& point, const QColor& fillColor);
 
         void handleMousePress(const QPoint& point, const QPen& pen);
         void handleMouseMove(const QPoint& point, const QPen& pen);
         void handleMouseRelease(const QPoint& point, const QPen& pen);
+        void finishShape(const QPen& pen);
+        void cancelShape();
+
+        void handleTabletPress(const StrokeSample& sample, const QPen& pen);
+        void handleTabletMove(const QVector<StrokeSample>& samples, const QPen& pen);
+        void handleTabletRelease(const StrokeSample& sample, const QPen& pen);
 
         void setTool(Tool tool);
+        void setShapeStyle(ShapeStyle style);
+        ShapeStyle getShapeStyle() const;
+        void setFillRule(FillRule rule);
+        FillRule getFillRule() const;
         void undo();
         void redo();
         void clear();
+        void newCanvas(int width, int height);
         void saveState();
         void loadImage(const QImage& image);
+        void drawImage(const QImage& image, const QPoint& topLeft);
 
         QImage getImage() const;
+        ICanvasImageConstPtr getSnapshot() const;
+        quint64 getContentHash() const;
+        QSize getCanvasSize() const;
+        QColor getPixelColor(const QPoint& point) const;
+
+        int getTileSize() const;
+        quint64 getTileVersion(int column, int row) const;
+        QImage getTileImage(int column, int row) const;
 
         bool canUndo() const;
         bool canRedo() const;
 
+        quint64 getRequestedFrame() const;
+        quint64 getPresentedFrame() const;
+
         void notifyCanvasChanged();
 
+        static QImage toQImage(ICanvasImageConstPtr canvasImage);
+
     signals:
         void canvasChanged();
 
     private:
         ICanvasPointPtr toCanvasPoint(const QPoint& point) const;
         ICanvasRectPtr toCanvasRect(const QRect& rect) const;
+        std::vector<ICanvasPointConstPtr> toCanvasPoints(const QVector<QPoint>& points) const;
         ICanvasColorPtr toCanvasColor(const QColor& color) const;
         ICanvasPenPtr toCanvasPen(const QPen& pen) const;
-        QImage fromCanvasImage(ICanvasImageConstPtr canvasImage) const;
+        QPen pressurePen(const QPen& pen, const StrokeSample& sample) const;
+        void onFrameReady();
 
     private:
-        ICanvasModelPtr m_model;
-        IToolStrategyUniquePtr m_currentToolStrategy;
+        RenderWorkerUniquePtr m_renderWorker;
+        ToolStrategyRegistry m_toolStrategies;
+        IToolStrategy* m_currentToolStrategy;
+        ShapeStyle m_shapeStyle;
+        FillRule m_fillRule;
+        bool m_batching;
+        bool m_batchChanged;
+        quint64 m_requestedFrame;
     };
 }
\ No newline at end of file
@@ -11,21 +11,37 @@ namespace paint
 {
     PaintWidget::PaintWidget(QWidget* parent, int width, int height, float initialZoom)
         : QWidget(parent)
+        , m_canvasSize(width, height)
+        , m_tileColumns(0)
         , m_pen(QPen(Qt::black, 2))
         , m_primaryColor(Qt::black)
         , m_secondaryColor(Qt::white)
         , m_zoom(initialZoom)
+        , m_uiToolStrategies(UiToolStrategyFactory::createRegistry())
         , m_currentUiToolStrategy(nullptr)
         , m_showGrid(false)
         , m_gridSize(DEFAULT_GRID_SIZE)
         , m_controller(nullptr)
+        , m_tool(Tool::Pen)
+        , m_predictedInkEnabled(true)
+        , m_latencyMeasurementEnabled(false)
+        , m_tabletFlushTimer(new QTimer(this))
+        , m_tabletActive(false)
+        , m_lastTabletFlush(0)
+        , m_pendingLatencyStart(-1)
+        , m_pendingLatencyFrame(0)
+        , m_latencyFramePresented(false)
+        , m_latencyTotalMs(0.0)
+        , m_latencyMaxMs(0.0)
+        , m_latencyCount(0)
     {
         m_ui.setupUi(this);
         resize(width, height);
 
-        m_canvasImage = QImage(size(), QImage::Format_RGB32);
-        m_canvasImage.fill(Qt::white);
-        m_displayPixmap = QPixmap::fromImage(m_canvasImage);
+        m_latencyClock.start();
+        setFocusPolicy(Qt::ClickFocus);
+        m_tabletFlushTimer->setSingleShot(true);
+        connect(m_tabletFlushTimer, &QTimer::timeout, this, &PaintWidget::flushTabletSamples);
 
         setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
         resize(sizeHint());
@@ -37,7 +53,8 @@ namespace paint
         m_controller = controller;
         connect(m_controller, &paint::PaintController::canvasChanged,
             this, [this]() {
-                m_canvasImage = m_controller->getImage();
+                if (m_pendingLatencyStart >= 0 && m_controller->getPresentedFrame() >= m_pendingLatencyFrame)
+                    m_latencyFramePresented = true;
                 updateCanvas();
             });
     }
@@ -60,6 +77,12 @@ namespace paint
             m_controller->clear();
     }
 
+    void PaintWidget::newCanvas(int width, int height)
+    {
+        if (m_controller)
+            m_controller->newCanvas(width, height);
+    }
+
     PaintWidget::~PaintWidget()
     {
     }
@@ -99,17 +122,42 @@ namespace paint
         QPainter painter(this);
 
         painter.scale(m_zoom, m_zoom);
-        painter.drawPixmap(0, 0, m_displayPixmap);
+
+        const QRect exposed = toCanvasRect(event->rect()).intersected(QRect(QPoint(0, 0), m_canvasSize));
+        if (exposed.isEmpty())
+            return;
+
+        if (m_controller)
+        {
+            const int tileSize = m_controller->getTileSize();
+            for (int row = exposed.top() / tileSize; row <= exposed.bottom() / tileSize; ++row)
+            {
+                for (int column = exposed.left() / tileSize; column <= exposed.right() / tileSize; ++column)
+                {
+                    const QRect tileRect(column * tileSize, row * tileSize, tileSize, tileSize);
+                    const QRect visible = tileRect.intersected(exposed);
+                    painter.drawPixmap(visible, displayTile(column, row), visible.translated(-tileRect.topLeft()));
+                }
+            }
+        }
+
+        if (!m_completionOverlay.isNull())
+        {
+            painter.save();
+            painter.setOpacity(COMPLETION_OVERLAY_OPACITY);
+            painter.drawPixmap(QRect(QPoint(0, 0), m_canvasSize), m_completionOverlay);
+            painter.restore();
+        }
 
         if (m_showGrid) {
             painter.setPen(QPen(QColor(200, 200, 200, 120), 1, Qt::DashLine));
 
-            for (int x = 0; x < m_canvasImage.width(); x += m_gridSize) {
-                painter.drawLine(x, 0, x, m_canvasImage.height());
+            for (int x = exposed.left() - exposed.left() % m_gridSize; x <= exposed.right(); x += m_gridSize) {
+                painter.drawLine(x, 0, x, m_canvasSize.height());
             }
 
-            for (int y = 0; y < m_canvasImage.height(); y += m_gridSize) {
-                painter.drawLine(0, y, m_canvasImage.width(), y);
+            for (int y = exposed.top() - exposed.top() % m_gridSize; y <= exposed.bottom(); y += m_gridSize) {
+                painter.drawLine(0, y, m_canvasSize.width(), y);
             }
         }
 
@@ -118,10 +166,25 @@ namespace paint
             painter.save();
 
             painter.setPen(m_pen);
+            if (getShapeStyle() == ShapeStyle::Filled)
+                painter.setBrush(m_pen.color());
             m_currentUiToolStrategy->drawPreview(this, painter);
 
             painter.restore();
         }
+
+        if (isPredictingInk())
+            drawPredictedInk(painter);
+
+        if (m_latencyFramePresented)
+        {
+            const qreal latencyMs = (m_latencyClock.nsecsElapsed() - m_pendingLatencyStart) / 1.0e6;
+            m_latencyTotalMs += latencyMs;
+            m_latencyMaxMs = qMax(m_latencyMaxMs, latencyMs);
+            ++m_latencyCount;
+            m_pendingLatencyStart = -1;
+            m_latencyFramePresented = false;
+        }
     }
 
     void PaintWidget::mousePressEvent(QMouseEvent* event)
@@ -130,8 +193,18 @@ namespace paint
         {
             if (m_currentUiToolStrategy)
             {
+                const qint64 timestamp = m_latencyClock.nsecsElapsed();
+                const quint64 requestedFrame = m_controller->getRequestedFrame();
+                m_inkPredictor.reset();
+                m_inkPredictor.addSample(event->position() / m_zoom, timestamp);
+                if (m_latencyMeasurementEnabled)
+                    beginLatencyStroke();
+
+                emit strokeStarted();
                 m_currentUiToolStrategy->onMousePress(this, event);
                 m_controller->handleMousePress(toCanvasPos(event->pos()), m_pen);
+                if (m_latencyMeasurementEnabled)
+                    trackLatencyInput(timestamp, requestedFrame);
             }
         }
     }
@@ -142,8 +215,15 @@ namespace paint
         {
             if (m_currentUiToolStrategy)
             {
+                const qint64 timestamp = m_latencyClock.nsecsElapsed();
+                const quint64 requestedFrame = m_controller->getRequestedFrame();
+                m_inkPredictor.addSample(event->position() / m_zoom, timestamp);
+
                 m_currentUiToolStrategy->onMouseMove(this, event);
                 m_controller->handleMouseMove(toCanvasPos(event->pos()), m_pen);
+                if (m_latencyMeasurementEnabled)
+                    trackLatencyInput(timestamp, requestedFrame);
+                updatePredictedInk();
             }
         }
     }
@@ -156,10 +236,43 @@ namespace paint
             {
                 m_controller->handleMouseRelease(toCanvasPos(event->pos()), m_pen);
                 m_currentUiToolStrategy->onMouseRelease(this, event);
+
+                if (m_latencyMeasurementEnabled)
+                    finishLatencyStroke();
+                m_inkPredictor.reset();
+                updatePredictedInk();
+                emit strokeFinished();
             }
         }
     }
 
+    void PaintWidget::mouseDoubleClickEvent(QMouseEvent* event)
+    {
+        if ((event->button() == Qt::LeftButton || event->button() == Qt::RightButton) && finishShape())
+            return;
+
+        QWidget::mouseDoubleClickEvent(event);
+    }
+
+    void PaintWidget::keyPressEvent(QKeyEvent* event)
+    {
+        switch (event->key())
+        {
+        case Qt::Key_Return:
+        case Qt::Key_Enter:
+            if (finishShape())
+                return;
+            break;
+        case Qt::Key_Escape:
+            cancelShape();
+            return;
+        default:
+            break;
+        }
+
+        QWidget::keyPressEvent(event);
+    }
+
     void PaintWidget::wheelEvent(QWheelEvent* event)
     {
         if (event->modifiers() & Qt::ControlModifier) {
@@ -177,6 +290,232 @@ namespace paint
         QWidget::wheelEvent(event);
     }
 
+    void PaintWidget::tabletEvent(QTabletEvent* event)
+    {
+        event->accept();
+        if (!m_currentUiToolStrategy || !m_controller)
+            return;
+
+        switch (event->type())
+        {
+        case QEvent::TabletPress:
+        {
+            if (event->button() != Qt::LeftButton && event->button() != Qt::RightButton)
+                return;
+
+            flushTabletSamples();
+            m_tabletActive = true;
+
+            const StrokeSample sample = toStrokeSample(event);
+            const quint64 requestedFrame = m_controller->getRequestedFrame();
+            m_inkPredictor.reset();
+            m_inkPredictor.addSample(event->position() / m_zoom, sample.timestamp);
+            if (m_latencyMeasurementEnabled)
+                beginLatencyStroke();
+
+            emit strokeStarted();
+            QMouseEvent mouseEvent(QEvent::MouseButtonPress, event->position(), event->globalPosition(),
+                event->button(), event->buttons(), event->modifiers());
+            m_currentUiToolStrategy->onMousePress(this, &mouseEvent);
+            m_controller->handleTabletPress(sample, m_pen);
+            if (m_latencyMeasurementEnabled)
+                trackLatencyInput(sample.timestamp, requestedFrame);
+            break;
+        }
+        case QEvent::TabletMove:
+        {
+            if (!m_tabletActive)
+                return;
+
+            QMouseEvent mouseEvent(QEvent::MouseMove, event->position(), event->globalPosition(),
+                Qt::NoButton, event->buttons(), event->modifiers());
+            m_currentUiToolStrategy->onMouseMove(this, &mouseEvent);
+
+            const StrokeSample sample = toStrokeSample(event);
+            m_inkPredictor.addSample(event->position() / m_zoom, sample.timestamp);
+            m_pendingTabletSamples.append(sample);
+            updatePredictedInk();
+
+            if (!m_tabletFlushTimer->isActive())
+            {
+                const qint64 sinceFlushMs = (m_latencyClock.nsecsElapsed() - m_lastTabletFlush) / 1000000;
+                m_tabletFlushTimer->start(static_cast<int>(qMax<qint64>(0, FRAME_INTERVAL_MS - sinceFlushMs)));
+            }
+            break;
+        }
+        case QEvent::TabletRelease:
+        {
+            if (!m_tabletActive)
+                return;
+
+            flushTabletSamples();
+            m_tabletActive = false;
+
+            QMouseEvent mouseEvent(QEvent::MouseButtonRelease, event->position(), event->globalPosition(),
+                event->button(), event->buttons(), event->modifiers());
+            m_controller->handleTabletRelease(toStrokeSample(event), m_pen);
+            m_currentUiToolStrategy->onMouseRelease(this, &mouseEvent);
+
+            if (m_latencyMeasurementEnabled)
+                finishLatencyStroke();
+            m_inkPredictor.reset();
+            updatePredictedInk();
+            emit strokeFinished();
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    StrokeSample PaintWidget::toStrokeSample(const QTabletEvent* event) const
+    {
+        StrokeSample sample;
+        sample.position = toCanvasPos(event->position().toPoint());
+        sample.pressure = event->pressure();
+        sample.xTilt = event->xTilt();
+        sample.yTilt = event->yTilt();
+        sample.timestamp = m_latencyClock.nsecsElapsed();
+        return sample;
+    }
+
+    void PaintWidget::flushTabletSamples()
+    {
+        m_tabletFlushTimer->stop();
+        if (m_pendingTabletSamples.isEmpty())
+            return;
+
+        m_lastTabletFlush = m_latencyClock.nsecsElapsed();
+        const QVector<StrokeSample> samples = std::move(m_pendingTabletSamples);
+        m_pendingTabletSamples.clear();
+        updatePredictedInk();
+
+        if (!m_controller)
+            return;
+
+        const quint64 requestedFrame = m_controller->getRequestedFrame();
+        m_controller->handleTabletMove(samples, m_pen);
+        if (m_latencyMeasurementEnabled)
+            trackLatencyInput(samples.first().timestamp, requestedFrame);
+    }
+
+    bool PaintWidget::isPredictingInk() const
+    {
+        return m_predictedInkEnabled && (m_tool == Tool::Pen || m_tool == Tool::Eraser) && !m_inkPredictor.isEmpty();
+    }
+
+    qreal PaintWidget::predictionHorizonMs() const
+    {
+        if (!m_predictedInkEnabled)
+            return 0.0;
+
+        const qreal latencyMs = m_latencyCount > 0 ? m_latencyTotalMs / m_latencyCount : FRAME_INTERVAL_MS;
+        return qMin(latencyMs, InkPredictor::MAX_HORIZON_MS);
+    }
+
+    QPolygonF PaintWidget::predictedInk() const
+    {
+        QPolygonF overlay;
+        for (const StrokeSample& sample : m_pendingTabletSamples)
+            overlay.append(sample.position);
+        overlay.append(m_inkPredictor.lastPoint());
+        overlay.append(m_inkPredictor.predict(predictionHorizonMs()));
+        return overlay;
+    }
+
+    void PaintWidget::updatePredictedInk()
+    {
+        QRect bounds;
+        if (isPredictingInk())
+        {
+            const int margin = m_pen.width() / 2 + PREVIEW_MARGIN;
+            bounds = predictedInk().boundingRect().toAlignedRect().adjusted(-margin, -margin, margin, margin);
+        }
+
+        const QRect dirty = m_predictedInkBounds.united(bounds);
+        m_predictedInkBounds = bounds;
+        if (!dirty.isEmpty())
+            update(toWidgetRect(dirty));
+    }
+
+    void PaintWidget::drawPredictedInk(QPainter& painter) const
+    {
+        const QPolygonF overlay = predictedInk();
+        if (overlay.size() < 2)
+            return;
+
+        QColor color = m_pen.color();
+        color.setAlpha(qMin(color.alpha(), PREDICTED_INK_ALPHA));
+
+        QPen ink(m_pen);
+        ink.setColor(color);
+        ink.setCapStyle(Qt::RoundCap);
+        ink.setJoinStyle(Qt::RoundJoin);
+
+        painter.save();
+        painter.setPen(ink);
+        painter.setBrush(Qt::NoBrush);
+        painter.drawPolyline(overlay);
+        painter.restore();
+    }
+
+    void PaintWidget::beginLatencyStroke()
+    {
+        m_latencyTotalMs = 0.0;
+        m_latencyMaxMs = 0.0;
+        m_latencyCount = 0;
+        m_pendingLatencyStart = -1;
+        m_latencyFramePresented = false;
+    }
+
+    void PaintWidget::trackLatencyInput(qint64 timestamp, quint64 previousFrame)
+    {
+        // Only input that queued new ink counts; the sample is taken once the frame
+        // covering that request is presented, not on the next unrelated repaint.
+        const quint64 requestedFrame = m_controller->getRequestedFrame();
+        if (m_pendingLatencyStart >= 0 || requestedFrame == previousFrame)
+            return;
+
+        m_pendingLatencyStart = timestamp;
+        m_pendingLatencyFrame = requestedFrame;
+    }
+
+    void PaintWidget::finishLatencyStroke()
+    {
+        if (m_latencyCount > 0)
+            emit latencyMeasured(m_latencyTotalMs / m_latencyCount, m_latencyMaxMs, isPredictingInk() ? predictionHorizonMs() : 0.0);
+        m_pendingLatencyStart = -1;
+        m_latencyFramePresented = false;
+    }
+
+    void PaintWidget::setPredictedInkEnabled(bool enabled)
+    {
+        m_predictedInkEnabled = enabled;
+        update();
+    }
+
+    void PaintWidget::setLatencyMeasurementEnabled(bool enabled)
+    {
+        m_latencyMeasurementEnabled = enabled;
+        m_pendingLatencyStart = -1;
+        m_latencyFramePresented = false;
+    }
+
+    void PaintWidget::setCompletionOverlay(const QPixmap& overlay)
+    {
+        m_completionOverlay = overlay;
+        update();
+    }
+
+    void PaintWidget::clearCompletionOverlay()
+    {
+        if (m_completionOverlay.isNull())
+            return;
+
+        m_completionOverlay = QPixmap();
+        update();
+    }
+
     void PaintWidget::resetZoom()
     {
         m_zoom = BASE_ZOOM;
@@ -217,11 +556,37 @@ namespace paint
 
     void PaintWidget::setTool(Tool tool)
     {
-        m_currentUiToolStrategy = UiToolStrategyFactory::createStrategy(tool);
+        m_tool = tool;
+        m_inkPredictor.reset();
+        IUiToolStrategy* strategy = m_uiToolStrategies.strategy(tool);
+        if (m_currentUiToolStrategy && m_currentUiToolStrategy != strategy)
+        {
+            m_currentUiToolStrategy->deactivate(this);
+            updatePreview(QRect());
+        }
+        m_currentUiToolStrategy = strategy;
         if (m_currentUiToolStrategy)
             m_currentUiToolStrategy->updateCursor(this);
     }
 
+    bool PaintWidget::finishShape()
+    {
+        if (!m_currentUiToolStrategy || !m_currentUiToolStrategy->finish(this))
+            return false;
+
+        if (m_controller)
+            m_controller->finishShape(m_pen);
+        return true;
+    }
+
+    void PaintWidget::cancelShape()
+    {
+        if (m_currentUiToolStrategy)
+            m_currentUiToolStrategy->deactivate(this);
+        if (m_controller)
+            m_controller->cancelShape();
+    }
+
     void PaintWidget::toggleGrid(bool show)
     {
         m_showGrid = show;
@@ -234,19 +599,48 @@ namespace paint
         update();
     }
 
+    void PaintWidget::setShapeStyle(ShapeStyle style)
+    {
+        if (m_controller)
+            m_controller->setShapeStyle(style);
+        update();
+    }
+
+    void PaintWidget::setFillRule(FillRule rule)
+    {
+        if (m_controller)
+            m_controller->setFillRule(rule);
+        update();
+    }
+
     QSize PaintWidget::sizeHint() const
     {
-        return QSize(int(m_canvasImage.width() * m_zoom), int(m_canvasImage.height() * m_zoom));
+        return QSize(int(m_canvasSize.width() * m_zoom), int(m_canvasSize.height() * m_zoom));
     }
 
     void PaintWidget::updateCanvas()
     {
-        m_displayPixmap = QPixmap::fromImage(m_canvasImage);
+        if (m_controller)
+            m_canvasSize = m_controller->getCanvasSize();
+
         resize(sizeHint());
         updateGeometry();
         update();
     }
 
+    void PaintWidget::updatePreview(const QRect& canvasBounds)
+    {
+        const int margin = m_pen.width() / 2 + PREVIEW_MARGIN;
+        const QRect bounds = canvasBounds.isNull()
+            ? QRect()
+            : canvasBounds.adjusted(-margin, -margin, margin, margin);
+
+        const QRect dirty = m_previewBounds.united(bounds);
+        m_previewBounds = bounds;
+        if (!dirty.isEmpty())
+            update(toWidgetRect(dirty));
+    }
+
     void PaintWidget::notifyColorPicked(const QColor& color, bool leftButton)
     {
         emit colorPicked(color, leftButton);
@@ -263,6 +657,12 @@ namespace paint
             m_controller->loadImage(image);
     }
 
+    void PaintWidget::pasteImage(const QImage& image, const QPoint& topLeft)
+    {
+        if (m_controller)
+            m_controller->drawImage(image, topLeft);
+    }
+
     const QColor& PaintWidget::getPrimaryColor() const
     {
         return m_primaryColor;
@@ -278,9 +678,24 @@ namespace paint
         return m_pen;
     }
 
-    const QImage& PaintWidget::getCanvasImage() const
+    QImage PaintWidget::getCanvasImage() const
+    {
+        return m_controller ? m_controller->getImage() : QImage();
+    }
+
+    ICanvasImageConstPtr PaintWidget::getCanvasSnapshot() const
+    {
+        return m_controller ? m_controller->getSnapshot() : nullptr;
+    }
+
+    QColor PaintWidget::getCanvasPixelColor(const QPoint& canvasPos) const
+    {
+        return m_controller ? m_controller->getPixelColor(canvasPos) : QColor();
+    }
+
+    QSize PaintWidget::getCanvasSize() const
     {
-        return m_canvasImage;
+        return m_canvasSize;
     }
 
     qreal PaintWidget::getZoomLevel() const
@@ -288,9 +703,50 @@ namespace paint
         return m_zoom;
     }
 
+    ShapeStyle PaintWidget::getShapeStyle() const
+    {
+        return m_controller ? m_controller->getShapeStyle() : ShapeStyle::Outline;
+    }
+
+    FillRule PaintWidget::getFillRule() const
+    {
+        return m_controller ? m_controller->getFillRule() : FillRule::EvenOdd;
+    }
+
     void PaintWidget::updateToolCursor()
     {
         if (m_currentUiToolStrategy)
             m_currentUiToolStrategy->updateCursor(this);
     }
+
+    const QPixmap& PaintWidget::displayTile(int column, int row)
+    {
+        const int tileSize = m_controller->getTileSize();
+        const int columns = (m_canvasSize.width() + tileSize - 1) / tileSize;
+        const int rows = (m_canvasSize.height() + tileSize - 1) / tileSize;
+        if (m_tileColumns != columns || m_displayTiles.size() != static_cast<size_t>(columns) * rows)
+        {
+            m_displayTiles.assign(static_cast<size_t>(columns) * rows, DisplayTile());
+            m_tileColumns = columns;
+        }
+
+        DisplayTile& tile = m_displayTiles[static_cast<size_t>(row) * columns + column];
+        const quint64 version = m_controller->getTileVersion(column, row);
+        if (tile.pixmap.isNull() || version == 0 || tile.version != version)
+        {
+            tile.pixmap = QPixmap::fromImage(m_controller->getTileImage(column, row));
+            tile.version = version;
+        }
+        return tile.pixmap;
+    }
+
+    QRect PaintWidget::toWidgetRect(const QRect& canvasRect) const
+    {
+        return QRectF(QPointF(canvasRect.topLeft()) * m_zoom, QSizeF(canvasRect.size()) * m_zoom).toAlignedRect();
+    }
+
+    QRect PaintWidget::toCanvasRect(const QRect& widgetRect) const
+    {
+        return QRectF(QPointF(widgetRect.topLeft()) / m_zoom, QSizeF(widgetRect.size()) / m_zoom).toAlignedRect();
+    }
 }
\ No newline at end of file
@@ -3,19 +3,26 @@
 #include "ui_PaintWidget.h"
 
 #include "IUiToolStrategy.h"
+#include "UiToolStrategyFactory.h"
 #include "PaintController.h"
+#include "InkPredictor.h"
 #include "Enums.h"
 
+#include <QElapsedTimer>
+#include <QTabletEvent>
 #include <QMouseEvent>
+#include <QKeyEvent>
 #include <QPainter>
 #include <QWidget>
 #include <QPixmap>
 #include <QImage>
 #include <QStack>
 #include <QPoint>
+#include <QTimer>
 #include <QPen>
 
 #include <memory>
+#include <vector>
 #include <deque>
 
 namespace paint
@@ -32,8 +39,14 @@ namespace paint
         static constexpr qreal ZOOM_INCREMENT = 0.2;
         static constexpr int DEFAULT_CANVAS_WIDTH = 256;
         static constexpr int DEFAULT_CANVAS_HEIGHT = 256;
+        static constexpr int MAX_CANVAS_SIZE = 16384;
         static constexpr int DEFAULT_GRID_SIZE = 8;
         static constexpr int ERASER_SIZE_MULTIPLIER = 4;
+        static constexpr int POLYGON_CLOSE_DISTANCE = 6;
+        static constexpr int FRAME_INTERVAL_MS = 16;
+        static constexpr int PREDICTED_INK_ALPHA = 128;
+        static constexpr int PREVIEW_MARGIN = 2;
+        static constexpr qreal COMPLETION_OVERLAY_OPACITY = 0.5;
 
     public:
         PaintWidget(QWidget* parent = nullptr,
@@ -60,43 +73,88 @@ namespace paint
         void zoomIn();
         void zoomOut();
         void clearCanvas();
+        void newCanvas(int width, int height);
         void setTool(Tool tool);
+        bool finishShape();
+        void cancelShape();
         void loadImage(const QImage& image);
+        void pasteImage(const QImage& image, const QPoint& topLeft);
         void toggleGrid(bool show);
         void setGridSize(int size);
+        void setShapeStyle(ShapeStyle style);
+        void setFillRule(FillRule rule);
+        void setPredictedInkEnabled(bool enabled);
+        void setLatencyMeasurementEnabled(bool enabled);
+        void setCompletionOverlay(const QPixmap& overlay);
+        void clearCompletionOverlay();
 
         QPoint toCanvasPos(const QPoint& widgetPos) const;
         const QColor& getPrimaryColor() const;
         const QColor& getSecondaryColor() const;
         const QPen& getCurrentPen() const;
-        const QImage& getCanvasImage() const;
+        QImage getCanvasImage() const;
+        ICanvasImageConstPtr getCanvasSnapshot() const;
+        QColor getCanvasPixelColor(const QPoint& canvasPos) const;
+        QSize getCanvasSize() const;
         qreal getZoomLevel() const;
+        ShapeStyle getShapeStyle() const;
+        FillRule getFillRule() const;
 
         void updateToolCursor();
 
         void setController(PaintController* controller);
 
         void updateCanvas();
+        void updatePreview(const QRect& canvasBounds);
 
         void notifyColorPicked(const QColor& color, bool leftButton);
 
     signals:
         void colorPicked(const QColor& color, bool leftButton);
         void zoomChanged(qreal zoomLevel);
+        void latencyMeasured(qreal averageMs, qreal maxMs, qreal predictedLeadMs);
+        void strokeStarted();
+        void strokeFinished();
 
     protected:
         void paintEvent(QPaintEvent* event) override;
         void mousePressEvent(QMouseEvent* event) override;
         void mouseMoveEvent(QMouseEvent* event) override;
         void mouseReleaseEvent(QMouseEvent* event) override;
+        void mouseDoubleClickEvent(QMouseEvent* event) override;
+        void keyPressEvent(QKeyEvent* event) override;
         void wheelEvent(QWheelEvent* event) override;
+        void tabletEvent(QTabletEvent* event) override;
         QSize sizeHint() const override;
 
     private:
+        struct DisplayTile
+        {
+            QPixmap pixmap;
+            quint64 version = 0;
+        };
+
+        const QPixmap& displayTile(int column, int row);
+        QRect toCanvasRect(const QRect& widgetRect) const;
+        QRect toWidgetRect(const QRect& canvasRect) const;
+
+        StrokeSample toStrokeSample(const QTabletEvent* event) const;
+        void flushTabletSamples();
+
+        bool isPredictingInk() const;
+        qreal predictionHorizonMs() const;
+        QPolygonF predictedInk() const;
+        void updatePredictedInk();
+        void drawPredictedInk(QPainter& painter) const;
+        void beginLatencyStroke();
+        void trackLatencyInput(qint64 timestamp, quint64 previousFrame);
+        void finishLatencyStroke();
+
         Ui::PaintWidgetClass m_ui;
 
-        QImage m_canvasImage;
-        QPixmap m_displayPixmap;
+        QSize m_canvasSize;
+        std::vector<DisplayTile> m_displayTiles;
+        int m_tileColumns;
 
         QColor m_primaryColor;
         QColor m_secondaryColor;
@@ -107,11 +165,34 @@ namespace paint
 
         qreal m_zoom;
 
-        IUiToolStrategyUniquePtr m_currentUiToolStrategy;
+        UiToolStrategyRegistry m_uiToolStrategies;
+        IUiToolStrategy* m_currentUiToolStrategy;
+
+        QRect m_previewBounds;
+        QRect m_predictedInkBounds;
+        QPixmap m_completionOverlay;
 
         bool m_showGrid;
         int m_gridSize;
 
         PaintController* m_controller;
+        Tool m_tool;
+
+        InkPredictor m_inkPredictor;
+        bool m_predictedInkEnabled;
+        bool m_latencyMeasurementEnabled;
+
+        QTimer* m_tabletFlushTimer;
+        QVector<StrokeSample> m_pendingTabletSamples;
+        bool m_tabletActive;
+
+        QElapsedTimer m_latencyClock;
+        qint64 m_lastTabletFlush;
+        qint64 m_pendingLatencyStart;
+        quint64 m_pendingLatencyFrame;
+        bool m_latencyFramePresented;
+        qreal m_latencyTotalMs;
+        qreal m_latencyMaxMs;
+        int m_latencyCount;
     };
 }
\ No newline at end of file
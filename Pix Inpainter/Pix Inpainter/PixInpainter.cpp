@@ -1,7 +1,11 @@
 #include "PixInpainter.h"
+#include "CanvasImage.h"
 
+#include <QDialogButtonBox>
 #include <QColorDialog>
 #include <QImageReader>
+#include <QInputDialog>
+#include <QFormLayout>
 #include <QScrollArea>
 #include <QFileDialog>
 #include <QMessageBox>
@@ -10,7 +14,9 @@
 #include <QClipboard>
 #include <QGroupBox>
 #include <QMenuBar>
+#include <QSpinBox>
 #include <QBuffer>
+#include <QDialog>
 #include <QLabel>
 
 PixInpainter::PixInpainter(QWidget *parent)
@@ -36,7 +42,9 @@ PixInpainter::~PixInpainter()
 
 void PixInpainter::setupMainUI()
 {
-    m_canvasModel = paint::ICanvasModel::create(256, 256);
+    m_taskPool = paint::WorkStealingPool::create();
+
+    m_canvasModel = paint::ICanvasModel::create(256, 256, m_taskPool);
 
     m_paintWidget = new paint::PaintWidget(this, 256, 256);
 
@@ -44,11 +52,27 @@ void PixInpainter::setupMainUI()
 
     m_paintWidget->setController(m_paintController);
 
+    m_requestScheduler = new paint::RequestScheduler(this);
+
+    m_liveCompletionController = new paint::LiveCompletionController(this, m_paintWidget, m_paintController, m_taskPool, m_requestScheduler);
+
     connect(m_paintWidget, &paint::PaintWidget::zoomChanged,
         this, [this](qreal zoomLevel) {
             statusBar()->showMessage(QString("Zoom level: %1%").arg(zoomLevel * 100, 0, 'f', 0), 2000);
         });
 
+    connect(m_paintWidget, &paint::PaintWidget::latencyMeasured,
+        this, [this](qreal averageMs, qreal maxMs, qreal predictedLeadMs) {
+            QString message = QString("Input latency: avg %1 ms, max %2 ms")
+                .arg(averageMs, 0, 'f', 1)
+                .arg(maxMs, 0, 'f', 1);
+            if (predictedLeadMs > 0.0)
+                message += QString(", predicted ink leads by %1 ms").arg(predictedLeadMs, 0, 'f', 1);
+            if (maxMs > paint::PaintWidget::FRAME_INTERVAL_MS)
+                message += " (over frame budget)";
+            statusBar()->showMessage(message, 3000);
+        });
+
     QScrollArea* scrollArea = new QScrollArea(this);
     scrollArea->setWidget(m_paintWidget);
     scrollArea->setWidgetResizable(false);
@@ -70,6 +94,10 @@ void PixInpainter::setupMenus()
 {
     QMenu* fileMenu = menuBar()->addMenu(tr("File"));
 
+    QAction* newAction = fileMenu->addAction(tr("New..."));
+    newAction->setShortcut(QKeySequence::New);
+    connect(newAction, &QAction::triggered, this, &PixInpainter::newCanvas);
+
     QAction* openAction = fileMenu->addAction(tr("Open..."));
     openAction->setShortcut(QKeySequence::Open);
     connect(openAction, &QAction::triggered, this, &PixInpainter::loadImageFromFile);
@@ -128,6 +156,27 @@ void PixInpainter::setupMenus()
     toggleGridAction->setShortcut(QKeySequence(Qt::CTRL | Qt::Key_G));
     connect(toggleGridAction, &QAction::toggled, this, &PixInpainter::toggleGrid);
 
+    viewMenu->addSeparator();
+    QAction* predictedInkAction = viewMenu->addAction(tr("Predicted Ink"));
+    predictedInkAction->setCheckable(true);
+    predictedInkAction->setChecked(true);
+    connect(predictedInkAction, &QAction::toggled, this, &PixInpainter::togglePredictedInk);
+
+    QAction* latencyAction = viewMenu->addAction(tr("Measure Input Latency"));
+    latencyAction->setCheckable(true);
+    connect(latencyAction, &QAction::toggled, this, &PixInpainter::toggleLatencyMeasurement);
+
+    viewMenu->addSeparator();
+    QAction* liveCompletionAction = viewMenu->addAction(tr("Live AI Completion"));
+    liveCompletionAction->setCheckable(true);
+    connect(liveCompletionAction, &QAction::toggled, this, &PixInpainter::toggleLiveCompletion);
+
+    QAction* liveCompletionDelayAction = viewMenu->addAction(tr("Live Completion Delay..."));
+    connect(liveCompletionDelayAction, &QAction::triggered, this, &PixInpainter::setLiveCompletionDelay);
+
+    QAction* taskStatisticsAction = viewMenu->addAction(tr("Task Statistics..."));
+    connect(taskStatisticsAction, &QAction::triggered, this, &PixInpainter::showTaskStatistics);
+
     QMenu* toolsMenu = menuBar()->addMenu(tr("Tools"));
 
     if (m_penAction)
@@ -177,6 +226,23 @@ void PixInpainter::setupMenus()
         m_triangleAction->setShortcut(QKeySequence(Qt::Key_T));
         toolsMenu->addAction(m_triangleAction);
     }
+
+    if (m_polygonAction)
+    {
+        m_polygonAction->setShortcut(QKeySequence(Qt::Key_Y));
+        toolsMenu->addAction(m_polygonAction);
+    }
+
+    if (m_lassoAction)
+    {
+        m_lassoAction->setShortcut(QKeySequence(Qt::Key_S));
+        toolsMenu->addAction(m_lassoAction);
+    }
+
+    toolsMenu->addSeparator();
+    QAction* nonZeroFillAction = toolsMenu->addAction(tr("Non-Zero Fill Rule"));
+    nonZeroFillAction->setCheckable(true);
+    connect(nonZeroFillAction, &QAction::toggled, this, &PixInpainter::toggleNonZeroFillRule);
 }
 
 void PixInpainter::setupToolbar()
@@ -259,6 +325,18 @@ void PixInpainter::setupDrawingTools(QToolBar* toolbar)
     );
     m_triangleAction = triangleButton->defaultAction();
 
+    QToolButton* polygonButton = createToolButton(
+        QIcon(":/icons/Polygon.png"),
+        "Polygon"
+    );
+    m_polygonAction = polygonButton->defaultAction();
+
+    QToolButton* lassoButton = createToolButton(
+        QIcon(":/icons/Lasso.png"),
+        "Lasso"
+    );
+    m_lassoAction = lassoButton->defaultAction();
+
     gridLayout->addWidget(penButton, 0, 0);
     gridLayout->addWidget(eraserButton, 1, 0);
     gridLayout->addWidget(fillButton, 0, 1);
@@ -267,6 +345,8 @@ void PixInpainter::setupDrawingTools(QToolBar* toolbar)
     gridLayout->addWidget(triangleButton, 1, 2);
     gridLayout->addWidget(rectangleButton, 0, 3);
     gridLayout->addWidget(ellipseButton, 1, 3);
+    gridLayout->addWidget(polygonButton, 0, 4);
+    gridLayout->addWidget(lassoButton, 1, 4);
 
     toolbar->addWidget(drawingToolsContainer);
 }
@@ -394,6 +474,13 @@ void PixInpainter::setupColorAndPenSizeControls(QToolBar* toolbar)
 
     layout->addWidget(m_penSizeComboBox);
 
+    m_fillShapesCheckBox = new QCheckBox("Fill Shapes", this);
+    m_fillShapesCheckBox->setFont(font);
+    m_fillShapesCheckBox->setToolTip("Draw rectangles, ellipses and triangles filled");
+    connect(m_fillShapesCheckBox, &QCheckBox::toggled, this, &PixInpainter::toggleShapeFill);
+
+    layout->addWidget(m_fillShapesCheckBox);
+
     toolbar->addWidget(colorContainer);
 }
 
@@ -520,6 +607,8 @@ void PixInpainter::connectToolActions()
     connect(m_rectangleAction, &QAction::triggered, this, &PixInpainter::onRectangleToolSelected);
     connect(m_ellipseAction, &QAction::triggered, this, &PixInpainter::onEllipseToolSelected);
     connect(m_triangleAction, &QAction::triggered, this, &PixInpainter::onTriangleToolSelected);
+    connect(m_polygonAction, &QAction::triggered, this, &PixInpainter::onPolygonToolSelected);
+    connect(m_lassoAction, &QAction::triggered, this, &PixInpainter::onLassoToolSelected);
 }
 
 void PixInpainter::onPenToolSelected()
@@ -586,6 +675,22 @@ void PixInpainter::onTriangleToolSelected()
     statusBar()->showMessage("Triangle tool selected", 2000);
 }
 
+void PixInpainter::onPolygonToolSelected()
+{
+    m_previousToolAction = m_polygonAction;
+    m_paintWidget->setTool(paint::Tool::Polygon);
+    m_paintController->setTool(paint::Tool::Polygon);
+    statusBar()->showMessage("Polygon tool selected, click near the first vertex, double-click or press Enter to close, Esc to cancel", 2000);
+}
+
+void PixInpainter::onLassoToolSelected()
+{
+    m_previousToolAction = m_lassoAction;
+    m_paintWidget->setTool(paint::Tool::Lasso);
+    m_paintController->setTool(paint::Tool::Lasso);
+    statusBar()->showMessage("Lasso tool selected", 2000);
+}
+
 void PixInpainter::onUndo()
 {
     m_paintWidget->undo();
@@ -656,6 +761,37 @@ void PixInpainter::clearCanvas()
     statusBar()->showMessage("Canvas cleared", 2000);
 }
 
+void PixInpainter::newCanvas()
+{
+    const QSize currentSize = m_paintWidget->getCanvasSize();
+
+    QDialog dialog(this);
+    dialog.setWindowTitle("New Canvas");
+
+    QSpinBox* widthSpinBox = new QSpinBox(&dialog);
+    widthSpinBox->setRange(1, paint::PaintWidget::MAX_CANVAS_SIZE);
+    widthSpinBox->setValue(currentSize.width());
+
+    QSpinBox* heightSpinBox = new QSpinBox(&dialog);
+    heightSpinBox->setRange(1, paint::PaintWidget::MAX_CANVAS_SIZE);
+    heightSpinBox->setValue(currentSize.height());
+
+    QDialogButtonBox* buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+    connect(buttonBox, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttonBox, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+
+    QFormLayout* layout = new QFormLayout(&dialog);
+    layout->addRow("Width:", widthSpinBox);
+    layout->addRow("Height:", heightSpinBox);
+    layout->addRow(buttonBox);
+
+    if (dialog.exec() == QDialog::Accepted)
+    {
+        m_paintWidget->newCanvas(widthSpinBox->value(), heightSpinBox->value());
+        statusBar()->showMessage(QString("New canvas: %1x%2").arg(widthSpinBox->value()).arg(heightSpinBox->value()), 2000);
+    }
+}
+
 void PixInpainter::loadImageFromFile()
 {
     QString fileName = QFileDialog::getOpenFileName(
@@ -671,7 +807,7 @@ void PixInpainter::loadImageFromFile()
         QImage image = reader.read();
         if (!image.isNull())
         {
-            m_paintWidget->loadImage(image.convertToFormat(QImage::Format_ARGB32));
+            m_paintWidget->loadImage(image.convertToFormat(paint::CanvasImage::FORMAT));
             statusBar()->showMessage(QString("Image loaded: %1").arg(QFileInfo(fileName).fileName()), 2000);
         }
         else
@@ -693,7 +829,7 @@ void PixInpainter::saveImageToFile()
 
     if (!fileName.isEmpty())
     {
-        const QImage& canvasImage = m_paintWidget->getCanvasImage();
+        const QImage canvasImage = m_paintWidget->getCanvasImage().convertToFormat(paint::CanvasImage::EXPORT_FORMAT);
         if (!canvasImage.save(fileName))
         {
             QMessageBox::warning(this, "Error", "Failed to save image");
@@ -746,11 +882,76 @@ void PixInpainter::updatePenSize(int index)
     }
 }
 
+void PixInpainter::toggleShapeFill(bool filled)
+{
+    m_paintWidget->setShapeStyle(filled ? paint::ShapeStyle::Filled : paint::ShapeStyle::Outline);
+    statusBar()->showMessage(filled ? QString("Shapes will be filled") : QString("Shapes will be outlined"), 2000);
+}
+
+void PixInpainter::toggleNonZeroFillRule(bool nonZero)
+{
+    m_paintWidget->setFillRule(nonZero ? paint::FillRule::NonZero : paint::FillRule::EvenOdd);
+    statusBar()->showMessage(nonZero ? QString("Polygons use the non-zero fill rule") : QString("Polygons use the even-odd fill rule"), 2000);
+}
+
+void PixInpainter::togglePredictedInk(bool enabled)
+{
+    m_paintWidget->setPredictedInkEnabled(enabled);
+    statusBar()->showMessage(enabled ? QString("Predicted ink enabled") : QString("Predicted ink disabled"), 2000);
+}
+
+void PixInpainter::toggleLatencyMeasurement(bool enabled)
+{
+    m_paintWidget->setLatencyMeasurementEnabled(enabled);
+    statusBar()->showMessage(enabled ? QString("Input latency is reported after each stroke") : QString("Input latency measurement disabled"), 2000);
+}
+
+void PixInpainter::toggleLiveCompletion(bool enabled)
+{
+    m_liveCompletionController->setEnabled(enabled);
+    statusBar()->showMessage(enabled ? QString("Live AI completion shows a suggestion after you pause drawing") : QString("Live AI completion disabled"), 2000);
+}
+
+void PixInpainter::setLiveCompletionDelay()
+{
+    bool accepted = false;
+    const int delay = QInputDialog::getInt(this, tr("Live Completion Delay"), tr("Pause before requesting (ms):"),
+        m_liveCompletionController->debounceInterval(),
+        paint::LiveCompletionController::MIN_DEBOUNCE_MS, paint::LiveCompletionController::MAX_DEBOUNCE_MS, 100, &accepted);
+    if (accepted)
+        m_liveCompletionController->setDebounceInterval(delay);
+}
+
+void PixInpainter::showTaskStatistics()
+{
+    if (!m_taskPool)
+        return;
+
+    const QHash<QString, paint::TaskCounters> counters = m_taskPool->counters();
+    QStringList labels = counters.keys();
+    labels.sort();
+
+    QStringList lines;
+    lines.append(QString("%1 worker threads").arg(m_taskPool->threadCount()));
+    for (const QString& label : labels)
+    {
+        const paint::TaskCounters& counter = counters[label];
+        lines.append(QString("%1: %2 tasks, avg wait %3 ms, avg run %4 ms, max run %5 ms")
+            .arg(label)
+            .arg(counter.count)
+            .arg(counter.totalQueuedNs / 1.0e6 / counter.count, 0, 'f', 2)
+            .arg(counter.totalRunNs / 1.0e6 / counter.count, 0, 'f', 2)
+            .arg(counter.maxRunNs / 1.0e6, 0, 'f', 2));
+    }
+
+    QMessageBox::information(this, "Task Statistics", lines.join("\n"));
+}
+
 void PixInpainter::showAICompletionWidget()
 {
     if (!m_aiCompletionModel)
     {
-        m_aiCompletionModel = new paint::AICompletionModel(this);
+        m_aiCompletionModel = new paint::AICompletionModel(this, m_taskPool, m_requestScheduler);
         m_aiCompletionController = new paint::AICompletionController(this, m_aiCompletionModel);
     }
     else
@@ -775,6 +976,15 @@ void PixInpainter::showAICompletionWidget()
         connect(m_aiCompletionWidget, &paint::AICompletionWidget::applyResultToCanvasRequested,
             this, &PixInpainter::onResultImageAppliedToCanvas);
 
+        connect(m_aiCompletionWidget, &paint::AICompletionWidget::modelSelectionChanged, this, [this]()
+            {
+                if (m_aiCompletionWidget)
+                {
+                    m_liveCompletionController->setModel(m_aiCompletionWidget->getSelectedModelKey(),
+                        m_aiCompletionWidget->getProcessTabPostprocessValue());
+                }
+            });
+
         if (m_aiCompletionController)
         {
             m_aiCompletionController->setView(m_aiCompletionWidget);
@@ -788,18 +998,12 @@ void PixInpainter::showAICompletionWidget()
         }
     }
 
-    QByteArray imageData;
-    QBuffer buffer(&imageData);
-    buffer.open(QIODevice::WriteOnly);
-    if (m_paintWidget)
-    {
-        m_paintWidget->getCanvasImage().save(&buffer, "PNG");
-    }
-    buffer.close();
-
-    if (m_aiCompletionController)
+    if (m_aiCompletionController && m_paintWidget)
     {
-        m_aiCompletionController->setImageData(imageData);
+        const paint::ICanvasImageConstPtr snapshot = m_paintWidget->getCanvasSnapshot();
+        m_aiCompletionController->setImageSource([snapshot]() {
+            return paint::PaintController::toQImage(snapshot);
+        });
     }
 
     m_aiCompletionWidget->show();
@@ -812,10 +1016,19 @@ void PixInpainter::onResultImageAppliedToCanvas(const QPixmap& pixmap)
     if (!pixmap.isNull() && m_paintWidget)
     {
         QImage image = pixmap.toImage();
-        if (image.format() != QImage::Format_ARGB32)
+        if (image.format() != paint::CanvasImage::FORMAT)
         {
-            image = image.convertToFormat(QImage::Format_ARGB32);
+            image = image.convertToFormat(paint::CanvasImage::FORMAT);
         }
+
+        const QRect region = m_aiCompletionModel ? m_aiCompletionModel->resultRegion(pixmap) : QRect();
+        if (!region.isEmpty() && image.rect().contains(region))
+        {
+            m_paintWidget->pasteImage(image.copy(region), region.topLeft());
+            statusBar()->showMessage("Result region applied to canvas.", 3000);
+            return;
+        }
+
         m_paintWidget->loadImage(image);
         statusBar()->showMessage("Result image applied to canvas.", 3000);
     }
@@ -828,7 +1041,7 @@ void PixInpainter::copyCanvas()
 
     if (!canvasImage.isNull())
     {
-        QImage copyImage = canvasImage.copy();
+        QImage copyImage = canvasImage.convertToFormat(paint::CanvasImage::EXPORT_FORMAT);
         clipboard->setImage(copyImage);
 
         statusBar()->showMessage("Image copied to clipboard", 2000);
@@ -842,7 +1055,7 @@ void PixInpainter::pasteCanvas()
 
     if (!image.isNull())
     {
-        QImage convertedImage = image.convertToFormat(QImage::Format_ARGB32);
+        QImage convertedImage = image.convertToFormat(paint::CanvasImage::FORMAT);
         m_paintWidget->loadImage(convertedImage);
 
         statusBar()->showMessage("Image pasted from clipboard", 2000);
@@ -6,7 +6,9 @@
 #include "AICompletionWidget.h"
 #include "AICompletionController.h"
 #include "AICompletionModel.h"
+#include "LiveCompletionController.h"
 #include "PaintWidget.h"
+#include "WorkStealingPool.h"
 
 #include <QActionGroup>
 #include <QToolButton>
@@ -68,9 +70,12 @@ private slots:
     void onRectangleToolSelected();
     void onEllipseToolSelected();
     void onTriangleToolSelected();
+    void onPolygonToolSelected();
+    void onLassoToolSelected();
 
     void resetZoom();
     void clearCanvas();
+    void newCanvas();
     void loadImageFromFile();
 
     void toggleGrid(bool show);
@@ -88,6 +93,13 @@ private slots:
     void onRedo();
 
     void updatePenSize(int index);
+    void toggleShapeFill(bool filled);
+    void toggleNonZeroFillRule(bool nonZero);
+    void togglePredictedInk(bool enabled);
+    void toggleLatencyMeasurement(bool enabled);
+    void showTaskStatistics();
+    void toggleLiveCompletion(bool enabled);
+    void setLiveCompletionDelay();
 
     void onResultImageAppliedToCanvas(const QPixmap& image);
 
@@ -123,6 +135,8 @@ private:
     QAction* m_rectangleAction;
     QAction* m_ellipseAction;
     QAction* m_triangleAction;
+    QAction* m_polygonAction;
+    QAction* m_lassoAction;
     QAction* m_previousToolAction;
 
     QAction* m_AICompletionAction;
@@ -133,12 +147,16 @@ private:
     QComboBox* m_gridSizeComboBox;
 
     QComboBox* m_penSizeComboBox;
+    QCheckBox* m_fillShapesCheckBox;
     int m_currentPenSize = PEN_SIZE_MEDIUM;
 
     paint::PaintController* m_paintController;
+    paint::WorkStealingPoolPtr m_taskPool;
     paint::ICanvasModelPtr m_canvasModel;
 
+    paint::RequestScheduler* m_requestScheduler;
     paint::AICompletionModel* m_aiCompletionModel;
     paint::AICompletionController* m_aiCompletionController;
+    paint::LiveCompletionController* m_liveCompletionController;
 };
 
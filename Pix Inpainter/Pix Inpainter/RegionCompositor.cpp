@@ -0,0 +1,170 @@
+#include "RegionCompositor.h"
+
+#include <algorithm>
+
+namespace paint
+{
+    namespace
+    {
+        QList<int> tileStarts(int start, int length, int tile, int overlap)
+        {
+            if (length <= tile)
+                return { start };
+
+            const int stride = std::max(tile - overlap, 1);
+            QList<int> starts;
+            for (int offset = 0; offset + tile < length; offset += stride)
+                starts.append(start + offset);
+            starts.append(start + length - tile);
+            return starts;
+        }
+
+        int rampWeight(int position, int tileStart, int tileEnd, int boundsStart, int boundsEnd, int overlap)
+        {
+            int weight = overlap + 1;
+            if (tileStart > boundsStart)
+                weight = std::min(weight, position - tileStart + 1);
+            if (tileEnd < boundsEnd)
+                weight = std::min(weight, tileEnd - position + 1);
+            return weight;
+        }
+    }
+
+    QRect RegionCompositor::contextRect(const QRect& region, const QRect& bounds, int margin)
+    {
+        if (region.isEmpty())
+            return QRect();
+        return region.adjusted(-margin, -margin, margin, margin).intersected(bounds);
+    }
+
+    QRect RegionCompositor::blendRect(const QRect& region, const QRect& bounds, int feather)
+    {
+        return contextRect(region, bounds, std::max(feather, 0));
+    }
+
+    QImage RegionCompositor::stitch(const QImage& source, const QImage& patch, const QRect& patchRect, const QRect& region, int feather)
+    {
+        if (source.isNull() || patch.isNull() || patchRect.isEmpty())
+            return source;
+
+        QImage result = source.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        const QImage scaled = (patch.size() == patchRect.size() ? patch : patch.scaled(patchRect.size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation))
+            .convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+        feather = std::max(feather, 0);
+        const QRect blend = blendRect(region, result.rect(), feather).intersected(patchRect);
+        for (int y = blend.top(); y <= blend.bottom(); ++y)
+        {
+            QRgb* out = reinterpret_cast<QRgb*>(result.scanLine(y));
+            const QRgb* in = reinterpret_cast<const QRgb*>(scaled.constScanLine(y - patchRect.top()));
+            const int dy = std::max({ region.top() - y, y - region.bottom(), 0 });
+
+            for (int x = blend.left(); x <= blend.right(); ++x)
+            {
+                const int dx = std::max({ region.left() - x, x - region.right(), 0 });
+                const int distance = std::max(dx, dy);
+                if (distance == 0)
+                {
+                    out[x] = in[x - patchRect.left()];
+                    continue;
+                }
+
+                const int weight = 256 * (feather + 1 - distance) / (feather + 1);
+                out[x] = mix(out[x], in[x - patchRect.left()], weight);
+            }
+        }
+        return result;
+    }
+
+    QList<QRect> RegionCompositor::tileRects(const QRect& bounds, const QSize& tileSize, int overlap)
+    {
+        if (bounds.isEmpty() || tileSize.isEmpty())
+            return {};
+
+        overlap = std::clamp(overlap, 0, std::min(tileSize.width(), tileSize.height()) - 1);
+        const int width = std::min(tileSize.width(), bounds.width());
+        const int height = std::min(tileSize.height(), bounds.height());
+
+        QList<QRect> tiles;
+        for (const int y : tileStarts(bounds.top(), bounds.height(), height, overlap))
+        {
+            for (const int x : tileStarts(bounds.left(), bounds.width(), width, overlap))
+                tiles.append(QRect(x, y, width, height));
+        }
+        return tiles;
+    }
+
+    QImage RegionCompositor::mergeTiles(const QRect& bounds, const QList<QRect>& tiles, const std::vector<QImage>& images, int overlap)
+    {
+        if (bounds.isEmpty() || tiles.size() != static_cast<qsizetype>(images.size()))
+            return QImage();
+
+        overlap = std::max(overlap, 0);
+        std::vector<QImage> converted;
+        converted.reserve(images.size());
+        for (qsizetype i = 0; i < tiles.size(); ++i)
+        {
+            const QImage& image = images[i];
+            if (image.isNull())
+                return QImage();
+
+            const QImage scaled = image.size() == tiles[i].size() ? image : image.scaled(tiles[i].size(), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+            converted.push_back(scaled.convertToFormat(QImage::Format_ARGB32_Premultiplied));
+        }
+
+        QImage result(bounds.size(), QImage::Format_ARGB32_Premultiplied);
+        result.fill(Qt::transparent);
+
+        std::vector<quint32> channels(static_cast<size_t>(bounds.width()) * 4);
+        std::vector<quint32> weights(static_cast<size_t>(bounds.width()));
+        for (int y = bounds.top(); y <= bounds.bottom(); ++y)
+        {
+            std::fill(channels.begin(), channels.end(), 0);
+            std::fill(weights.begin(), weights.end(), 0);
+
+            for (qsizetype i = 0; i < tiles.size(); ++i)
+            {
+                const QRect& tile = tiles[i];
+                if (y < tile.top() || y > tile.bottom())
+                    continue;
+
+                const int weightY = rampWeight(y, tile.top(), tile.bottom(), bounds.top(), bounds.bottom(), overlap);
+                const QRgb* in = reinterpret_cast<const QRgb*>(converted[i].constScanLine(y - tile.top()));
+                const int left = std::max(tile.left(), bounds.left());
+                const int right = std::min(tile.right(), bounds.right());
+                for (int x = left; x <= right; ++x)
+                {
+                    const quint32 weight = weightY * rampWeight(x, tile.left(), tile.right(), bounds.left(), bounds.right(), overlap);
+                    const QRgb pixel = in[x - tile.left()];
+                    const size_t column = static_cast<size_t>(x - bounds.left());
+                    channels[column * 4] += qRed(pixel) * weight;
+                    channels[column * 4 + 1] += qGreen(pixel) * weight;
+                    channels[column * 4 + 2] += qBlue(pixel) * weight;
+                    channels[column * 4 + 3] += qAlpha(pixel) * weight;
+                    weights[column] += weight;
+                }
+            }
+
+            QRgb* out = reinterpret_cast<QRgb*>(result.scanLine(y - bounds.top()));
+            for (size_t column = 0; column < weights.size(); ++column)
+            {
+                const quint32 weight = weights[column];
+                if (weight == 0)
+                    continue;
+
+                out[column] = qRgba(channels[column * 4] / weight, channels[column * 4 + 1] / weight,
+                    channels[column * 4 + 2] / weight, channels[column * 4 + 3] / weight);
+            }
+        }
+        return result;
+    }
+
+    QRgb RegionCompositor::mix(QRgb from, QRgb to, int weight)
+    {
+        const int inverse = 256 - weight;
+        return qRgba((qRed(from) * inverse + qRed(to) * weight) >> 8,
+            (qGreen(from) * inverse + qGreen(to) * weight) >> 8,
+            (qBlue(from) * inverse + qBlue(to) * weight) >> 8,
+            (qAlpha(from) * inverse + qAlpha(to) * weight) >> 8);
+    }
+}
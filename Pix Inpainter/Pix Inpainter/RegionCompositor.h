@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QImage>
+#include <QList>
+#include <QRect>
+#include <QRgb>
+
+#include <vector>
+
+namespace paint
+{
+    class RegionCompositor
+    {
+    public:
+        static constexpr int DEFAULT_CONTEXT_MARGIN = 32;
+        static constexpr int DEFAULT_FEATHER = 8;
+        static constexpr int DEFAULT_TILE_OVERLAP = 32;
+
+    public:
+        RegionCompositor() = delete;
+
+        static QRect contextRect(const QRect& region, const QRect& bounds, int margin = DEFAULT_CONTEXT_MARGIN);
+        static QRect blendRect(const QRect& region, const QRect& bounds, int feather = DEFAULT_FEATHER);
+        static QImage stitch(const QImage& source, const QImage& patch, const QRect& patchRect, const QRect& region,
+            int feather = DEFAULT_FEATHER);
+        static QList<QRect> tileRects(const QRect& bounds, const QSize& tileSize, int overlap = DEFAULT_TILE_OVERLAP);
+        static QImage mergeTiles(const QRect& bounds, const QList<QRect>& tiles, const std::vector<QImage>& images,
+            int overlap = DEFAULT_TILE_OVERLAP);
+        static QRgb mix(QRgb from, QRgb to, int weight);
+    };
+}
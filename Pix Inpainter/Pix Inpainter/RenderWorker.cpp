@@ -0,0 +1,94 @@
+#include "RenderWorker.h"
+
+namespace paint
+{
+    RenderWorkerUniquePtr RenderWorker::create(ICanvasModelPtr model, FrameReadyCallback onFrameReady)
+    {
+        return std::make_unique<RenderWorker>(std::move(model), std::move(onFrameReady));
+    }
+
+    RenderWorker::RenderWorker(ICanvasModelPtr model, FrameReadyCallback onFrameReady)
+        : m_model(std::move(model))
+        , m_onFrameReady(std::move(onFrameReady))
+    {
+        m_thread = std::jthread([this](std::stop_token stopToken) { run(stopToken); });
+    }
+
+    RenderWorker::~RenderWorker()
+    {
+        m_thread.request_stop();
+        wake();
+    }
+
+    void RenderWorker::submit(Command command)
+    {
+        if (!command) return;
+        m_commands.push(std::move(command));
+        wake();
+    }
+
+    quint64 RenderWorker::requestFrame()
+    {
+        const quint64 request = ++m_lastRequest;
+        m_commands.push([this, request](ICanvasModel&) {
+            m_completedRequest = request;
+            m_frameRequested.store(true, std::memory_order_relaxed);
+        });
+        wake();
+        return request;
+    }
+
+    bool RenderWorker::acquireFrame()
+    {
+        m_frameNotified.store(false, std::memory_order_release);
+        return m_frames.acquire();
+    }
+
+    const RenderFrame& RenderWorker::frame() const
+    {
+        return m_frames.front();
+    }
+
+    void RenderWorker::run(std::stop_token stopToken)
+    {
+        while (!stopToken.stop_requested())
+        {
+            if (m_pending.exchange(0, std::memory_order_acquire) == 0)
+            {
+                m_pending.wait(0, std::memory_order_acquire);
+                continue;
+            }
+
+            Command command;
+            while (m_commands.pop(command))
+            {
+                if (m_model)
+                    command(*m_model);
+            }
+
+            if (m_frameRequested.exchange(false, std::memory_order_relaxed))
+                publishFrame();
+        }
+    }
+
+    void RenderWorker::wake()
+    {
+        m_pending.fetch_add(1, std::memory_order_release);
+        m_pending.notify_one();
+    }
+
+    void RenderWorker::publishFrame()
+    {
+        RenderFrame frame;
+        frame.image = m_model ? m_model->snapshot() : nullptr;
+        frame.canUndo = m_model && m_model->canUndo();
+        frame.canRedo = m_model && m_model->canRedo();
+        frame.contentHash = m_model ? m_model->contentHash() : 0;
+        frame.serial = ++m_frameSerial;
+        frame.request = m_completedRequest;
+        m_frames.publish(std::move(frame));
+
+        if (!m_frameNotified.exchange(true, std::memory_order_acq_rel) && m_onFrameReady)
+            m_onFrameReady();
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ICanvasModel.h"
+#include "LockFreeQueue.h"
+#include "TripleBuffer.h"
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+
+namespace paint
+{
+    struct RenderFrame
+    {
+        ICanvasImageConstPtr image;
+        bool canUndo = false;
+        bool canRedo = false;
+        quint64 contentHash = 0;
+        quint64 serial = 0;
+        quint64 request = 0;
+    };
+
+    class RenderWorker;
+    using RenderWorkerUniquePtr = std::unique_ptr<RenderWorker>;
+
+    class RenderWorker
+    {
+    public:
+        using Command = std::function<void(ICanvasModel&)>;
+        using FrameReadyCallback = std::function<void()>;
+
+    public:
+        RenderWorker(ICanvasModelPtr model, FrameReadyCallback onFrameReady);
+        ~RenderWorker();
+
+        RenderWorker(const RenderWorker&) = delete;
+        RenderWorker& operator=(const RenderWorker&) = delete;
+        RenderWorker(RenderWorker&&) = delete;
+        RenderWorker& operator=(RenderWorker&&) = delete;
+
+        void submit(Command command);
+        quint64 requestFrame();
+
+        bool acquireFrame();
+        const RenderFrame& frame() const;
+
+        static RenderWorkerUniquePtr create(ICanvasModelPtr model, FrameReadyCallback onFrameReady);
+
+    private:
+        void run(std::stop_token stopToken);
+        void wake();
+        void publishFrame();
+
+        ICanvasModelPtr m_model;
+        FrameReadyCallback m_onFrameReady;
+
+        LockFreeQueue<Command> m_commands;
+        std::atomic<quint32> m_pending{ 0 };
+        std::atomic<bool> m_frameRequested{ false };
+        std::atomic<bool> m_frameNotified{ false };
+
+        TripleBuffer<RenderFrame> m_frames;
+        quint64 m_frameSerial = 0;
+        quint64 m_lastRequest = 0;
+        quint64 m_completedRequest = 0;
+
+        std::jthread m_thread;
+    };
+}
@@ -0,0 +1,136 @@
+#include "RequestScheduler.h"
+
+#include <algorithm>
+
+namespace paint
+{
+    RequestScheduler::RequestScheduler(QObject* parent, int maxInFlight)
+        : QObject(parent)
+        , m_maxInFlight(std::max(maxInFlight, 1))
+        , m_nextTicket(0)
+    {
+    }
+
+    quint64 RequestScheduler::enqueue(RequestPriority priority, const QString& supersessionKey, Starter start, Canceller cancelled,
+        const QObject* owner)
+    {
+        if (!supersessionKey.isEmpty())
+            supersede(owner, supersessionKey);
+
+        const quint64 ticket = ++m_nextTicket;
+        m_queues[static_cast<size_t>(priority)].push_back({ ticket, owner, supersessionKey, std::move(start), std::move(cancelled) });
+
+        dispatch();
+        emit queueChanged(queuedCount(), inFlightCount());
+        return ticket;
+    }
+
+    bool RequestScheduler::cancel(quint64 ticket)
+    {
+        for (auto& queue : m_queues)
+        {
+            auto found = std::find_if(queue.begin(), queue.end(), [ticket](const Pending& pending) { return pending.ticket == ticket; });
+            if (found == queue.end())
+                continue;
+
+            const Canceller cancelled = std::move(found->cancelled);
+            queue.erase(found);
+            if (cancelled)
+                cancelled();
+
+            emit queueChanged(queuedCount(), inFlightCount());
+            return true;
+        }
+        return false;
+    }
+
+    void RequestScheduler::clear()
+    {
+        for (auto& queue : m_queues)
+            queue.clear();
+    }
+
+    void RequestScheduler::clear(const QObject* owner)
+    {
+        for (auto& queue : m_queues)
+            queue.erase(std::remove_if(queue.begin(), queue.end(), [owner](const Pending& pending) { return pending.owner == owner; }), queue.end());
+    }
+
+    void RequestScheduler::setMaxInFlight(int maxInFlight)
+    {
+        m_maxInFlight = std::max(maxInFlight, 1);
+        dispatch();
+    }
+
+    int RequestScheduler::maxInFlight() const
+    {
+        return m_maxInFlight;
+    }
+
+    int RequestScheduler::queuedCount() const
+    {
+        int count = 0;
+        for (const auto& queue : m_queues)
+            count += static_cast<int>(queue.size());
+        return count;
+    }
+
+    int RequestScheduler::inFlightCount() const
+    {
+        return static_cast<int>(m_inFlight.size());
+    }
+
+    void RequestScheduler::dispatch()
+    {
+        while (m_inFlight.size() < m_maxInFlight)
+        {
+            auto queue = std::find_if(m_queues.begin(), m_queues.end(), [](const auto& candidate) { return !candidate.empty(); });
+            if (queue == m_queues.end())
+                return;
+
+            Pending next = std::move(queue->front());
+            queue->pop_front();
+
+            QNetworkReply* reply = next.start ? next.start() : nullptr;
+            if (!reply)
+            {
+                if (next.cancelled)
+                    next.cancelled();
+                continue;
+            }
+
+            m_inFlight.insert(reply);
+            connect(reply, &QNetworkReply::finished, this, [this, reply]() {
+                if (m_inFlight.remove(reply))
+                {
+                    dispatch();
+                    emit queueChanged(queuedCount(), inFlightCount());
+                }
+            });
+            connect(reply, &QObject::destroyed, this, [this, reply]() {
+                if (m_inFlight.remove(reply))
+                    dispatch();
+            });
+        }
+    }
+
+    void RequestScheduler::supersede(const QObject* owner, const QString& supersessionKey)
+    {
+        for (auto& queue : m_queues)
+        {
+            for (auto it = queue.begin(); it != queue.end();)
+            {
+                if (it->owner != owner || it->supersessionKey != supersessionKey)
+                {
+                    ++it;
+                    continue;
+                }
+
+                const Canceller cancelled = std::move(it->cancelled);
+                it = queue.erase(it);
+                if (cancelled)
+                    cancelled();
+            }
+        }
+    }
+}
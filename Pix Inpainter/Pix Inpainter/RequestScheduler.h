@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Enums.h"
+
+#include <QObject>
+#include <QNetworkReply>
+#include <QSet>
+#include <QString>
+
+#include <array>
+#include <deque>
+#include <functional>
+
+namespace paint
+{
+    class RequestScheduler : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        using Starter = std::function<QNetworkReply*()>;
+        using Canceller = std::function<void()>;
+
+        static constexpr int DEFAULT_MAX_IN_FLIGHT = 2;
+
+    public:
+        explicit RequestScheduler(QObject* parent = nullptr, int maxInFlight = DEFAULT_MAX_IN_FLIGHT);
+        ~RequestScheduler() = default;
+
+        RequestScheduler(const RequestScheduler&) = delete;
+        RequestScheduler& operator=(const RequestScheduler&) = delete;
+        RequestScheduler(RequestScheduler&&) = delete;
+        RequestScheduler& operator=(RequestScheduler&&) = delete;
+
+        quint64 enqueue(RequestPriority priority, const QString& supersessionKey, Starter start, Canceller cancelled = Canceller(),
+            const QObject* owner = nullptr);
+        bool cancel(quint64 ticket);
+        void clear();
+        void clear(const QObject* owner);
+
+        void setMaxInFlight(int maxInFlight);
+        int maxInFlight() const;
+        int queuedCount() const;
+        int inFlightCount() const;
+
+    signals:
+        void queueChanged(int queued, int inFlight);
+
+    private:
+        struct Pending
+        {
+            quint64 ticket;
+            const QObject* owner;
+            QString supersessionKey;
+            Starter start;
+            Canceller cancelled;
+        };
+
+        void dispatch();
+        void supersede(const QObject* owner, const QString& supersessionKey);
+
+        std::array<std::deque<Pending>, REQUEST_PRIORITY_COUNT> m_queues;
+        QSet<QNetworkReply*> m_inFlight;
+        int m_maxInFlight;
+        quint64 m_nextTicket;
+    };
+}
@@ -0,0 +1,356 @@
+#include "ShapeRasterizer.h"
+
+#include <QPointF>
+
+#include <algorithm>
+#include <cmath>
+
+namespace paint
+{
+    namespace
+    {
+        constexpr double EPSILON = 1e-9;
+
+        void appendSpan(std::vector<Span>& spans, int y, int left, int right, const QRect& clip)
+        {
+            if (y < clip.top() || y > clip.bottom())
+                return;
+
+            left = std::max(left, clip.left());
+            right = std::min(right, clip.right());
+            if (left <= right)
+                spans.push_back({ y, left, right });
+        }
+
+        bool convexExtent(const QPointF* vertices, int count, double y, double& minX, double& maxX)
+        {
+            bool found = false;
+            for (int i = 0; i < count; ++i)
+            {
+                const QPointF& from = vertices[i];
+                const QPointF& to = vertices[(i + 1) % count];
+                if (y < std::min(from.y(), to.y()) - EPSILON || y > std::max(from.y(), to.y()) + EPSILON)
+                    continue;
+
+                double xs[2] = { from.x(), to.x() };
+                int xCount = 2;
+                if (std::abs(to.y() - from.y()) > EPSILON)
+                {
+                    xs[0] = from.x() + (y - from.y()) * (to.x() - from.x()) / (to.y() - from.y());
+                    xCount = 1;
+                }
+
+                for (int j = 0; j < xCount; ++j)
+                {
+                    minX = found ? std::min(minX, xs[j]) : xs[j];
+                    maxX = found ? std::max(maxX, xs[j]) : xs[j];
+                    found = true;
+                }
+            }
+            return found;
+        }
+
+        void verticalExtent(const QPointF* vertices, int count, int& top, int& bottom)
+        {
+            double minY = vertices[0].y();
+            double maxY = vertices[0].y();
+            for (int i = 1; i < count; ++i)
+            {
+                minY = std::min(minY, vertices[i].y());
+                maxY = std::max(maxY, vertices[i].y());
+            }
+            top = static_cast<int>(std::ceil(minY - EPSILON));
+            bottom = static_cast<int>(std::floor(maxY + EPSILON));
+        }
+
+        bool ellipseHalfWidth(double radiusX, double radiusY, double dy, double& halfWidth)
+        {
+            if (radiusX <= 0.0 || radiusY <= 0.0 || std::abs(dy) > radiusY)
+                return false;
+
+            const double ratio = dy / radiusY;
+            halfWidth = radiusX * std::sqrt(std::max(0.0, 1.0 - ratio * ratio));
+            return true;
+        }
+
+        void strokeSegment(const QPoint& from, const QPoint& to, double halfWidth, QPointF* quad)
+        {
+            QPointF direction(to - from);
+            const double length = std::hypot(direction.x(), direction.y());
+            direction = length > 0.0 ? direction / length : QPointF(1.0, 0.0);
+
+            const QPointF along = direction * halfWidth;
+            const QPointF across(-along.y(), along.x());
+
+            quad[0] = QPointF(from) - along + across;
+            quad[1] = QPointF(to) + along + across;
+            quad[2] = QPointF(to) + along - across;
+            quad[3] = QPointF(from) - along - across;
+        }
+
+        struct Edge
+        {
+            double x;
+            double slope;
+            int top;
+            int bottom;
+            int winding;
+        };
+
+        void addEdge(std::vector<Edge>& edges, const QPointF& from, const QPointF& to)
+        {
+            const bool downward = from.y() < to.y();
+            const QPointF& upper = downward ? from : to;
+            const QPointF& lower = downward ? to : from;
+
+            const int top = static_cast<int>(std::ceil(upper.y()));
+            const int bottom = static_cast<int>(std::ceil(lower.y()));
+            if (top >= bottom)
+                return;
+
+            const double slope = (lower.x() - upper.x()) / (lower.y() - upper.y());
+            edges.push_back({ upper.x() + (top - upper.y()) * slope, slope, top, bottom, downward ? 1 : -1 });
+        }
+
+        std::vector<Span> scanEdges(std::vector<Edge>& edges, FillRule rule, const QRect& clip)
+        {
+            std::vector<Span> spans;
+            if (edges.empty())
+                return spans;
+
+            std::sort(edges.begin(), edges.end(), [](const Edge& lhs, const Edge& rhs) { return lhs.top < rhs.top; });
+
+            int last = edges.front().bottom;
+            for (const Edge& edge : edges)
+            {
+                last = std::max(last, edge.bottom);
+            }
+            last = std::min(last - 1, clip.bottom());
+
+            std::vector<Edge> active;
+            active.reserve(edges.size());
+            size_t next = 0;
+
+            for (int y = std::max(edges.front().top, clip.top()); y <= last; ++y)
+            {
+                active.erase(std::remove_if(active.begin(), active.end(), [y](const Edge& edge) { return edge.bottom <= y; }), active.end());
+
+                for (; next < edges.size() && edges[next].top <= y; ++next)
+                {
+                    Edge edge = edges[next];
+                    if (edge.bottom <= y)
+                        continue;
+                    edge.x += (y - edge.top) * edge.slope;
+                    active.push_back(edge);
+                }
+
+                for (size_t i = 1; i < active.size(); ++i)
+                {
+                    const Edge edge = active[i];
+                    size_t j = i;
+                    for (; j > 0 && active[j - 1].x > edge.x; --j)
+                    {
+                        active[j] = active[j - 1];
+                    }
+                    active[j] = edge;
+                }
+
+                const size_t rowStart = spans.size();
+                int winding = 0;
+                for (size_t i = 0; i + 1 < active.size(); ++i)
+                {
+                    winding += rule == FillRule::EvenOdd ? 1 : active[i].winding;
+                    const bool inside = rule == FillRule::EvenOdd ? (winding & 1) != 0 : winding != 0;
+                    if (!inside)
+                        continue;
+
+                    const int left = std::max(static_cast<int>(std::ceil(active[i].x - EPSILON)), clip.left());
+                    const int right = std::min(static_cast<int>(std::ceil(active[i + 1].x - EPSILON)) - 1, clip.right());
+                    if (left > right)
+                        continue;
+
+                    if (spans.size() > rowStart && left <= spans.back().right + 1)
+                        spans.back().right = std::max(spans.back().right, right);
+                    else
+                        spans.push_back({ y, left, right });
+                }
+
+                for (Edge& edge : active)
+                {
+                    edge.x += edge.slope;
+                }
+            }
+            return spans;
+        }
+    }
+
+    std::vector<Span> ShapeRasterizer::fillRect(const QRect& rect, const QRect& clip)
+    {
+        std::vector<Span> spans;
+        const QRect area = rect.normalized().intersected(clip);
+        if (area.isEmpty())
+            return spans;
+
+        spans.reserve(area.height());
+        for (int y = area.top(); y <= area.bottom(); ++y)
+        {
+            spans.push_back({ y, area.left(), area.right() });
+        }
+        return spans;
+    }
+
+    std::vector<Span> ShapeRasterizer::strokeRect(const QRect& rect, int penWidth, const QRect& clip)
+    {
+        // Follow QPainter::drawRect(): the outline runs along the QRectF edges, so for a
+        // one pixel pen it covers right() + 1 and bottom() + 1, matching the preview.
+        const int width = std::max(penWidth, 1);
+        const int inset = width / 2;
+        const QRectF outline = QRectF(rect).normalized();
+        const QRect outer(QPoint(qRound(outline.left()) - inset, qRound(outline.top()) - inset),
+            QPoint(qRound(outline.right()) + width - 1 - inset, qRound(outline.bottom()) + width - 1 - inset));
+        const QRect inner = outer.adjusted(width, width, -width, -width);
+
+        std::vector<Span> spans;
+        const int top = std::max(outer.top(), clip.top());
+        const int bottom = std::min(outer.bottom(), clip.bottom());
+        for (int y = top; y <= bottom; ++y)
+        {
+            if (!inner.isEmpty() && y >= inner.top() && y <= inner.bottom())
+            {
+                appendSpan(spans, y, outer.left(), inner.left() - 1, clip);
+                appendSpan(spans, y, inner.right() + 1, outer.right(), clip);
+            }
+            else
+            {
+                appendSpan(spans, y, outer.left(), outer.right(), clip);
+            }
+        }
+        return spans;
+    }
+
+    std::vector<Span> ShapeRasterizer::fillEllipse(const QRect& rect, const QRect& clip)
+    {
+        const QRect bounds = rect.normalized();
+        const double centerX = (bounds.left() + bounds.right()) / 2.0;
+        const double centerY = (bounds.top() + bounds.bottom()) / 2.0;
+        const double radiusX = (bounds.right() - bounds.left()) / 2.0 + 0.5;
+        const double radiusY = (bounds.bottom() - bounds.top()) / 2.0 + 0.5;
+
+        std::vector<Span> spans;
+        const int top = std::max(bounds.top(), clip.top());
+        const int bottom = std::min(bounds.bottom(), clip.bottom());
+        for (int y = top; y <= bottom; ++y)
+        {
+            double halfWidth;
+            if (!ellipseHalfWidth(radiusX, radiusY, y - centerY, halfWidth))
+                continue;
+
+            appendSpan(spans, y,
+                static_cast<int>(std::ceil(centerX - halfWidth - EPSILON)),
+                static_cast<int>(std::floor(centerX + halfWidth + EPSILON)), clip);
+        }
+        return spans;
+    }
+
+    std::vector<Span> ShapeRasterizer::strokeEllipse(const QRect& rect, int penWidth, const QRect& clip)
+    {
+        const int width = std::max(penWidth, 1);
+        const QRect bounds = rect.normalized();
+        const double centerX = (bounds.left() + bounds.right()) / 2.0;
+        const double centerY = (bounds.top() + bounds.bottom()) / 2.0;
+        const double outset = (width - 1) / 2.0;
+        const double outerX = (bounds.right() - bounds.left()) / 2.0 + 0.5 + outset;
+        const double outerY = (bounds.bottom() - bounds.top()) / 2.0 + 0.5 + outset;
+        const double innerX = outerX - width;
+        const double innerY = outerY - width;
+
+        std::vector<Span> spans;
+        const int top = std::max(static_cast<int>(std::ceil(centerY - outerY - EPSILON)), clip.top());
+        const int bottom = std::min(static_cast<int>(std::floor(centerY + outerY + EPSILON)), clip.bottom());
+        for (int y = top; y <= bottom; ++y)
+        {
+            double outerHalf;
+            if (!ellipseHalfWidth(outerX, outerY, y - centerY, outerHalf))
+                continue;
+
+            const int left = static_cast<int>(std::ceil(centerX - outerHalf - EPSILON));
+            const int right = static_cast<int>(std::floor(centerX + outerHalf + EPSILON));
+
+            double innerHalf;
+            if (!ellipseHalfWidth(innerX, innerY, y - centerY, innerHalf))
+            {
+                appendSpan(spans, y, left, right, clip);
+                continue;
+            }
+
+            const int holeLeft = std::max(static_cast<int>(std::floor(centerX - innerHalf + EPSILON)) + 1, left + 1);
+            const int holeRight = std::min(static_cast<int>(std::ceil(centerX + innerHalf - EPSILON)) - 1, right - 1);
+            if (holeLeft > holeRight)
+            {
+                appendSpan(spans, y, left, right, clip);
+                continue;
+            }
+
+            appendSpan(spans, y, left, holeLeft - 1, clip);
+            appendSpan(spans, y, holeRight + 1, right, clip);
+        }
+        return spans;
+    }
+
+    std::vector<Span> ShapeRasterizer::fillTriangle(const QPoint& a, const QPoint& b, const QPoint& c, const QRect& clip)
+    {
+        const QPointF vertices[3] = { QPointF(a), QPointF(b), QPointF(c) };
+
+        int top;
+        int bottom;
+        verticalExtent(vertices, 3, top, bottom);
+
+        std::vector<Span> spans;
+        for (int y = std::max(top, clip.top()); y <= std::min(bottom, clip.bottom()); ++y)
+        {
+            double minX;
+            double maxX;
+            if (!convexExtent(vertices, 3, y, minX, maxX))
+                continue;
+
+            appendSpan(spans, y,
+                static_cast<int>(std::ceil(minX - EPSILON)),
+                static_cast<int>(std::floor(maxX + EPSILON)), clip);
+        }
+        return spans;
+    }
+
+    std::vector<Span> ShapeRasterizer::strokeTriangle(const QPoint& a, const QPoint& b, const QPoint& c, int penWidth, const QRect& clip)
+    {
+        return strokePolygon({ a, b, c }, penWidth, clip);
+    }
+
+    std::vector<Span> ShapeRasterizer::fillPolygon(const std::vector<QPoint>& vertices, FillRule rule, const QRect& clip)
+    {
+        std::vector<Edge> edges;
+        edges.reserve(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i)
+        {
+            addEdge(edges, QPointF(vertices[i]), QPointF(vertices[(i + 1) % vertices.size()]));
+        }
+        return scanEdges(edges, rule, clip);
+    }
+
+    std::vector<Span> ShapeRasterizer::strokePolygon(const std::vector<QPoint>& vertices, int penWidth, const QRect& clip)
+    {
+        const double halfWidth = std::max(penWidth, 1) / 2.0;
+
+        std::vector<Edge> edges;
+        edges.reserve(vertices.size() * 4);
+        for (size_t i = 0; i < vertices.size(); ++i)
+        {
+            QPointF quad[4];
+            strokeSegment(vertices[i], vertices[(i + 1) % vertices.size()], halfWidth, quad);
+            for (int corner = 0; corner < 4; ++corner)
+            {
+                addEdge(edges, quad[corner], quad[(corner + 1) % 4]);
+            }
+        }
+        return scanEdges(edges, FillRule::NonZero, clip);
+    }
+}
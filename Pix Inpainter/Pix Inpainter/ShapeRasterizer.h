@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Enums.h"
+
+#include <QPoint>
+#include <QRect>
+
+#include <vector>
+
+namespace paint
+{
+    struct Span
+    {
+        int y;
+        int left;
+        int right;
+    };
+
+    class ShapeRasterizer
+    {
+    public:
+        ShapeRasterizer() = delete;
+
+        static std::vector<Span> fillRect(const QRect& rect, const QRect& clip);
+        static std::vector<Span> strokeRect(const QRect& rect, int penWidth, const QRect& clip);
+
+        static std::vector<Span> fillEllipse(const QRect& rect, const QRect& clip);
+        static std::vector<Span> strokeEllipse(const QRect& rect, int penWidth, const QRect& clip);
+
+        static std::vector<Span> fillTriangle(const QPoint& a, const QPoint& b, const QPoint& c, const QRect& clip);
+        static std::vector<Span> strokeTriangle(const QPoint& a, const QPoint& b, const QPoint& c, int penWidth, const QRect& clip);
+
+        static std::vector<Span> fillPolygon(const std::vector<QPoint>& vertices, FillRule rule, const QRect& clip);
+        static std::vector<Span> strokePolygon(const std::vector<QPoint>& vertices, int penWidth, const QRect& clip);
+    };
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <QPoint>
+#include <QtGlobal>
+
+namespace paint
+{
+    struct StrokeSample
+    {
+        QPoint position;
+        qreal pressure = 1.0;
+        qreal xTilt = 0.0;
+        qreal yTilt = 0.0;
+        qint64 timestamp = 0;
+    };
+}
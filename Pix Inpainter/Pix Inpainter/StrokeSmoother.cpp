@@ -0,0 +1,92 @@
+#include "StrokeSmoother.h"
+
+#include <QLineF>
+
+#include <algorithm>
+#include <cmath>
+
+namespace paint
+{
+    namespace
+    {
+        QPointF catmullRom(const QPointF& p0, const QPointF& p1, const QPointF& p2, const QPointF& p3, qreal t)
+        {
+            const qreal t2 = t * t;
+            const qreal t3 = t2 * t;
+            return 0.5 * ((2.0 * p1)
+                + (p2 - p0) * t
+                + (2.0 * p0 - 5.0 * p1 + 4.0 * p2 - p3) * t2
+                + (3.0 * p1 - p0 - 3.0 * p2 + p3) * t3);
+        }
+    }
+
+    void StrokeSmoother::begin(const QPointF& point, qreal penWidth)
+    {
+        m_controlPoints = { point, point };
+        m_lastSample = point;
+        m_spacing = std::max<qreal>(1.0, penWidth * SPACING_RATIO);
+        m_travelled = 0.0;
+    }
+
+    QVector<QPointF> StrokeSmoother::addPoint(const QPointF& point)
+    {
+        QVector<QPointF> output;
+        if (m_controlPoints.isEmpty() || QLineF(m_controlPoints.last(), point).length() < MIN_DISTANCE)
+            return output;
+
+        m_controlPoints.append(point);
+        if (m_controlPoints.size() == 4)
+        {
+            resampleSegment(m_controlPoints[0], m_controlPoints[1], m_controlPoints[2], m_controlPoints[3], output);
+            m_controlPoints.removeFirst();
+        }
+        return output;
+    }
+
+    QVector<QPointF> StrokeSmoother::finish()
+    {
+        QVector<QPointF> output;
+        if (m_controlPoints.size() >= 3)
+        {
+            const QPointF end = m_controlPoints.last();
+            m_controlPoints.append(end);
+            resampleSegment(m_controlPoints[m_controlPoints.size() - 4], m_controlPoints[m_controlPoints.size() - 3],
+                m_controlPoints[m_controlPoints.size() - 2], m_controlPoints[m_controlPoints.size() - 1], output);
+
+            if (m_lastSample != end)
+            {
+                output.append(end);
+                m_lastSample = end;
+            }
+        }
+        m_controlPoints.clear();
+        return output;
+    }
+
+    void StrokeSmoother::resampleSegment(const QPointF& p0, const QPointF& p1, const QPointF& p2, const QPointF& p3, QVector<QPointF>& output)
+    {
+        const qreal chord = QLineF(p1, p2).length();
+        const int subdivisions = std::clamp(static_cast<int>(std::ceil(chord / m_spacing)) * 2, 2, MAX_SUBDIVISIONS);
+
+        QPointF previous = p1;
+        for (int i = 1; i <= subdivisions; ++i)
+        {
+            const QPointF current = catmullRom(p0, p1, p2, p3, static_cast<qreal>(i) / subdivisions);
+            qreal stepLength = QLineF(previous, current).length();
+
+            while (m_travelled + stepLength >= m_spacing && stepLength > 0.0)
+            {
+                const qreal ratio = (m_spacing - m_travelled) / stepLength;
+                previous += (current - previous) * ratio;
+                stepLength -= m_spacing - m_travelled;
+                m_travelled = 0.0;
+
+                m_lastSample = previous;
+                output.append(previous);
+            }
+
+            m_travelled += stepLength;
+            previous = current;
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QPointF>
+#include <QVector>
+
+namespace paint
+{
+    class StrokeSmoother
+    {
+    public:
+        static constexpr qreal MIN_DISTANCE = 1.0;
+        static constexpr qreal SPACING_RATIO = 0.5;
+        static constexpr int MAX_SUBDIVISIONS = 64;
+
+    public:
+        StrokeSmoother() = default;
+        ~StrokeSmoother() = default;
+        StrokeSmoother(const StrokeSmoother&) = default;
+        StrokeSmoother& operator=(const StrokeSmoother&) = default;
+        StrokeSmoother(StrokeSmoother&&) = default;
+        StrokeSmoother& operator=(StrokeSmoother&&) = default;
+
+        void begin(const QPointF& point, qreal penWidth);
+        QVector<QPointF> addPoint(const QPointF& point);
+        QVector<QPointF> finish();
+
+    private:
+        void resampleSegment(const QPointF& p0, const QPointF& p1, const QPointF& p2, const QPointF& p3, QVector<QPointF>& output);
+
+        QVector<QPointF> m_controlPoints;
+        QPointF m_lastSample;
+        qreal m_spacing = 1.0;
+        qreal m_travelled = 0.0;
+    };
+}
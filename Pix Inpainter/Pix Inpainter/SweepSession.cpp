@@ -0,0 +1,115 @@
+#include "SweepSession.h"
+
+#include <algorithm>
+
+namespace paint
+{
+    SweepSession::SweepSession()
+        : m_iterations(0)
+        , m_generation(0)
+        , m_pendingDecodes(0)
+        , m_failed(false)
+    {
+    }
+
+    quint64 SweepSession::restart(const QString& modelKey, const QByteArray& imageDigest, int iterations)
+    {
+        m_modelKey = modelKey;
+        m_imageDigest = imageDigest;
+        m_iterations = std::max(iterations, 1);
+        m_parser.clear();
+        m_results.clear();
+        m_pendingDecodes = 0;
+        m_failed = false;
+        return ++m_generation;
+    }
+
+    quint64 SweepSession::generation() const
+    {
+        return m_generation;
+    }
+
+    QString SweepSession::modelKey() const
+    {
+        return m_modelKey;
+    }
+
+    QByteArray SweepSession::imageDigest() const
+    {
+        return m_imageDigest;
+    }
+
+    int SweepSession::iterations() const
+    {
+        return m_iterations;
+    }
+
+    void SweepSession::append(const QByteArray& data)
+    {
+        m_parser.append(data);
+    }
+
+    bool SweepSession::next(Frame& frame)
+    {
+        QJsonObject header;
+        QByteArray payload;
+        while (m_parser.next(header, payload))
+        {
+            frame.ok = header.value("ok").toBool();
+            frame.iteration = header.value("postprocess_value").toInt();
+            frame.error = header.value("error").toString();
+            frame.payload = payload;
+
+            // Error frames carry no iteration; result frames outside the requested range are ignored.
+            if (!frame.ok || (frame.iteration >= 1 && frame.iteration <= m_iterations))
+                return true;
+        }
+        return false;
+    }
+
+    void SweepSession::endStream(bool failed)
+    {
+        m_parser.clear();
+        m_failed = failed;
+    }
+
+    void SweepSession::fail()
+    {
+        m_failed = true;
+    }
+
+    void SweepSession::setResult(int iteration, const QPixmap& pixmap)
+    {
+        m_results.insert(iteration, pixmap);
+    }
+
+    QPixmap SweepSession::result(int iteration) const
+    {
+        return m_results.value(iteration, QPixmap());
+    }
+
+    void SweepSession::clearResults()
+    {
+        m_results.clear();
+    }
+
+    bool SweepSession::isComplete() const
+    {
+        return !m_failed && m_results.size() == m_iterations;
+    }
+
+    void SweepSession::beginDecode()
+    {
+        ++m_pendingDecodes;
+    }
+
+    void SweepSession::endDecode()
+    {
+        m_pendingDecodes = std::max(m_pendingDecodes - 1, 0);
+    }
+
+    int SweepSession::pendingDecodes() const
+    {
+        return m_pendingDecodes;
+    }
+}
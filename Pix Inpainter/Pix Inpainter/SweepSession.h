@@ -0,0 +1,62 @@
+#pragma once
+
+#include "FrameParser.h"
+
+#include <QByteArray>
+#include <QMap>
+#include <QPixmap>
+#include <QString>
+
+namespace paint
+{
+    class SweepSession
+    {
+    public:
+        struct Frame
+        {
+            int iteration = 0;
+            bool ok = false;
+            QString error;
+            QByteArray payload;
+        };
+
+    public:
+        SweepSession();
+        ~SweepSession() = default;
+
+        SweepSession(const SweepSession&) = default;
+        SweepSession& operator=(const SweepSession&) = default;
+        SweepSession(SweepSession&&) noexcept = default;
+        SweepSession& operator=(SweepSession&&) noexcept = default;
+
+        quint64 restart(const QString& modelKey, const QByteArray& imageDigest, int iterations);
+        quint64 generation() const;
+        QString modelKey() const;
+        QByteArray imageDigest() const;
+        int iterations() const;
+
+        void append(const QByteArray& data);
+        bool next(Frame& frame);
+        void endStream(bool failed);
+        void fail();
+
+        void setResult(int iteration, const QPixmap& pixmap);
+        QPixmap result(int iteration) const;
+        void clearResults();
+        bool isComplete() const;
+
+        void beginDecode();
+        void endDecode();
+        int pendingDecodes() const;
+
+    private:
+        QString m_modelKey;
+        QByteArray m_imageDigest;
+        int m_iterations;
+        FrameParser m_parser;
+        QMap<int, QPixmap> m_results;
+        quint64 m_generation;
+        int m_pendingDecodes;
+        bool m_failed;
+    };
+}
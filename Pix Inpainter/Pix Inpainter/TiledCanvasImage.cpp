@@ -0,0 +1,319 @@
+#include "TiledCanvasImage.h"
+#include "CanvasColor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <utility>
+
+namespace paint
+{
+    namespace
+    {
+        std::atomic<quint64> s_nextTileVersion{ 1 };
+
+        quint64 nextTileVersion()
+        {
+            return s_nextTileVersion.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        bool isUniform(const QImage& image, QRgb& color)
+        {
+            color = reinterpret_cast<const QRgb*>(image.constScanLine(0))[0];
+            for (int y = 0; y < image.height(); ++y)
+            {
+                const QRgb* line = reinterpret_cast<const QRgb*>(image.constScanLine(y));
+                for (int x = 0; x < image.width(); ++x)
+                {
+                    if (line[x] != color)
+                        return false;
+                }
+            }
+            return true;
+        }
+
+        QRgb toRawColor(const ICanvasColorConstPtr& color)
+        {
+            return qPremultiply(qRgba(color->red(), color->green(), color->blue(), color->alpha()));
+        }
+    }
+
+    ICanvasImagePtr TiledCanvasImage::create(int width, int height)
+    {
+        return std::make_shared<TiledCanvasImage>(width, height);
+    }
+
+    ICanvasImagePtr TiledCanvasImage::create(const QImage& image)
+    {
+        return std::make_shared<TiledCanvasImage>(image);
+    }
+
+    TiledCanvasImage::TiledCanvasImage(int width, int height)
+        : m_width(std::max(width, 0))
+        , m_height(std::max(height, 0))
+        , m_columns((m_width + TILE_SIZE - 1) / TILE_SIZE)
+        , m_rows((m_height + TILE_SIZE - 1) / TILE_SIZE)
+        , m_tiles(std::make_shared<std::vector<TileRowPtr>>(static_cast<size_t>(m_rows)))
+    {
+        for (TileRowPtr& row : *m_tiles)
+        {
+            row = std::make_shared<TileRow>(static_cast<size_t>(m_columns));
+            for (Tile& tile : *row)
+                tile.version = nextTileVersion();
+        }
+    }
+
+    TiledCanvasImage::TiledCanvasImage(const QImage& image)
+        : TiledCanvasImage(image.width(), image.height())
+    {
+        const QImage source = image.format() == CanvasImage::FORMAT ? image : image.convertToFormat(CanvasImage::FORMAT);
+
+        for (int row = 0; row < m_rows; ++row)
+        {
+            for (int column = 0; column < m_columns; ++column)
+            {
+                QImage tile = source.copy(tileRect(column, row));
+                QRgb color;
+                if (isUniform(tile, color))
+                {
+                    fillTile(column, row, color);
+                }
+                else
+                {
+                    Tile& target = tileAt(column, row);
+                    target.image = std::make_shared<CanvasImage>(tile);
+                    target.version = nextTileVersion();
+                }
+            }
+        }
+    }
+
+    int TiledCanvasImage::width() const
+    {
+        return m_width;
+    }
+
+    int TiledCanvasImage::height() const
+    {
+        return m_height;
+    }
+
+    ICanvasColorConstPtr TiledCanvasImage::pixelAt(int x, int y) const
+    {
+        if (!rect().contains(x, y))
+            return nullptr;
+        return CanvasColor::create(QColor::fromRgba(qUnpremultiply(rawPixel(x, y))));
+    }
+
+    void TiledCanvasImage::setPixel(int x, int y, ICanvasColorConstPtr color)
+    {
+        if (!rect().contains(x, y) || !color)
+            return;
+
+        const int column = x / TILE_SIZE;
+        const int row = y / TILE_SIZE;
+        const QRect bounds = tileRect(column, row);
+
+        QImage& tile = tileForWrite(column, row);
+        reinterpret_cast<QRgb*>(tile.scanLine(y - bounds.top()))[x - bounds.left()] = toRawColor(color);
+    }
+
+    ICanvasImagePtr TiledCanvasImage::clone() const
+    {
+        return std::make_shared<TiledCanvasImage>(*this);
+    }
+
+    int TiledCanvasImage::columns() const
+    {
+        return m_columns;
+    }
+
+    int TiledCanvasImage::rows() const
+    {
+        return m_rows;
+    }
+
+    QRect TiledCanvasImage::rect() const
+    {
+        return QRect(0, 0, m_width, m_height);
+    }
+
+    QRect TiledCanvasImage::tileRect(int column, int row) const
+    {
+        return QRect(column * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE).intersected(rect());
+    }
+
+    QRect TiledCanvasImage::tilesIntersecting(const QRect& region) const
+    {
+        const QRect clipped = region.normalized().intersected(rect());
+        if (clipped.isEmpty())
+            return QRect();
+
+        return QRect(QPoint(clipped.left() / TILE_SIZE, clipped.top() / TILE_SIZE),
+            QPoint(clipped.right() / TILE_SIZE, clipped.bottom() / TILE_SIZE));
+    }
+
+    bool TiledCanvasImage::isTileAllocated(int column, int row) const
+    {
+        return tileAt(column, row).image != nullptr;
+    }
+
+    QRgb TiledCanvasImage::tileColor(int column, int row) const
+    {
+        return tileAt(column, row).color;
+    }
+
+    quint64 TiledCanvasImage::tileVersion(int column, int row) const
+    {
+        return tileAt(column, row).version;
+    }
+
+    size_t TiledCanvasImage::allocatedTileCount() const
+    {
+        size_t count = 0;
+        for (const TileRowPtr& row : *m_tiles)
+            count += std::count_if(row->begin(), row->end(), [](const Tile& tile) { return tile.image != nullptr; });
+        return count;
+    }
+
+    QRgb TiledCanvasImage::rawPixel(int x, int y) const
+    {
+        const Tile& tile = tileAt(x / TILE_SIZE, y / TILE_SIZE);
+        if (!tile.image)
+            return tile.color;
+
+        const QImage& image = tile.image->getQImage_impl();
+        return reinterpret_cast<const QRgb*>(image.constScanLine(y % TILE_SIZE))[x % TILE_SIZE];
+    }
+
+    QImage& TiledCanvasImage::tileForWrite(int column, int row)
+    {
+        Tile& tile = tileAt(column, row);
+        if (!tile.image)
+        {
+            const QSize size = tileRect(column, row).size();
+            tile.image = std::make_shared<CanvasImage>(size.width(), size.height());
+            tile.image->getQImage_impl().fill(tile.color);
+        }
+        else if (tile.image.use_count() > 1)
+        {
+            tile.image = std::make_shared<CanvasImage>(*tile.image);
+        }
+
+        tile.version = nextTileVersion();
+        return tile.image->getQImage_impl();
+    }
+
+    void TiledCanvasImage::fillTile(int column, int row, QRgb color)
+    {
+        Tile& tile = tileAt(column, row);
+        tile.image.reset();
+        tile.color = color;
+        tile.version = nextTileVersion();
+    }
+
+    bool TiledCanvasImage::collapseIfUniform(int column, int row)
+    {
+        const Tile& current = std::as_const(*this).tileAt(column, row);
+        QRgb color;
+        if (!current.image || !isUniform(current.image->getQImage_impl(), color))
+            return false;
+
+        // The pixels are unchanged, so the version is kept and content caches stay valid.
+        Tile& tile = tileAt(column, row);
+        tile.image.reset();
+        tile.color = color;
+        return true;
+    }
+
+    void TiledCanvasImage::writeImage(const QImage& image, const QPoint& topLeft)
+    {
+        const QRect region = QRect(topLeft, image.size()).intersected(rect());
+        if (region.isEmpty())
+            return;
+
+        const QImage source = image.format() == CanvasImage::FORMAT ? image : image.convertToFormat(CanvasImage::FORMAT);
+        const QRect tiles = tilesIntersecting(region);
+        for (int row = tiles.top(); row <= tiles.bottom(); ++row)
+        {
+            for (int column = tiles.left(); column <= tiles.right(); ++column)
+            {
+                const QRect bounds = tileRect(column, row);
+                const QRect target = bounds.intersected(region);
+                QImage& tile = tileForWrite(column, row);
+                for (int y = target.top(); y <= target.bottom(); ++y)
+                {
+                    std::memcpy(reinterpret_cast<QRgb*>(tile.scanLine(y - bounds.top())) + (target.left() - bounds.left()),
+                        reinterpret_cast<const QRgb*>(source.constScanLine(y - topLeft.y())) + (target.left() - topLeft.x()),
+                        static_cast<size_t>(target.width()) * sizeof(QRgb));
+                }
+                collapseIfUniform(column, row);
+            }
+        }
+    }
+
+    QImage TiledCanvasImage::tileImage(int column, int row) const
+    {
+        const Tile& tile = tileAt(column, row);
+        if (tile.image)
+            return tile.image->toQImage();
+
+        QImage image(tileRect(column, row).size(), CanvasImage::FORMAT);
+        image.fill(tile.color);
+        return image;
+    }
+
+    const CanvasImage* TiledCanvasImage::tileData(int column, int row) const
+    {
+        return tileAt(column, row).image.get();
+    }
+
+    QImage TiledCanvasImage::toQImage() const
+    {
+        QImage image(m_width, m_height, CanvasImage::FORMAT);
+
+        for (int row = 0; row < m_rows; ++row)
+        {
+            for (int column = 0; column < m_columns; ++column)
+            {
+                const QRect bounds = tileRect(column, row);
+                const Tile& tile = tileAt(column, row);
+
+                for (int y = 0; y < bounds.height(); ++y)
+                {
+                    QRgb* target = reinterpret_cast<QRgb*>(image.scanLine(bounds.top() + y)) + bounds.left();
+                    if (tile.image)
+                    {
+                        const QImage& source = tile.image->getQImage_impl();
+                        std::memcpy(target, source.constScanLine(y), bounds.width() * sizeof(QRgb));
+                    }
+                    else
+                    {
+                        std::fill_n(target, bounds.width(), tile.color);
+                    }
+                }
+            }
+        }
+
+        return image;
+    }
+
+    TiledCanvasImage::Tile& TiledCanvasImage::tileAt(int column, int row)
+    {
+        // Clones share the row table and every row. A write copies the row table and the
+        // one row it touches, so a published snapshot costs O(rows + columns) on the next
+        // write rather than a copy of every tile; tileForWrite() then copies the tile itself.
+        if (m_tiles.use_count() > 1)
+            m_tiles = std::make_shared<std::vector<TileRowPtr>>(*m_tiles);
+
+        TileRowPtr& tiles = (*m_tiles)[static_cast<size_t>(row)];
+        if (tiles.use_count() > 1)
+            tiles = std::make_shared<TileRow>(*tiles);
+        return (*tiles)[static_cast<size_t>(column)];
+    }
+
+    const TiledCanvasImage::Tile& TiledCanvasImage::tileAt(int column, int row) const
+    {
+        return (*(*m_tiles)[static_cast<size_t>(row)])[static_cast<size_t>(column)];
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "ICanvasImage.h"
+#include "CanvasImage.h"
+
+#include <QImage>
+#include <QRect>
+#include <QRgb>
+
+#include <memory>
+#include <vector>
+
+namespace paint
+{
+    class TiledCanvasImage : public ICanvasImage
+    {
+    public:
+        static constexpr int TILE_SIZE = 128;
+        static constexpr QRgb BACKGROUND_COLOR = 0xffffffff;
+
+    public:
+        TiledCanvasImage(int width, int height);
+        explicit TiledCanvasImage(const QImage& image);
+
+        ~TiledCanvasImage() override = default;
+        TiledCanvasImage(const TiledCanvasImage&) = default;
+        TiledCanvasImage& operator=(const TiledCanvasImage&) = default;
+        TiledCanvasImage(TiledCanvasImage&&) noexcept = default;
+        TiledCanvasImage& operator=(TiledCanvasImage&&) noexcept = default;
+
+        int width() const override;
+        int height() const override;
+        ICanvasColorConstPtr pixelAt(int x, int y) const override;
+        void setPixel(int x, int y, ICanvasColorConstPtr color) override;
+        ICanvasImagePtr clone() const override;
+
+        int columns() const;
+        int rows() const;
+        QRect rect() const;
+        QRect tileRect(int column, int row) const;
+        QRect tilesIntersecting(const QRect& region) const;
+
+        bool isTileAllocated(int column, int row) const;
+        QRgb tileColor(int column, int row) const;
+        quint64 tileVersion(int column, int row) const;
+        size_t allocatedTileCount() const;
+
+        QRgb rawPixel(int x, int y) const;
+        QImage& tileForWrite(int column, int row);
+        void fillTile(int column, int row, QRgb color);
+        bool collapseIfUniform(int column, int row);
+        void writeImage(const QImage& image, const QPoint& topLeft);
+
+        QImage tileImage(int column, int row) const;
+        const CanvasImage* tileData(int column, int row) const;
+        QImage toQImage() const;
+
+        static ICanvasImagePtr create(int width, int height);
+        static ICanvasImagePtr create(const QImage& image);
+
+    private:
+        struct Tile
+        {
+            std::shared_ptr<CanvasImage> image;
+            QRgb color = BACKGROUND_COLOR;
+            quint64 version = 0;
+        };
+        using TileRow = std::vector<Tile>;
+        using TileRowPtr = std::shared_ptr<TileRow>;
+
+        Tile& tileAt(int column, int row);
+        const Tile& tileAt(int column, int row) const;
+
+        int m_width;
+        int m_height;
+        int m_columns;
+        int m_rows;
+        std::shared_ptr<std::vector<TileRowPtr>> m_tiles;
+    };
+}
@@ -0,0 +1,87 @@
+#include "TiledInference.h"
+#include "GrayPayload.h"
+#include "RegionCompositor.h"
+
+#include <QBuffer>
+
+namespace paint
+{
+    TiledInference::TiledInference(const QImage& source, const QRect& region, const QSize& tileSize)
+        : m_source(source)
+        , m_region(region)
+        , m_uploadRect(RegionCompositor::contextRect(region, source.rect()))
+        , m_image(region.isEmpty() ? source : source.copy(m_uploadRect))
+        , m_tiles(RegionCompositor::tileRects(m_image.rect(), tileSize))
+        , m_results(m_tiles.size())
+        , m_pending(static_cast<int>(m_tiles.size()))
+    {
+    }
+
+    const QList<QRect>& TiledInference::tiles() const
+    {
+        return m_tiles;
+    }
+
+    int TiledInference::tileCount() const
+    {
+        return static_cast<int>(m_tiles.size());
+    }
+
+    int TiledInference::completedCount() const
+    {
+        return tileCount() - m_pending;
+    }
+
+    QImage TiledInference::tileImage(int index) const
+    {
+        return m_image.copy(m_tiles[index]);
+    }
+
+    bool TiledInference::decodeTile(int index, const QByteArray& data)
+    {
+        m_results[index] = decodeTileImage(data, m_tiles[index].size());
+        return !m_results[index].isNull();
+    }
+
+    bool TiledInference::finishTile()
+    {
+        return m_pending > 0 && --m_pending == 0;
+    }
+
+    bool TiledInference::merge()
+    {
+        const QImage merged = RegionCompositor::mergeTiles(m_image.rect(), m_tiles, m_results);
+        m_results.clear();
+        if (merged.isNull())
+            return false;
+
+        QBuffer buffer(&m_encodedData);
+        buffer.open(QIODevice::WriteOnly);
+        merged.save(&buffer, "PNG");
+        m_merged = m_region.isEmpty() ? merged : RegionCompositor::stitch(m_source, merged, m_uploadRect, m_region);
+        return true;
+    }
+
+    const QImage& TiledInference::merged() const
+    {
+        return m_merged;
+    }
+
+    const QByteArray& TiledInference::encodedData() const
+    {
+        return m_encodedData;
+    }
+
+    QRect TiledInference::resultRegion() const
+    {
+        return RegionCompositor::blendRect(m_region, m_source.rect());
+    }
+
+    QImage TiledInference::decodeTileImage(const QByteArray& data, const QSize& tileSize)
+    {
+        QImage image = GrayPayload::isPayload(data) ? GrayPayload::decode(data) : QImage::fromData(data, "PNG");
+        if (!image.isNull() && image.size() != tileSize)
+            image = image.scaled(tileSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        return image;
+    }
+}
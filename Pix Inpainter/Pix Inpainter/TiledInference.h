@@ -0,0 +1,50 @@
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QList>
+#include <QRect>
+#include <QSize>
+
+#include <vector>
+
+namespace paint
+{
+    class TiledInference
+    {
+    public:
+        TiledInference(const QImage& source, const QRect& region, const QSize& tileSize);
+        ~TiledInference() = default;
+
+        TiledInference(const TiledInference&) = default;
+        TiledInference& operator=(const TiledInference&) = default;
+        TiledInference(TiledInference&&) noexcept = default;
+        TiledInference& operator=(TiledInference&&) noexcept = default;
+
+        const QList<QRect>& tiles() const;
+        int tileCount() const;
+        int completedCount() const;
+        QImage tileImage(int index) const;
+
+        bool decodeTile(int index, const QByteArray& data);
+        bool finishTile();
+        bool merge();
+
+        const QImage& merged() const;
+        const QByteArray& encodedData() const;
+        QRect resultRegion() const;
+
+        static QImage decodeTileImage(const QByteArray& data, const QSize& tileSize);
+
+    private:
+        QImage m_source;
+        QRect m_region;
+        QRect m_uploadRect;
+        QImage m_image;
+        QList<QRect> m_tiles;
+        std::vector<QImage> m_results;
+        QImage m_merged;
+        QByteArray m_encodedData;
+        int m_pending;
+    };
+}
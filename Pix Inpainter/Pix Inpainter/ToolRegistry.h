@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Enums.h"
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
+
+namespace paint
+{
+    template <typename Strategy>
+    class ToolRegistry
+    {
+    public:
+        using StrategyUniquePtr = std::unique_ptr<Strategy>;
+        using Factory = StrategyUniquePtr(*)();
+
+        struct Entry
+        {
+            Tool tool;
+            Factory create;
+        };
+
+    public:
+        explicit ToolRegistry(std::span<const Entry> entries)
+        {
+            for (const Entry& entry : entries)
+                m_strategies[index(entry.tool)] = entry.create();
+        }
+
+        ~ToolRegistry() = default;
+        ToolRegistry(const ToolRegistry&) = delete;
+        ToolRegistry& operator=(const ToolRegistry&) = delete;
+        ToolRegistry(ToolRegistry&&) noexcept = default;
+        ToolRegistry& operator=(ToolRegistry&&) noexcept = default;
+
+        Strategy* strategy(Tool tool) const
+        {
+            const size_t slot = index(tool);
+            return slot < m_strategies.size() ? m_strategies[slot].get() : nullptr;
+        }
+
+        template <size_t N>
+        static constexpr bool isComplete(const std::array<Entry, N>& entries)
+        {
+            if (N != TOOL_COUNT)
+                return false;
+            for (size_t i = 0; i < N; ++i)
+            {
+                if (index(entries[i].tool) != i || !entries[i].create)
+                    return false;
+            }
+            return true;
+        }
+
+    private:
+        static constexpr size_t index(Tool tool)
+        {
+            return static_cast<size_t>(tool);
+        }
+
+        std::array<StrategyUniquePtr, TOOL_COUNT> m_strategies;
+    };
+}
@@ -9,11 +9,45 @@
 
 namespace paint
 {
+    namespace
+    {
+        void commitPolygon(PaintController* controller, const QVector<QPoint>& points, const QPen& pen)
+        {
+            controller->saveState();
+            if (controller->getShapeStyle() == ShapeStyle::Filled)
+                controller->fillPolygon(points, pen.color());
+            else
+                controller->drawPolygon(points, pen);
+            controller->notifyCanvasChanged();
+        }
+
+        void drawStrokeSamples(PaintController* controller, QPoint& lastPoint, const QVector<QPointF>& samples, const QPen& pen)
+        {
+            QVector<QPair<QPoint, QPoint>> lines;
+            lines.reserve(samples.size());
+            for (const QPointF& sample : samples)
+            {
+                const QPoint point = sample.toPoint();
+                if (point == lastPoint)
+                    continue;
+                lines.append({ lastPoint, point });
+                lastPoint = point;
+            }
+
+            if (lines.isEmpty())
+                return;
+
+            controller->drawLines(lines, pen);
+            controller->notifyCanvasChanged();
+        }
+    }
+
     void PenStrategy::onMousePress(PaintController* controller, const QPoint& point, const QPen& pen)
     {
         controller->saveState();
 
         m_lastPoint = point;
+        m_smoother.begin(point, pen.widthF());
         controller->drawPoint(m_lastPoint, pen);
         controller->notifyCanvasChanged();
         m_isDrawing = true;
@@ -23,17 +57,24 @@ namespace paint
     {
         if (m_isDrawing)
         {
-            controller->drawLine(m_lastPoint, point, pen);
-            controller->notifyCanvasChanged();
-            m_lastPoint = point;
+            drawStrokeSamples(controller, m_lastPoint, m_smoother.addPoint(point), pen);
         }
     }
 
     void PenStrategy::onMouseRelease(PaintController* controller, const QPoint& point, const QPen& pen)
+    {
+        if (!m_isDrawing)
+            return;
+
+        m_isDrawing = false;
+        QVector<QPointF> samples = m_smoother.addPoint(point);
+        samples += m_smoother.finish();
+        drawStrokeSamples(controller, m_lastPoint, samples, pen);
+    }
+
+    void PenStrategy::deactivate()
     {
         m_isDrawing = false;
-        controller->drawLine(m_lastPoint, point, pen);
-        controller->notifyCanvasChanged();
     }
 
     void EraserStrategy::onMousePress(PaintController* controller, const QPoint& point, const QPen& pen)
@@ -41,6 +82,7 @@ namespace paint
         controller->saveState();
 
         m_lastPoint = point;
+        m_smoother.begin(point, pen.widthF());
         controller->drawPoint(m_lastPoint, pen);
         controller->notifyCanvasChanged();
         m_isDrawing = true;
@@ -50,17 +92,24 @@ namespace paint
     {
         if (m_isDrawing)
         {
-            controller->drawLine(m_lastPoint, point, pen);
-            controller->notifyCanvasChanged();
-            m_lastPoint = point;
+            drawStrokeSamples(controller, m_lastPoint, m_smoother.addPoint(point), pen);
         }
     }
 
     void EraserStrategy::onMouseRelease(PaintController* controller, const QPoint& point, const QPen& pen)
+    {
+        if (!m_isDrawing)
+            return;
+
+        m_isDrawing = false;
+        QVector<QPointF> samples = m_smoother.addPoint(point);
+        samples += m_smoother.finish();
+        drawStrokeSamples(controller, m_lastPoint, samples, pen);
+    }
+
+    void EraserStrategy::deactivate()
     {
         m_isDrawing = false;
-        controller->drawLine(m_lastPoint, point, pen);
-        controller->notifyCanvasChanged();
     }
 
     void RectangleStrategy::onMousePress(PaintController* controller, const QPoint& point, const QPen& pen)
@@ -77,7 +126,10 @@ namespace paint
     void RectangleStrategy::onMouseRelease(PaintController* controller, const QPoint& point, const QPen& pen)
     {
         controller->saveState();
-        controller->drawRect(QRect(m_startPoint, m_endPoint), pen);
+        if (controller->getShapeStyle() == ShapeStyle::Filled)
+            controller->fillRect(QRect(m_startPoint, m_endPoint), pen.color());
+        else
+            controller->drawRect(QRect(m_startPoint, m_endPoint), pen);
         controller->notifyCanvasChanged();
     }
 
@@ -95,7 +147,10 @@ namespace paint
     void EllipseStrategy::onMouseRelease(PaintController* controller, const QPoint& point, const QPen& pen)
     {
         controller->saveState();
-        controller->drawEllipse(QRect(m_startPoint, m_endPoint), pen);
+        if (controller->getShapeStyle() == ShapeStyle::Filled)
+            controller->fillEllipse(QRect(m_startPoint, m_endPoint), pen.color());
+        else
+            controller->drawEllipse(QRect(m_startPoint, m_endPoint), pen);
         controller->notifyCanvasChanged();
     }
 
@@ -161,14 +216,72 @@ namespace paint
         m_leftPoint = QPoint(m_startPoint.x(), m_endPoint.y());
         m_rightPoint = QPoint(m_endPoint.x(), m_endPoint.y());
 
-        QVector<QPair<QPoint, QPoint>> triangleLines = {
-            {m_topPoint, m_leftPoint},
-            {m_leftPoint, m_rightPoint},
-            {m_rightPoint, m_topPoint}
-        };
-
         controller->saveState();
-        controller->drawLines(triangleLines, pen);
+        if (controller->getShapeStyle() == ShapeStyle::Filled)
+            controller->fillTriangle(m_topPoint, m_leftPoint, m_rightPoint, pen.color());
+        else
+            controller->drawTriangle(m_topPoint, m_leftPoint, m_rightPoint, pen);
         controller->notifyCanvasChanged();
     }
+
+    void PolygonStrategy::onMousePress(PaintController* controller, const QPoint& point, const QPen& pen)
+    {
+        if (m_points.size() >= 3 && (point - m_points.first()).manhattanLength() <= PaintWidget::POLYGON_CLOSE_DISTANCE)
+        {
+            commitPolygon(controller, m_points, pen);
+            m_points.clear();
+            return;
+        }
+
+        m_points.append(point);
+    }
+
+    void PolygonStrategy::onMouseMove(PaintController* controller, const QPoint& point, const QPen& pen)
+    {
+        if (!m_points.isEmpty())
+            m_points.last() = point;
+    }
+
+    void PolygonStrategy::onMouseRelease(PaintController* controller, const QPoint& point, const QPen& pen)
+    {
+    }
+
+    void PolygonStrategy::deactivate()
+    {
+        m_points.clear();
+    }
+
+    void PolygonStrategy::finish(PaintController* controller, const QPen& pen)
+    {
+        if (m_points.size() >= 3)
+            commitPolygon(controller, m_points, pen);
+        m_points.clear();
+    }
+
+    void LassoStrategy::onMousePress(PaintController* controller, const QPoint& point, const QPen& pen)
+    {
+        m_points.clear();
+        m_points.append(point);
+    }
+
+    void LassoStrategy::onMouseMove(PaintController* controller, const QPoint& point, const QPen& pen)
+    {
+        if (!m_points.isEmpty() && m_points.last() != point)
+            m_points.append(point);
+    }
+
+    void LassoStrategy::onMouseRelease(PaintController* controller, const QPoint& point, const QPen& pen)
+    {
+        if (!m_points.isEmpty() && m_points.last() != point)
+            m_points.append(point);
+
+        if (m_points.size() >= 3)
+            commitPolygon(controller, m_points, pen);
+        m_points.clear();
+    }
+
+    void LassoStrategy::deactivate()
+    {
+        m_points.clear();
+    }
 }
\ No newline at end of file
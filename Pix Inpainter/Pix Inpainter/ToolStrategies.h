@@ -2,6 +2,8 @@
 
 #include "IToolStrategy.h"
 #include "PaintController.h"
+#include "StrokeSmoother.h"
+#include <QVector>
 #include <QPoint>
 #include <QPen>
 
@@ -20,8 +22,10 @@ namespace paint
         void onMousePress(PaintController* controller, const QPoint& point, const QPen& pen) override;
         void onMouseMove(PaintController* controller, const QPoint& point, const QPen& pen) override;
         void onMouseRelease(PaintController* controller, const QPoint& point, const QPen& pen) override;
+        void deactivate() override;
 
     private:
+        StrokeSmoother m_smoother;
         QPoint m_lastPoint;
         bool m_isDrawing = false;
     };
@@ -39,8 +43,10 @@ namespace paint
         void onMousePress(PaintController* controller, const QPoint& point, const QPen& pen) override;
         void onMouseMove(PaintController* controller, const QPoint& point, const QPen& pen) override;
         void onMouseRelease(PaintController* controller, const QPoint& point, const QPen& pen) override;
+        void deactivate() override;
 
     private:
+        StrokeSmoother m_smoother;
         QPoint m_lastPoint;
         bool m_isDrawing = false;
     };
@@ -154,4 +160,43 @@ namespace paint
         QPoint m_rightPoint;
     };
 
+    class PolygonStrategy : public IToolStrategy
+    {
+    public:
+        PolygonStrategy() = default;
+        ~PolygonStrategy() override = default;
+        PolygonStrategy(const PolygonStrategy&) = default;
+        PolygonStrategy& operator=(const PolygonStrategy&) = default;
+        PolygonStrategy(PolygonStrategy&&) = default;
+        PolygonStrategy& operator=(PolygonStrategy&&) = default;
+
+        void onMousePress(PaintController* controller, const QPoint& point, const QPen& pen) override;
+        void onMouseMove(PaintController* controller, const QPoint& point, const QPen& pen) override;
+        void onMouseRelease(PaintController* controller, const QPoint& point, const QPen& pen) override;
+        void deactivate() override;
+        void finish(PaintController* controller, const QPen& pen) override;
+
+    private:
+        QVector<QPoint> m_points;
+    };
+
+    class LassoStrategy : public IToolStrategy
+    {
+    public:
+        LassoStrategy() = default;
+        ~LassoStrategy() override = default;
+        LassoStrategy(const LassoStrategy&) = default;
+        LassoStrategy& operator=(const LassoStrategy&) = default;
+        LassoStrategy(LassoStrategy&&) = default;
+        LassoStrategy& operator=(LassoStrategy&&) = default;
+
+        void onMousePress(PaintController* controller, const QPoint& point, const QPen& pen) override;
+        void onMouseMove(PaintController* controller, const QPoint& point, const QPen& pen) override;
+        void onMouseRelease(PaintController* controller, const QPoint& point, const QPen& pen) override;
+        void deactivate() override;
+
+    private:
+        QVector<QPoint> m_points;
+    };
+
 }
\ No newline at end of file
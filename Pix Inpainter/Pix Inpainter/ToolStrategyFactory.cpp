@@ -1,30 +1,44 @@
 #include "ToolStrategyFactory.h"
 #include "ToolStrategies.h"
 
+#include <algorithm>
+
 namespace paint
 {
-    IToolStrategyUniquePtr ToolStrategyFactory::createStrategy(Tool toolType)
+    namespace
     {
-        switch (toolType)
+        template <typename Strategy>
+        IToolStrategyUniquePtr make()
         {
-        case Tool::Pen:
-            return std::make_unique<PenStrategy>();
-        case Tool::Eraser:
-            return std::make_unique<EraserStrategy>();
-        case Tool::Rectangle:
-            return std::make_unique<RectangleStrategy>();
-        case Tool::Ellipse:
-            return std::make_unique<EllipseStrategy>();
-        case Tool::Line:
-            return std::make_unique<LineStrategy>();
-        case Tool::Triangle:
-            return std::make_unique<TriangleStrategy>();
-        case Tool::Eyedropper:
-            return std::make_unique<EyedropperStrategy>();
-        case Tool::Fill:
-            return std::make_unique<FillStrategy>();
-        default:
-            return nullptr;
+            return std::make_unique<Strategy>();
         }
+
+        constexpr std::array STRATEGIES = {
+            ToolStrategyRegistry::Entry{ Tool::Pen, &make<PenStrategy> },
+            ToolStrategyRegistry::Entry{ Tool::Eraser, &make<EraserStrategy> },
+            ToolStrategyRegistry::Entry{ Tool::Rectangle, &make<RectangleStrategy> },
+            ToolStrategyRegistry::Entry{ Tool::Ellipse, &make<EllipseStrategy> },
+            ToolStrategyRegistry::Entry{ Tool::Line, &make<LineStrategy> },
+            ToolStrategyRegistry::Entry{ Tool::Triangle, &make<TriangleStrategy> },
+            ToolStrategyRegistry::Entry{ Tool::Polygon, &make<PolygonStrategy> },
+            ToolStrategyRegistry::Entry{ Tool::Lasso, &make<LassoStrategy> },
+            ToolStrategyRegistry::Entry{ Tool::Eyedropper, &make<EyedropperStrategy> },
+            ToolStrategyRegistry::Entry{ Tool::Fill, &make<FillStrategy> }
+        };
+
+        static_assert(ToolStrategyRegistry::isComplete(STRATEGIES), "Every tool needs exactly one strategy, listed in Tool order");
+    }
+
+    ToolStrategyRegistry ToolStrategyFactory::createRegistry()
+    {
+        return ToolStrategyRegistry(STRATEGIES);
+    }
+
+    IToolStrategyUniquePtr ToolStrategyFactory::createStrategy(Tool toolType)
+    {
+        auto entry = std::find_if(STRATEGIES.begin(), STRATEGIES.end(), [toolType](const auto& candidate) {
+            return candidate.tool == toolType;
+        });
+        return entry != STRATEGIES.end() ? entry->create() : nullptr;
     }
 }
\ No newline at end of file
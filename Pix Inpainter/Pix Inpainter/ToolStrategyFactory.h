@@ -1,15 +1,21 @@
 #pragma once
 
 #include "IToolStrategy.h"
+#include "ToolRegistry.h"
 #include "Enums.h"
 
 #include <memory>
 
 namespace paint
 {
+    using ToolStrategyRegistry = ToolRegistry<IToolStrategy>;
+
     class ToolStrategyFactory
     {
     public:
+        ToolStrategyFactory() = delete;
+
+        static ToolStrategyRegistry createRegistry();
         static IToolStrategyUniquePtr createStrategy(Tool toolType);
     };
 }
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <utility>
+
+namespace paint
+{
+    template <typename T>
+    class TripleBuffer
+    {
+    public:
+        TripleBuffer() = default;
+        ~TripleBuffer() = default;
+
+        TripleBuffer(const TripleBuffer&) = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+        TripleBuffer(TripleBuffer&&) = delete;
+        TripleBuffer& operator=(TripleBuffer&&) = delete;
+
+        void publish(T value)
+        {
+            m_slots[m_back] = std::move(value);
+            m_back = m_middle.exchange(m_back | DIRTY, std::memory_order_acq_rel) & INDEX_MASK;
+        }
+
+        bool acquire()
+        {
+            if (!(m_middle.load(std::memory_order_relaxed) & DIRTY))
+                return false;
+
+            m_front = m_middle.exchange(m_front, std::memory_order_acq_rel) & INDEX_MASK;
+            return true;
+        }
+
+        const T& front() const
+        {
+            return m_slots[m_front];
+        }
+
+    private:
+        static constexpr int INDEX_MASK = 3;
+        static constexpr int DIRTY = 4;
+
+        std::array<T, 3> m_slots{};
+        int m_front = 0;
+        int m_back = 1;
+        std::atomic<int> m_middle{ 2 };
+    };
+}
@@ -2,6 +2,14 @@
 
 namespace paint
 {
+    namespace
+    {
+        QRect spanBounds(const QPoint& a, const QPoint& b)
+        {
+            return QRect(QPoint(qMin(a.x(), b.x()), qMin(a.y(), b.y())), QPoint(qMax(a.x(), b.x()), qMax(a.y(), b.y())));
+        }
+    }
+
     void UiPenStrategy::onMousePress(PaintWidget* widget, QMouseEvent* event)
     {
         if (event->button() == Qt::LeftButton)
@@ -58,16 +66,22 @@ namespace paint
         int eraserSize = m_previousPenSize * PaintWidget::ERASER_SIZE_MULTIPLIER;
         int cursorSize = static_cast<int>(eraserSize * widget->getZoomLevel());
 
-        QPixmap pixmap(cursorSize + 2, cursorSize + 2);
-        pixmap.fill(Qt::transparent);
+        if (cursorSize != m_cursorSize)
+        {
+            QPixmap pixmap(cursorSize + 2, cursorSize + 2);
+            pixmap.fill(Qt::transparent);
+
+            QPainter painter(&pixmap);
+            painter.setPen(QPen(Qt::black, 1));
+            painter.setBrush(QBrush(QColor(255, 255, 255, 180)));
 
-        QPainter painter(&pixmap);
-        painter.setPen(QPen(Qt::black, 1));
-        painter.setBrush(QBrush(QColor(255, 255, 255, 180)));
+            painter.drawRect(1, 1, cursorSize, cursorSize);
 
-        painter.drawRect(1, 1, cursorSize, cursorSize);
+            m_cursor = QCursor(pixmap, cursorSize / 2 + 1, cursorSize / 2 + 1);
+            m_cursorSize = cursorSize;
+        }
 
-        widget->setCursor(QCursor(pixmap, cursorSize / 2 + 1, cursorSize / 2 + 1));
+        widget->setCursor(m_cursor);
     }
 
     void UiRectangleStrategy::onMousePress(PaintWidget* widget, QMouseEvent* event)
@@ -87,13 +101,13 @@ namespace paint
     void UiRectangleStrategy::onMouseMove(PaintWidget* widget, QMouseEvent* event)
     {
         m_endPoint = widget->toCanvasPos(event->pos());
-        widget->updateCanvas();
+        widget->updatePreview(spanBounds(m_startPoint, m_endPoint));
     }
 
     void UiRectangleStrategy::onMouseRelease(PaintWidget* widget, QMouseEvent* event)
     {
         m_startPoint = m_endPoint = QPoint();
-        widget->updateCanvas();
+        widget->updatePreview(QRect());
     }
 
     void UiRectangleStrategy::drawPreview(PaintWidget* widget, QPainter& painter)
@@ -126,13 +140,13 @@ namespace paint
     void UiEllipseStrategy::onMouseMove(PaintWidget* widget, QMouseEvent* event)
     {
         m_endPoint = widget->toCanvasPos(event->pos());
-        widget->updateCanvas();
+        widget->updatePreview(spanBounds(m_startPoint, m_endPoint));
     }
 
     void UiEllipseStrategy::onMouseRelease(PaintWidget* widget, QMouseEvent* event)
     {
         m_startPoint = m_endPoint = QPoint();
-        widget->updateCanvas();
+        widget->updatePreview(QRect());
     }
 
     void UiEllipseStrategy::drawPreview(PaintWidget* widget, QPainter& painter)
@@ -165,13 +179,13 @@ namespace paint
     void UiLineStrategy::onMouseMove(PaintWidget* widget, QMouseEvent* event)
     {
         m_endPoint = widget->toCanvasPos(event->pos());
-        widget->updateCanvas();
+        widget->updatePreview(spanBounds(m_startPoint, m_endPoint));
     }
 
     void UiLineStrategy::onMouseRelease(PaintWidget* widget, QMouseEvent* event)
     {
         m_startPoint = m_endPoint = QPoint();
-        widget->updateCanvas();
+        widget->updatePreview(QRect());
     }
 
     void UiLineStrategy::drawPreview(PaintWidget* widget, QPainter& painter)
@@ -191,10 +205,10 @@ namespace paint
     {
         QPoint pos = widget->toCanvasPos(event->pos());
 
-        const QImage& canvasImage = widget->getCanvasImage();
-        if (pos.x() >= 0 && pos.y() >= 0 && pos.x() < canvasImage.width() && pos.y() < canvasImage.height())
+        const QColor pickedColor = widget->getCanvasPixelColor(pos);
+        if (pickedColor.isValid())
         {
-            m_pickedColor = canvasImage.pixelColor(pos);
+            m_pickedColor = pickedColor;
         }
     }
 
@@ -213,7 +227,9 @@ namespace paint
 
     void UiEyedropperStrategy::updateCursor(PaintWidget* widget)
     {
-        widget->setCursor(QCursor(QIcon(":/icons/Eyedropper.png").pixmap(QSize(30, 30)), 0, 25));
+        if (!m_cursor)
+            m_cursor = QCursor(QIcon(":/icons/Eyedropper.png").pixmap(QSize(30, 30)), 0, 25);
+        widget->setCursor(*m_cursor);
     }
 
     void UiFillStrategy::onMousePress(PaintWidget* widget, QMouseEvent* event)
@@ -242,7 +258,9 @@ namespace paint
 
     void UiFillStrategy::updateCursor(PaintWidget* widget)
     {
-        widget->setCursor(QCursor(QIcon(":/icons/Fill.png").pixmap(QSize(40, 40)), 35, 30));
+        if (!m_cursor)
+            m_cursor = QCursor(QIcon(":/icons/Fill.png").pixmap(QSize(40, 40)), 35, 30);
+        widget->setCursor(*m_cursor);
     }
 
     void UiTriangleStrategy::onMousePress(PaintWidget* widget, QMouseEvent* event)
@@ -262,14 +280,14 @@ namespace paint
     void UiTriangleStrategy::onMouseMove(PaintWidget* widget, QMouseEvent* event)
     {
         m_endPoint = widget->toCanvasPos(event->pos());
-        widget->updateCanvas();
+        widget->updatePreview(spanBounds(m_startPoint, m_endPoint));
     }
 
     void UiTriangleStrategy::onMouseRelease(PaintWidget* widget, QMouseEvent* event)
     {
 
         m_startPoint = m_endPoint = QPoint();
-        widget->updateCanvas();
+        widget->updatePreview(QRect());
     }
 
     void UiTriangleStrategy::drawPreview(PaintWidget* widget, QPainter& painter)
@@ -280,10 +298,8 @@ namespace paint
             m_leftPoint = QPoint(m_startPoint.x(), m_endPoint.y());
             m_rightPoint = QPoint(m_endPoint.x(), m_endPoint.y());
 
-
-            painter.drawLine(m_topPoint, m_leftPoint);
-            painter.drawLine(m_leftPoint, m_rightPoint);
-            painter.drawLine(m_rightPoint, m_topPoint);
+            const QPoint triangle[3] = { m_topPoint, m_leftPoint, m_rightPoint };
+            painter.drawPolygon(triangle, 3);
         }
     }
 
@@ -291,4 +307,137 @@ namespace paint
     {
         widget->setCursor(QCursor(Qt::CrossCursor));
     }
+
+    void UiPolygonStrategy::onMousePress(PaintWidget* widget, QMouseEvent* event)
+    {
+        if (event->button() == Qt::LeftButton)
+        {
+            widget->usePenPrimaryColor();
+        }
+        else
+        {
+            widget->usePenSecondaryColor();
+        }
+
+        const QPoint point = widget->toCanvasPos(event->pos());
+        if (m_points.size() >= 3 && (point - m_points.first()).manhattanLength() <= PaintWidget::POLYGON_CLOSE_DISTANCE)
+        {
+            m_points.clear();
+        }
+        else
+        {
+            m_points.append(point);
+        }
+        widget->updatePreview(m_points.isEmpty() ? QRect() : QPolygon(m_points).boundingRect());
+    }
+
+    void UiPolygonStrategy::onMouseMove(PaintWidget* widget, QMouseEvent* event)
+    {
+        if (!m_points.isEmpty())
+        {
+            m_points.last() = widget->toCanvasPos(event->pos());
+            widget->updatePreview(QPolygon(m_points).boundingRect());
+        }
+    }
+
+    void UiPolygonStrategy::onMouseRelease(PaintWidget* widget, QMouseEvent* event)
+    {
+    }
+
+    void UiPolygonStrategy::drawPreview(PaintWidget* widget, QPainter& painter)
+    {
+        if (m_points.isEmpty())
+            return;
+
+        if (widget->getShapeStyle() == ShapeStyle::Filled && m_points.size() >= 3)
+        {
+            painter.drawPolygon(m_points.constData(), m_points.size(),
+                widget->getFillRule() == FillRule::NonZero ? Qt::WindingFill : Qt::OddEvenFill);
+        }
+        else
+        {
+            painter.drawPolyline(m_points.constData(), m_points.size());
+        }
+    }
+
+    void UiPolygonStrategy::updateCursor(PaintWidget* widget)
+    {
+        widget->setCursor(QCursor(Qt::CrossCursor));
+    }
+
+    void UiPolygonStrategy::deactivate(PaintWidget* widget)
+    {
+        m_points.clear();
+        widget->updatePreview(QRect());
+    }
+
+    bool UiPolygonStrategy::finish(PaintWidget* widget)
+    {
+        if (m_points.isEmpty())
+            return false;
+
+        m_points.clear();
+        widget->updatePreview(QRect());
+        return true;
+    }
+
+    void UiLassoStrategy::onMousePress(PaintWidget* widget, QMouseEvent* event)
+    {
+        if (event->button() == Qt::LeftButton)
+        {
+            widget->usePenPrimaryColor();
+        }
+        else
+        {
+            widget->usePenSecondaryColor();
+        }
+        m_points.clear();
+        m_points.append(widget->toCanvasPos(event->pos()));
+        m_bounds = QRect(m_points.last(), QSize(1, 1));
+    }
+
+    void UiLassoStrategy::onMouseMove(PaintWidget* widget, QMouseEvent* event)
+    {
+        const QPoint point = widget->toCanvasPos(event->pos());
+        if (!m_points.isEmpty() && m_points.last() != point)
+        {
+            m_points.append(point);
+            m_bounds = m_bounds.united(QRect(point, QSize(1, 1)));
+            widget->updatePreview(m_bounds);
+        }
+    }
+
+    void UiLassoStrategy::onMouseRelease(PaintWidget* widget, QMouseEvent* event)
+    {
+        m_points.clear();
+        m_bounds = QRect();
+        widget->updatePreview(QRect());
+    }
+
+    void UiLassoStrategy::drawPreview(PaintWidget* widget, QPainter& painter)
+    {
+        if (m_points.size() < 2)
+            return;
+
+        if (widget->getShapeStyle() == ShapeStyle::Filled)
+        {
+            painter.drawPolygon(m_points.constData(), m_points.size(),
+                widget->getFillRule() == FillRule::NonZero ? Qt::WindingFill : Qt::OddEvenFill);
+        }
+        else
+        {
+            painter.drawPolyline(m_points.constData(), m_points.size());
+        }
+    }
+
+    void UiLassoStrategy::updateCursor(PaintWidget* widget)
+    {
+        widget->setCursor(QCursor(Qt::CrossCursor));
+    }
+
+    void UiLassoStrategy::deactivate(PaintWidget* widget)
+    {
+        m_points.clear();
+        m_bounds = QRect();
+    }
 }
\ No newline at end of file
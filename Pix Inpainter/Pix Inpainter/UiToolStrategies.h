@@ -3,6 +3,10 @@
 #include "IUiToolStrategy.h"
 #include "PaintWidget.h"
 
+#include <QCursor>
+
+#include <optional>
+
 namespace paint
 {
     class UiPenStrategy : public IUiToolStrategy
@@ -39,7 +43,9 @@ namespace paint
         void updateCursor(PaintWidget* widget) override;
 
     private:
-        int m_previousPenSize;
+        int m_previousPenSize = 0;
+        int m_cursorSize = -1;
+        QCursor m_cursor;
     };
 
     class UiRectangleStrategy : public IUiToolStrategy {
@@ -119,6 +125,7 @@ namespace paint
 
     private:
         QColor m_pickedColor;
+        std::optional<QCursor> m_cursor;
     };
 
     class UiFillStrategy : public IUiToolStrategy {
@@ -135,6 +142,9 @@ namespace paint
         void onMouseRelease(PaintWidget* widget, QMouseEvent* event) override;
         void drawPreview(PaintWidget* widget, QPainter& painter) override;
         void updateCursor(PaintWidget* widget) override;
+
+    private:
+        std::optional<QCursor> m_cursor;
     };
 
     class UiTriangleStrategy : public IUiToolStrategy {
@@ -159,4 +169,46 @@ namespace paint
         QPoint m_leftPoint;
         QPoint m_rightPoint;
     };
+
+    class UiPolygonStrategy : public IUiToolStrategy {
+    public:
+        UiPolygonStrategy() = default;
+        ~UiPolygonStrategy() override = default;
+        UiPolygonStrategy(const UiPolygonStrategy&) = default;
+        UiPolygonStrategy& operator=(const UiPolygonStrategy&) = default;
+        UiPolygonStrategy(UiPolygonStrategy&&) = default;
+        UiPolygonStrategy& operator=(UiPolygonStrategy&&) = default;
+
+        void onMousePress(PaintWidget* widget, QMouseEvent* event) override;
+        void onMouseMove(PaintWidget* widget, QMouseEvent* event) override;
+        void onMouseRelease(PaintWidget* widget, QMouseEvent* event) override;
+        void drawPreview(PaintWidget* widget, QPainter& painter) override;
+        void updateCursor(PaintWidget* widget) override;
+        void deactivate(PaintWidget* widget) override;
+        bool finish(PaintWidget* widget) override;
+
+    private:
+        QVector<QPoint> m_points;
+    };
+
+    class UiLassoStrategy : public IUiToolStrategy {
+    public:
+        UiLassoStrategy() = default;
+        ~UiLassoStrategy() override = default;
+        UiLassoStrategy(const UiLassoStrategy&) = default;
+        UiLassoStrategy& operator=(const UiLassoStrategy&) = default;
+        UiLassoStrategy(UiLassoStrategy&&) = default;
+        UiLassoStrategy& operator=(UiLassoStrategy&&) = default;
+
+        void onMousePress(PaintWidget* widget, QMouseEvent* event) override;
+        void onMouseMove(PaintWidget* widget, QMouseEvent* event) override;
+        void onMouseRelease(PaintWidget* widget, QMouseEvent* event) override;
+        void drawPreview(PaintWidget* widget, QPainter& painter) override;
+        void updateCursor(PaintWidget* widget) override;
+        void deactivate(PaintWidget* widget) override;
+
+    private:
+        QVector<QPoint> m_points;
+        QRect m_bounds;
+    };
 }
\ No newline at end of file
@@ -1,30 +1,44 @@
 #include "UiToolStrategyFactory.h"
 #include "UiToolStrategies.h"
 
+#include <algorithm>
+
 namespace paint
 {
-    std::unique_ptr<IUiToolStrategy> UiToolStrategyFactory::createStrategy(Tool toolType)
+    namespace
     {
-        switch (toolType)
+        template <typename Strategy>
+        IUiToolStrategyUniquePtr make()
         {
-        case Tool::Pen:
-            return std::make_unique<UiPenStrategy>();
-        case Tool::Eraser:
-            return std::make_unique<UiEraserStrategy>();
-        case Tool::Rectangle:
-            return std::make_unique<UiRectangleStrategy>();
-        case Tool::Ellipse:
-            return std::make_unique<UiEllipseStrategy>();
-        case Tool::Line:
-            return std::make_unique<UiLineStrategy>();
-        case Tool::Triangle:
-            return std::make_unique<UiTriangleStrategy>();
-        case Tool::Eyedropper:
-            return std::make_unique<UiEyedropperStrategy>();
-        case Tool::Fill:
-            return std::make_unique<UiFillStrategy>();
-        default:
-            return nullptr;
+            return std::make_unique<Strategy>();
         }
+
+        constexpr std::array STRATEGIES = {
+            UiToolStrategyRegistry::Entry{ Tool::Pen, &make<UiPenStrategy> },
+            UiToolStrategyRegistry::Entry{ Tool::Eraser, &make<UiEraserStrategy> },
+            UiToolStrategyRegistry::Entry{ Tool::Rectangle, &make<UiRectangleStrategy> },
+            UiToolStrategyRegistry::Entry{ Tool::Ellipse, &make<UiEllipseStrategy> },
+            UiToolStrategyRegistry::Entry{ Tool::Line, &make<UiLineStrategy> },
+            UiToolStrategyRegistry::Entry{ Tool::Triangle, &make<UiTriangleStrategy> },
+            UiToolStrategyRegistry::Entry{ Tool::Polygon, &make<UiPolygonStrategy> },
+            UiToolStrategyRegistry::Entry{ Tool::Lasso, &make<UiLassoStrategy> },
+            UiToolStrategyRegistry::Entry{ Tool::Eyedropper, &make<UiEyedropperStrategy> },
+            UiToolStrategyRegistry::Entry{ Tool::Fill, &make<UiFillStrategy> }
+        };
+
+        static_assert(UiToolStrategyRegistry::isComplete(STRATEGIES), "Every tool needs exactly one strategy, listed in Tool order");
+    }
+
+    UiToolStrategyRegistry UiToolStrategyFactory::createRegistry()
+    {
+        return UiToolStrategyRegistry(STRATEGIES);
+    }
+
+    IUiToolStrategyUniquePtr UiToolStrategyFactory::createStrategy(Tool toolType)
+    {
+        auto entry = std::find_if(STRATEGIES.begin(), STRATEGIES.end(), [toolType](const auto& candidate) {
+            return candidate.tool == toolType;
+        });
+        return entry != STRATEGIES.end() ? entry->create() : nullptr;
     }
 }
\ No newline at end of file
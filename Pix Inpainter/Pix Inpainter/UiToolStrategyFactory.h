@@ -1,15 +1,21 @@
 #pragma once
 
 #include "IUiToolStrategy.h"
+#include "ToolRegistry.h"
 #include "Enums.h"
 
 #include <memory>
 
 namespace paint
 {
+    using UiToolStrategyRegistry = ToolRegistry<IUiToolStrategy>;
+
     class UiToolStrategyFactory
     {
     public:
+        UiToolStrategyFactory() = delete;
+
+        static UiToolStrategyRegistry createRegistry();
         static IUiToolStrategyUniquePtr createStrategy(Tool toolType);
     };
 }
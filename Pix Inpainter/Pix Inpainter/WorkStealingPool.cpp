@@ -0,0 +1,227 @@
+#include "WorkStealingPool.h"
+
+#include <algorithm>
+
+namespace paint
+{
+    namespace
+    {
+        thread_local const WorkStealingPool* t_currentPool = nullptr;
+        thread_local int t_currentWorker = -1;
+
+        size_t queueIndex(TaskPriority priority)
+        {
+            return priority == TaskPriority::Interactive ? 0 : 1;
+        }
+
+        qint64 elapsedNs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to)
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+        }
+    }
+
+    WorkStealingPoolPtr WorkStealingPool::create(int threadCount)
+    {
+        if (threadCount <= 0)
+            threadCount = std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1);
+        return std::make_shared<WorkStealingPool>(threadCount);
+    }
+
+    WorkStealingPool::WorkStealingPool(int threadCount)
+    {
+        threadCount = std::max(threadCount, 1);
+        m_workers.reserve(threadCount);
+        for (int i = 0; i < threadCount; ++i)
+            m_workers.push_back(std::make_unique<Worker>());
+
+        m_threads.reserve(threadCount);
+        for (int i = 0; i < threadCount; ++i)
+            m_threads.emplace_back([this, i]() { run(i); });
+    }
+
+    WorkStealingPool::~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_idleMutex);
+            m_stopping = true;
+        }
+        m_idleCondition.notify_all();
+
+        for (std::thread& thread : m_threads)
+            thread.join();
+    }
+
+    void WorkStealingPool::submit(const QString& label, TaskPriority priority, Task task)
+    {
+        if (!task)
+            return;
+
+        const int target = t_currentPool == this
+            ? t_currentWorker
+            : static_cast<int>(m_nextWorker.fetch_add(1, std::memory_order_relaxed) % m_workers.size());
+
+        {
+            Worker& worker = *m_workers[target];
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.queues[queueIndex(priority)].push_back({ label, std::move(task), Clock::now() });
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_idleMutex);
+            m_queuedTasks.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_idleCondition.notify_one();
+    }
+
+    void WorkStealingPool::parallelFor(const QString& label, int count, const std::function<void(int)>& body, TaskPriority priority)
+    {
+        if (count <= 0)
+            return;
+
+        if (count == 1)
+        {
+            body(0);
+            return;
+        }
+
+        // Helpers register in the low bits of `members` before touching `body`; the
+        // caller sets CLOSED once it has drained the range so late helpers back out.
+        constexpr unsigned CLOSED = 1u << 31;
+        struct State
+        {
+            std::atomic<int> next{ 0 };
+            std::atomic<unsigned> members{ 0 };
+        };
+        auto state = std::make_shared<State>();
+
+        auto drain = [&body, count](State& shared) {
+            for (int index = shared.next.fetch_add(1); index < count; index = shared.next.fetch_add(1))
+                body(index);
+        };
+
+        const int helpers = std::min(count - 1, threadCount());
+        for (int i = 0; i < helpers; ++i)
+        {
+            submit(label, priority, [state, &drain]() {
+                unsigned members = state->members.load();
+                do
+                {
+                    if (members & CLOSED)
+                        return;
+                } while (!state->members.compare_exchange_weak(members, members + 1));
+
+                drain(*state);
+                if (state->members.fetch_sub(1) == (CLOSED | 1u))
+                    state->members.notify_all();
+            });
+        }
+
+        drain(*state);
+
+        unsigned members = state->members.fetch_or(CLOSED) | CLOSED;
+        while (members != CLOSED)
+        {
+            state->members.wait(members);
+            members = state->members.load();
+        }
+    }
+
+    int WorkStealingPool::threadCount() const
+    {
+        return static_cast<int>(m_threads.size());
+    }
+
+    QHash<QString, TaskCounters> WorkStealingPool::counters() const
+    {
+        std::lock_guard<std::mutex> lock(m_countersMutex);
+        return m_counters;
+    }
+
+    void WorkStealingPool::resetCounters()
+    {
+        std::lock_guard<std::mutex> lock(m_countersMutex);
+        m_counters.clear();
+    }
+
+    void WorkStealingPool::run(int index)
+    {
+        t_currentPool = this;
+        t_currentWorker = index;
+
+        while (true)
+        {
+            QueuedTask task;
+            if (takeTask(index, task))
+            {
+                execute(task);
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_idleMutex);
+            m_idleCondition.wait(lock, [this]() {
+                return m_stopping || m_queuedTasks.load(std::memory_order_relaxed) > 0;
+            });
+            if (m_stopping)
+                return;
+        }
+    }
+
+    bool WorkStealingPool::takeTask(int index, QueuedTask& task)
+    {
+        for (TaskPriority priority : { TaskPriority::Interactive, TaskPriority::Background })
+        {
+            if (popLocal(index, priority, task) || steal(index, priority, task))
+            {
+                m_queuedTasks.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool WorkStealingPool::popLocal(int index, TaskPriority priority, QueuedTask& task)
+    {
+        Worker& worker = *m_workers[index];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        std::deque<QueuedTask>& queue = worker.queues[queueIndex(priority)];
+        if (queue.empty())
+            return false;
+
+        task = std::move(queue.back());
+        queue.pop_back();
+        return true;
+    }
+
+    bool WorkStealingPool::steal(int thief, TaskPriority priority, QueuedTask& task)
+    {
+        const int workerCount = static_cast<int>(m_workers.size());
+        for (int offset = 1; offset < workerCount; ++offset)
+        {
+            Worker& victim = *m_workers[(thief + offset) % workerCount];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            std::deque<QueuedTask>& queue = victim.queues[queueIndex(priority)];
+            if (queue.empty())
+                continue;
+
+            task = std::move(queue.front());
+            queue.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void WorkStealingPool::execute(QueuedTask& task)
+    {
+        const Clock::time_point started = Clock::now();
+        task.task();
+        const Clock::time_point finished = Clock::now();
+
+        const qint64 runNs = elapsedNs(started, finished);
+        std::lock_guard<std::mutex> lock(m_countersMutex);
+        TaskCounters& counters = m_counters[task.label];
+        ++counters.count;
+        counters.totalQueuedNs += elapsedNs(task.queuedAt, started);
+        counters.totalRunNs += runNs;
+        counters.maxRunNs = std::max(counters.maxRunNs, runNs);
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "Enums.h"
+
+#include <QHash>
+#include <QString>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace paint
+{
+    struct TaskCounters
+    {
+        quint64 count = 0;
+        qint64 totalQueuedNs = 0;
+        qint64 totalRunNs = 0;
+        qint64 maxRunNs = 0;
+    };
+
+    class WorkStealingPool;
+    using WorkStealingPoolPtr = std::shared_ptr<WorkStealingPool>;
+
+    class WorkStealingPool
+    {
+    public:
+        using Task = std::function<void()>;
+
+    public:
+        explicit WorkStealingPool(int threadCount);
+        ~WorkStealingPool();
+
+        WorkStealingPool(const WorkStealingPool&) = delete;
+        WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+        WorkStealingPool(WorkStealingPool&&) = delete;
+        WorkStealingPool& operator=(WorkStealingPool&&) = delete;
+
+        void submit(const QString& label, TaskPriority priority, Task task);
+        void parallelFor(const QString& label, int count, const std::function<void(int)>& body,
+            TaskPriority priority = TaskPriority::Interactive);
+
+        int threadCount() const;
+        QHash<QString, TaskCounters> counters() const;
+        void resetCounters();
+
+        static WorkStealingPoolPtr create(int threadCount = 0);
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct QueuedTask
+        {
+            QString label;
+            Task task;
+            Clock::time_point queuedAt;
+        };
+
+        struct Worker
+        {
+            std::mutex mutex;
+            std::deque<QueuedTask> queues[2];
+        };
+
+        void run(int index);
+        bool takeTask(int index, QueuedTask& task);
+        bool popLocal(int index, TaskPriority priority, QueuedTask& task);
+        bool steal(int thief, TaskPriority priority, QueuedTask& task);
+        void execute(QueuedTask& task);
+
+        std::vector<std::unique_ptr<Worker>> m_workers;
+        std::vector<std::thread> m_threads;
+        std::atomic<unsigned> m_nextWorker{ 0 };
+
+        std::mutex m_idleMutex;
+        std::condition_variable m_idleCondition;
+        std::atomic<int> m_queuedTasks{ 0 };
+        bool m_stopping = false;
+
+        mutable std::mutex m_countersMutex;
+        QHash<QString, TaskCounters> m_counters;
+    };
+}
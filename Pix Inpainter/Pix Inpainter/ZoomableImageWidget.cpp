@@ -9,6 +9,8 @@ namespace paint
         , m_zoomFactor(BASE_ZOOM)
         , m_viewCenterOnOriginal(0.5, 0.5)
         , m_isPanning(false)
+        , m_selectionEnabled(false)
+        , m_isSelecting(false)
     {
         setMouseTracking(true);
         setFocusPolicy(Qt::StrongFocus);
@@ -31,6 +33,14 @@ namespace paint
         {
             m_viewCenterOnOriginal = QPointF(0.0, 0.0);
         }
+
+        const QRect selection = m_selection.intersected(m_originalPixmap.rect());
+        if (selection != m_selection)
+        {
+            m_selection = selection;
+            emit selectionChanged(m_selection);
+        }
+
         limitViewCenter();
         update();
     }
@@ -40,6 +50,31 @@ namespace paint
         return m_originalPixmap;
     }
 
+    void ZoomableImageWidget::setSelectionEnabled(bool enabled)
+    {
+        m_selectionEnabled = enabled;
+        m_isSelecting = false;
+        setCursor(enabled ? Qt::CrossCursor : Qt::OpenHandCursor);
+
+        if (!enabled && !m_selection.isNull())
+        {
+            m_selection = QRect();
+            emit selectionChanged(m_selection);
+        }
+        update();
+    }
+
+    QRect ZoomableImageWidget::selection() const
+    {
+        return m_selection;
+    }
+
+    QRect ZoomableImageWidget::selectionFrom(const QPointF& widgetPos) const
+    {
+        return QRectF(m_selectionAnchor, mapWidgetToOriginalImage(widgetPos)).normalized().toAlignedRect()
+            .intersected(m_originalPixmap.rect());
+    }
+
     QSize ZoomableImageWidget::sizeHint() const
     {
         if (!m_originalPixmap.isNull()) 
@@ -178,6 +213,15 @@ namespace paint
         QRectF targetRect = rect();
 
         painter.drawPixmap(targetRect, m_originalPixmap, sourceRect);
+
+        if (!m_selection.isEmpty())
+        {
+            const QRectF selectionRect(mapOriginalImageToWidget(m_selection.topLeft()),
+                mapOriginalImageToWidget(m_selection.topLeft() + QPoint(m_selection.width(), m_selection.height())));
+            painter.setPen(QPen(palette().color(QPalette::Highlight), 1, Qt::DashLine));
+            painter.setBrush(Qt::NoBrush);
+            painter.drawRect(selectionRect);
+        }
     }
 
     void ZoomableImageWidget::wheelEvent(QWheelEvent* event)
@@ -246,7 +290,15 @@ namespace paint
 
     void ZoomableImageWidget::mousePressEvent(QMouseEvent* event)
     {
-        if (event->button() == Qt::LeftButton && !m_originalPixmap.isNull()) 
+        if (m_selectionEnabled && event->button() == Qt::LeftButton && !m_originalPixmap.isNull())
+        {
+            m_isSelecting = true;
+            m_selectionAnchor = mapWidgetToOriginalImage(event->position());
+            m_selection = QRect();
+            update();
+            event->accept();
+        }
+        else if ((event->button() == Qt::LeftButton || event->button() == Qt::MiddleButton) && !m_originalPixmap.isNull()) 
         {
             m_isPanning = true;
             m_lastPanMousePos = event->pos();
@@ -261,7 +313,13 @@ namespace paint
 
     void ZoomableImageWidget::mouseMoveEvent(QMouseEvent* event)
     {
-        if (m_isPanning && (event->buttons() & Qt::LeftButton))
+        if (m_isSelecting && (event->buttons() & Qt::LeftButton))
+        {
+            m_selection = selectionFrom(event->position());
+            update();
+            event->accept();
+        }
+        else if (m_isPanning && (event->buttons() & (Qt::LeftButton | Qt::MiddleButton)))
         {
             QPoint deltaWidget = event->pos() - m_lastPanMousePos;
             QPointF deltaOriginal = QPointF(deltaWidget.x(), deltaWidget.y()) / m_zoomFactor;
@@ -279,10 +337,18 @@ namespace paint
 
     void ZoomableImageWidget::mouseReleaseEvent(QMouseEvent* event)
     {
-        if (event->button() == Qt::LeftButton && m_isPanning) 
+        if (event->button() == Qt::LeftButton && m_isSelecting)
+        {
+            m_isSelecting = false;
+            m_selection = selectionFrom(event->position());
+            update();
+            emit selectionChanged(m_selection);
+            event->accept();
+        }
+        else if ((event->button() == Qt::LeftButton || event->button() == Qt::MiddleButton) && m_isPanning) 
         {
             m_isPanning = false;
-            setCursor(Qt::OpenHandCursor);
+            setCursor(m_selectionEnabled ? Qt::CrossCursor : Qt::OpenHandCursor);
             event->accept();
         } 
         else 
@@ -34,6 +34,9 @@ namespace paint
         void setPixmap(const QPixmap& pixmap);
         QPixmap pixmap() const;
 
+        void setSelectionEnabled(bool enabled);
+        QRect selection() const;
+
         QSize sizeHint() const override;
 
     public slots:
@@ -43,6 +46,7 @@ namespace paint
 
     signals:
         void zoomChanged(qreal zoomLevel);
+        void selectionChanged(const QRect& selection);
 
     protected:
         void paintEvent(QPaintEvent* event) override;
@@ -59,6 +63,7 @@ namespace paint
         void adjustView(const QPointF& newViewCenterOnOriginal);
         void centerOn(const QPointF& originalImagePoint);
         void limitViewCenter();
+        QRect selectionFrom(const QPointF& widgetPos) const;
 
         QPixmap m_originalPixmap;
         qreal m_zoomFactor;
@@ -66,5 +71,10 @@ namespace paint
         
         bool m_isPanning;
         QPoint m_lastPanMousePos;
+
+        bool m_selectionEnabled;
+        bool m_isSelecting;
+        QPointF m_selectionAnchor;
+        QRect m_selection;
     };
 }
\ No newline at end of file
@@ -22,15 +22,18 @@ def load_model(model, model_path, device):
     return model
 
 
+INPUT_SIZE = (256, 256)
+
+
 def initialize_models(device):
 
     transform_01 = transforms.Compose([
-        transforms.Resize((256, 256)),
+        transforms.Resize(INPUT_SIZE),
         transforms.ToTensor()
     ])
 
     transform_11 = transforms.Compose([
-        transforms.Resize((256, 256)),
+        transforms.Resize(INPUT_SIZE),
         transforms.ToTensor(),
         transforms.Normalize(mean=[0.5], std=[0.5])
     ])
@@ -40,25 +43,29 @@ def initialize_models(device):
             "model": load_model(Generator(1, 1, MappedTanh()),
                                 "trained_models/sketchgan01/generator.pth",
                                 device),
-            "transform": transform_01
+            "transform": transform_01,
+            "input_size": INPUT_SIZE
         },
         "sketchgan_11": {
             "model": load_model(Generator(1, 1, torch.nn.Tanh()),
                                 "trained_models/sketchgan_11/generator.pth",
                                 device),
-            "transform": transform_11
+            "transform": transform_11,
+            "input_size": INPUT_SIZE
         },
         "wgan01": {
             "model": load_model(Generator(1, 1, MappedTanh()),
                                 "trained_models/wgan01/generator.pth",
                                 device),
-            "transform": transform_01
+            "transform": transform_01,
+            "input_size": INPUT_SIZE
         },
         "wgan_11": {
             "model": load_model(Generator(1, 1, torch.nn.Tanh()),
                                 "trained_models/wgan_11/generator.pth",
                                 device),
-            "transform": transform_11
+            "transform": transform_11,
+            "input_size": INPUT_SIZE
         }
     }
 
@@ -1,5 +1,7 @@
-from flask import Flask, request, Response
+from flask import Flask, request, Response, stream_with_context
 from io import BytesIO
+import json
+import struct
 from PIL import Image
 
 import torch
@@ -14,17 +16,51 @@ transform_to_pil = transforms.ToPILImage()
 
 models = initialize_models(device)
 
-def handle_request(model_key: str, postprocess_value: int, image_bytes: bytes):
-    print(f"[INFO] Requested model: {model_key}, Postprocess: {postprocess_value}")
+RAW_GRAY_MIME = "application/x-pix-gray"
+RAW_GRAY_MAGIC = b"PXG1"
+RAW_GRAY_HEADER = struct.Struct(">4sHH")
+
+
+class RequestError(ValueError):
+    pass
+
+
+def is_raw_request():
+    return request.mimetype == RAW_GRAY_MIME
+
+
+def decode_image(image_bytes: bytes, raw: bool = False):
+    if raw:
+        if len(image_bytes) < RAW_GRAY_HEADER.size:
+            raise RequestError("Raw grayscale payload is truncated.")
+        magic, width, height = RAW_GRAY_HEADER.unpack_from(image_bytes)
+        if magic != RAW_GRAY_MAGIC:
+            raise RequestError("Invalid raw grayscale payload.")
+        pixels = image_bytes[RAW_GRAY_HEADER.size:]
+        if width == 0 or height == 0 or len(pixels) != width * height:
+            raise RequestError(f"Raw grayscale payload has {len(pixels)} bytes, expected {width * height}.")
+        return Image.frombytes("L", (width, height), pixels)
+
+    try:
+        return Image.open(BytesIO(image_bytes)).convert("L")
+    except OSError as e:
+        raise RequestError(f"Invalid image payload: {e}")
 
-    image_data = BytesIO(image_bytes)
-    original_image = Image.open(image_data).convert("L")
-    original_size = original_image.size
 
+def find_model(model_key: str):
     model = models.get(model_key)
     if model is None:
-        raise ValueError(f"Model key '{model_key}' not found.")
+        raise RequestError(f"Model key '{model_key}' not found.")
+    return model
+
+
+def iterate_model(model_key: str, postprocess_value: int, original_image):
+    # Resolve the model before handing back the generator so a bad key fails the request
+    # up front instead of surfacing mid-stream.
+    return _iterate_model(find_model(model_key), postprocess_value, original_image)
 
+
+def _iterate_model(model, postprocess_value: int, original_image):
     gen = model["model"]
     transform = model["transform"]
 
@@ -37,22 +73,58 @@ def handle_request(model_key: str, postprocess_value: int, image_bytes: bytes):
             for i in range (postprocess_value):
                 image = gen(image)
                 image = apply_postprocess(image.squeeze(0).cpu()).unsqueeze(0).to(device)
+                yield i + 1, image, was_normalized
         else:
-            image = gen(image)
+            yield 0, gen(image), was_normalized
+
 
+def encode_output(image, was_normalized, original_size, raw: bool = False):
     image = image.squeeze(0).cpu()
 
     if was_normalized:
         image = (image + 1) / 2
 
     output_image = transform_to_pil(image)
+
+    if raw:
+        output_image = output_image.convert("L")
+        return RAW_GRAY_HEADER.pack(RAW_GRAY_MAGIC, *output_image.size) + output_image.tobytes()
+
     output_image = output_image.resize(original_size)
 
     output = BytesIO()
     output_image.save(output, format="PNG")
-    output.seek(0)
+    return output.getvalue()
+
+
+def run_model(model_key: str, postprocess_value: int, original_image, raw: bool = False):
+    for _, image, was_normalized in iterate_model(model_key, postprocess_value, original_image):
+        pass
+    return encode_output(image, was_normalized, original_image.size, raw)
 
-    return Response(output.getvalue(), mimetype='image/png')
+
+def handle_request(model_key: str, postprocess_value: int, image_bytes: bytes):
+    print(f"[INFO] Requested model: {model_key}, Postprocess: {postprocess_value}")
+
+    raw = is_raw_request()
+    output_bytes = run_model(model_key, postprocess_value, decode_image(image_bytes, raw), raw)
+    return Response(output_bytes, mimetype=RAW_GRAY_MIME if raw else 'image/png')
+
+
+def parse_model_list(values):
+    requested = []
+    for value in values:
+        model_key, _, postprocess = value.rpartition(":")
+        if not model_key:
+            model_key, postprocess = postprocess, "0"
+        requested.append((model_key, max(int(postprocess or 0), 0)))
+    return requested
+
+
+def comparison_frame(header: dict, payload: bytes = b""):
+    header_bytes = json.dumps(header).encode("utf-8")
+    return (struct.pack(">I", len(header_bytes)) + header_bytes
+            + struct.pack(">I", len(payload)) + payload)
 
 
 @app.route('/process', methods=['POST'])
@@ -61,6 +133,8 @@ def process_image():
         model_key = request.args.get("model_id")
         postprocess_value = int(request.args.get("postprocess_value", 0))
         return handle_request(model_key, postprocess_value, request.data)
+    except RequestError as e:
+        return f"Error: {str(e)}", 400
     except Exception as e:
         import traceback
         traceback.print_exc()
@@ -73,16 +147,74 @@ def compare_image():
         model_key = request.args.get("model_id")
         postprocess_value = int(request.args.get("postprocess_value", 0))
         return handle_request(model_key, postprocess_value, request.data)
+    except RequestError as e:
+        return f"Error: {str(e)}", 400
     except Exception as e:
         import traceback
         traceback.print_exc()
         return f"Error: {str(e)}", 500
 
+@app.route('/compare_batch', methods=['POST'])
+def compare_batch():
+    try:
+        requested = parse_model_list(request.args.getlist("model"))
+        raw = is_raw_request()
+        original_image = decode_image(request.data, raw)
+    except Exception as e:
+        import traceback
+        traceback.print_exc()
+        return f"Error: {str(e)}", 400
+
+    def generate():
+        for model_key, postprocess_value in requested:
+            print(f"[INFO] Batch model: {model_key}, Postprocess: {postprocess_value}")
+            header = {"model_id": model_key, "postprocess_value": postprocess_value}
+            try:
+                output_bytes = run_model(model_key, postprocess_value, original_image, raw)
+                yield comparison_frame({**header, "ok": True}, output_bytes)
+            except Exception as e:
+                import traceback
+                traceback.print_exc()
+                yield comparison_frame({**header, "ok": False, "error": str(e)})
+
+    return Response(stream_with_context(generate()), mimetype='application/octet-stream')
+
+@app.route('/process_sweep', methods=['POST'])
+def process_sweep():
+    try:
+        model_key = request.args.get("model_id")
+        postprocess_value = max(int(request.args.get("postprocess_value", 1)), 1)
+        raw = is_raw_request()
+        original_image = decode_image(request.data, raw)
+        iterations = iterate_model(model_key, postprocess_value, original_image)
+    except Exception as e:
+        import traceback
+        traceback.print_exc()
+        return f"Error: {str(e)}", 400
+
+    def generate():
+        print(f"[INFO] Sweep model: {model_key}, Iterations: {postprocess_value}")
+        header = {"model_id": model_key}
+        try:
+            for iteration, image, was_normalized in iterations:
+                output_bytes = encode_output(image, was_normalized, original_image.size, raw)
+                yield comparison_frame({**header, "postprocess_value": iteration, "ok": True}, output_bytes)
+        except Exception as e:
+            import traceback
+            traceback.print_exc()
+            yield comparison_frame({**header, "postprocess_value": 0, "ok": False, "error": str(e)})
+
+    return Response(stream_with_context(generate()), mimetype='application/octet-stream')
+
 @app.route('/models', methods=['GET'])
 def list_models():
     try:
         model_keys = list(models.keys())
-        return {"available_models": model_keys}, 200
+        geometry = {
+            key: {"input_width": model["input_size"][0], "input_height": model["input_size"][1], "channels": 1}
+            for key, model in models.items()
+        }
+        return {"available_models": model_keys, "models": geometry, "formats": ["image/png", RAW_GRAY_MIME]}, 200
     except Exception as e:
         import traceback
         traceback.print_exc()
@@ -90,4 +222,4 @@ def list_models():
 
 
 if __name__ == '__main__':
-    app.run(host="0.0.0.0", port=5000, debug=False)
\ No newline at end of file
+    app.run(host="0.0.0.0", port=5000, debug=False, threaded=True)
\ No newline at end of file